@@ -0,0 +1,116 @@
+import os
+import sys
+import json
+import time
+import argparse
+import subprocess
+
+# Prefix of the line a measurement process reports its result with
+RESULT_PREFIX = "FORGEML_SCALING "
+
+def measure(workers, threads, samples, features, batch_size, epochs):
+    """Trains a dense model on synthetic data with the data parallel strategy and reports the throughput.
+
+    Runs in its own process, the logical devices of a strategy can only be configured once per process."""
+    import numpy as np
+    import tensorflow as tf
+    from train_model_from_json import configure_distribution
+
+    train_config = {
+        "distribution": "mirrored",
+        "num_workers": workers,
+        "threads_per_worker": threads
+    }
+    strategy = configure_distribution(train_config)
+
+    rng = np.random.default_rng(0)
+    x = rng.standard_normal((samples, features), dtype=np.float32)
+    y = (x.sum(axis=1, keepdims=True) > 0).astype(np.float32)
+
+    with strategy.scope():
+        model = tf.keras.Sequential([
+            tf.keras.layers.Input(shape=(features,)),
+            tf.keras.layers.Dense(256, activation="relu"),
+            tf.keras.layers.Dense(256, activation="relu"),
+            tf.keras.layers.Dense(1, activation="sigmoid")
+        ])
+        model.compile(optimizer="adam", loss="binary_crossentropy")
+
+    global_batch = batch_size * strategy.num_replicas_in_sync
+
+    # The first epoch traces the graph and is not measured
+    model.fit(x, y, batch_size=global_batch, epochs=1, verbose=0)
+
+    start = time.perf_counter()
+    model.fit(x, y, batch_size=global_batch, epochs=epochs, verbose=0)
+    elapsed = time.perf_counter() - start
+
+    print(RESULT_PREFIX + json.dumps({
+        "workers": workers,
+        "threads_per_worker": threads,
+        "global_batch_size": global_batch,
+        "samples_per_sec": samples * epochs / elapsed
+    }), flush=True)
+
+def run_measurement(args, workers):
+    """Runs a single measurement in a new process and returns its result, None if it failed."""
+    cmd = [
+        sys.executable, "-u", os.path.abspath(__file__), "--measure",
+        "--workers", str(workers),
+        "--threads", str(args.threads),
+        "--samples", str(args.samples),
+        "--features", str(args.features),
+        "--batch_size", str(args.batch_size),
+        "--epochs", str(args.epochs)
+    ]
+    result = subprocess.run(cmd, capture_output=True, text=True, cwd=os.path.dirname(os.path.abspath(__file__)))
+
+    for line in result.stdout.splitlines():
+        if line.startswith(RESULT_PREFIX):
+            return json.loads(line[len(RESULT_PREFIX):])
+
+    print(f"Measurement With {workers} Workers Failed:\n{result.stderr}")
+    return None
+
+def report(args):
+    worker_counts = [int(count) for count in args.workers.split(",")]
+
+    results = []
+    for workers in worker_counts:
+        result = run_measurement(args, workers)
+        if result is not None:
+            results.append(result)
+
+    if not results:
+        sys.exit(-1)
+
+    baseline = results[0]["samples_per_sec"]
+    for result in results:
+        result["speedup"] = result["samples_per_sec"] / baseline
+        result["efficiency"] = result["speedup"] * results[0]["workers"] / result["workers"]
+
+    print(f"{'Workers':>8} {'Threads':>8} {'Batch':>8} {'Samples/s':>12} {'Speedup':>8} {'Efficiency':>10}")
+    for result in results:
+        print(f"{result['workers']:>8} {result['threads_per_worker']:>8} {result['global_batch_size']:>8} "
+              f"{result['samples_per_sec']:>12.0f} {result['speedup']:>7.2f}x {result['efficiency']:>9.0%}")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=4)
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Reports the training throughput of data parallel training against the worker count.")
+    parser.add_argument("--workers", type=str, default="1,2,4,8", help="Comma separated worker counts to measure")
+    parser.add_argument("--threads", type=int, default=1, help="Threads per worker")
+    parser.add_argument("--samples", type=int, default=65536, help="Number of synthetic samples")
+    parser.add_argument("--features", type=int, default=64, help="Number of features per sample")
+    parser.add_argument("--batch_size", type=int, default=64, help="Batch size per worker")
+    parser.add_argument("--epochs", type=int, default=3, help="Number of measured epochs")
+    parser.add_argument("--output", type=str, default="", help="Optional JSON file receiving the results")
+    parser.add_argument("--measure", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.measure:
+        measure(int(args.workers), args.threads, args.samples, args.features, args.batch_size, args.epochs)
+    else:
+        report(args)
@@ -1,9 +1,145 @@
 import os
 import json
+import math
+import hashlib
+import shutil
 import sys
+import time
 import tensorflow as tf
 import numpy as np
 
+# Prefix of the lines read by the host (TrainingJob) to receive per-epoch metrics
+METRICS_PREFIX = "FORGEML_METRICS "
+
+def finite_or_none(value):
+    """Converts a metric value to a float, None if it is NaN or infinite."""
+    value = float(value)
+    return value if math.isfinite(value) else None
+
+class MetricsReporter(tf.keras.callbacks.Callback):
+    """Streams the metrics of each epoch to the host as a single JSON line."""
+
+    def __init__(self, num_samples, epochs):
+        super().__init__()
+        self.num_samples = num_samples
+        self.epochs = epochs
+        self.epoch_start = 0.0
+
+    def on_epoch_begin(self, epoch, logs=None):
+        self.epoch_start = time.perf_counter()
+
+    def on_epoch_end(self, epoch, logs=None):
+        elapsed = time.perf_counter() - self.epoch_start
+        report = {
+            "epoch": epoch + 1,
+            "epochs": self.epochs,
+            "seconds": elapsed,
+            "samples_per_sec": self.num_samples / elapsed if elapsed > 0 else 0.0,
+            "metrics": {key: finite_or_none(val) for key, val in (logs or {}).items()}
+        }
+        # NaN and Infinity are not valid JSON, the host reads the null entries as NaN
+        print(METRICS_PREFIX + json.dumps(report, allow_nan=False), flush=True)
+
+class TrainingCheckpoints:
+    """Saves the weights and optimizer state while training runs, so an interrupted run can be resumed.
+
+    Each training phase ("supervised", "reward", "replay") is checkpointed separately, phases completed
+    before the interruption are skipped when resuming. The best validation weights of a phase are kept
+    and promoted once the phase ends."""
+
+    def __init__(self, model_path, input_version, train_config):
+        self.directory = f"{model_path}/train/checkpoints"
+        self.every = train_config.get("checkpoint_every", 1)
+        self.state = {"input_version": input_version, "completed": [], "phase": None, "epoch": 0, "best": None}
+        self.resuming = False
+        self.manager = None
+
+        state_path = f"{self.directory}/state.json"
+        if train_config.get("resume", False) and os.path.exists(state_path):
+            state = load_json(state_path)
+            if state.get("input_version") == input_version:
+                self.state = state
+                self.resuming = True
+                print(f"Resuming Training From Checkpoint ({state['phase'] or 'between phases'}, epoch {state['epoch']})")
+            else:
+                print(f"Ignoring Checkpoint Of Version {state.get('input_version')}, Training Version {input_version}")
+
+        # A fresh run must not pick up checkpoints of an abandoned one
+        if not self.resuming:
+            shutil.rmtree(self.directory, ignore_errors=True)
+        os.makedirs(self.directory, exist_ok=True)
+
+    def restore_weights(self, model):
+        """Restores the weights trained before the interruption, including those of completed phases."""
+        latest = tf.train.latest_checkpoint(self.directory)
+        if self.resuming and latest:
+            tf.train.Checkpoint(model=model).restore(latest).expect_partial()
+
+    def is_completed(self, phase):
+        return phase in self.state["completed"]
+
+    def begin(self, phase, model):
+        """Starts checkpointing a phase of a compiled model, returns the epoch to continue from."""
+        checkpoint = tf.train.Checkpoint(model=model, optimizer=model.optimizer)
+        self.manager = tf.train.CheckpointManager(checkpoint, self.directory, max_to_keep=2)
+
+        if self.state["phase"] == phase and self.manager.latest_checkpoint:
+            checkpoint.restore(self.manager.latest_checkpoint).expect_partial()
+            return self.state["epoch"]
+
+        self.state.update(phase=phase, epoch=0, best=None)
+        return 0
+
+    def callbacks(self, has_validation):
+        return [CheckpointSaver(self, has_validation)]
+
+    def save(self, epoch):
+        self.manager.save(checkpoint_number=epoch)
+        self.state["epoch"] = epoch
+        self.write_state()
+
+    def save_best(self, model, value):
+        model.save_weights(f"{self.directory}/best/weights")
+        self.state["best"] = value
+        self.write_state()
+
+    def end(self, phase, model):
+        """Promotes the best validation weights of the phase and marks it as completed."""
+        if self.state["best"] is not None:
+            model.load_weights(f"{self.directory}/best/weights").expect_partial()
+            print(f"Promoted Best Validation Weights (val_loss {self.state['best']:.4f})")
+
+        self.state.update(phase=None, epoch=0, best=None)
+        self.state["completed"].append(phase)
+        self.manager.save()
+        self.write_state()
+
+    def write_state(self):
+        # Written via rename, an interruption must never leave a partial state behind
+        with open(f"{self.directory}/state.json.partial", 'w') as f:
+            json.dump(self.state, f)
+        os.replace(f"{self.directory}/state.json.partial", f"{self.directory}/state.json")
+
+    def remove(self):
+        shutil.rmtree(self.directory, ignore_errors=True)
+
+class CheckpointSaver(tf.keras.callbacks.Callback):
+    """Checkpoints every few epochs and keeps the weights with the lowest validation loss."""
+
+    def __init__(self, checkpoints, has_validation):
+        super().__init__()
+        self.checkpoints = checkpoints
+        self.has_validation = has_validation
+
+    def on_epoch_end(self, epoch, logs=None):
+        logs = logs or {}
+        best = self.checkpoints.state["best"]
+        if self.has_validation and "val_loss" in logs and (best is None or logs["val_loss"] < best):
+            self.checkpoints.save_best(self.model, float(logs["val_loss"]))
+
+        if self.checkpoints.every > 0 and (epoch + 1) % self.checkpoints.every == 0:
+            self.checkpoints.save(epoch + 1)
+
 def tf_dtype_from_string(dtype_str):
     return {
         "float32": tf.float32,
@@ -19,6 +155,219 @@ def load_json(filepath):
     with open(filepath, 'r') as f:
         return json.load(f)
 
+# Shared memory segments attached by this process, kept open while their columns are in use
+attached_segments = []
+
+def attach_shared_memory(name):
+    """Attaches to a segment owned by the host, which also removes it once training finished."""
+    from multiprocessing import shared_memory
+    try:
+        segment = shared_memory.SharedMemory(name=name, track=False)
+    except TypeError:
+        # Before Python 3.13 attached segments are tracked and would be removed when this process exits
+        from multiprocessing import resource_tracker
+        segment = shared_memory.SharedMemory(name=name)
+        if os.name == "posix":
+            resource_tracker.unregister(segment._name, "shared_memory")
+
+    attached_segments.append(segment)
+    return segment
+
+def load_columns(directory):
+    """Loads a binary column directory written by ColumnarData, numeric columns are memory mapped or
+    wrapped in place if they were placed in shared memory."""
+    manifest = load_json(f"{directory}/manifest.json")
+
+    columns = {}
+    if manifest.get("format") == "shm":
+        segment = attach_shared_memory(manifest["segment"]["name"])
+        for name, column in manifest["columns"].items():
+            data = np.ndarray(column["shape"], dtype=np.dtype(column["dtype"]), buffer=segment.buf, offset=column["offset"])
+            data.flags.writeable = False
+            columns[name] = data
+    else:
+        for name, filename in manifest["columns"].items():
+            columns[name] = np.load(f"{directory}/{filename}", mmap_mode='r')
+
+    for name, filename in manifest["strings"].items():
+        columns[name] = load_json(f"{directory}/{filename}")
+
+    return columns
+
+def load_log_columns(segments):
+    """Maps the sealed TrainingLog segments and joins them into one column per name."""
+    parts = {}
+    for segment in segments:
+        manifest = load_json(f"{segment}/manifest.json")
+        rows = manifest["rows"]
+        if rows == 0:
+            continue
+
+        for name, column in manifest["columns"].items():
+            data = np.memmap(f"{segment}/{column['file']}", dtype=np.float32, mode='r', shape=(rows, column["width"]))
+            parts.setdefault(name, []).append(data)
+
+    return {name: np.concatenate(chunks) for name, chunks in parts.items()}
+
+def load_training_log(model_path, prefix):
+    """Loads the training log segments listed for this run, None if there are none."""
+    filepath = f"{model_path}/train/{prefix}-train_log.json"
+    if not os.path.exists(filepath):
+        return None
+
+    columns = load_log_columns(load_json(filepath)["segments"])
+    return columns if columns else None
+
+def merge_columns(columns, log_columns):
+    """Appends the logged rows to the in-memory columns, columns missing on one side are zero filled."""
+    if columns is None:
+        return log_columns
+    if log_columns is None:
+        return columns
+
+    num_rows = len(next(iter(columns.values())))
+    num_log_rows = len(next(iter(log_columns.values())))
+
+    merged = {}
+    for name in set(columns) | set(log_columns):
+        if name in columns and isinstance(columns[name], list) and isinstance(columns[name][0], str):
+            raise ValueError(f"Column '{name}' holds paths and cannot be merged with the training log.")
+
+        head = np.asarray(columns[name], dtype=np.float32).reshape(num_rows, -1) if name in columns else None
+        tail = np.asarray(log_columns[name], dtype=np.float32).reshape(num_log_rows, -1) if name in log_columns else None
+        if head is None:
+            head = np.zeros((num_rows, tail.shape[1]), dtype=np.float32)
+        if tail is None:
+            tail = np.zeros((num_log_rows, head.shape[1]), dtype=np.float32)
+
+        merged[name] = np.concatenate([head, tail])
+    return merged
+
+# Layout of the index files written by ImageFolderDataset::WriteIndex
+IMAGE_INDEX_HEADER = np.dtype([("magic", "S4"), ("version", "<u4"), ("fingerprint", "<u8"), ("samples", "<u8"),
+                               ("classes", "<u4"), ("reserved", "<u4"), ("path_bytes", "<u8"), ("name_bytes", "<u8")])
+IMAGE_INDEX_SAMPLE = np.dtype([("offset", "<u8"), ("length", "<u4"), ("label", "<u4")])
+
+def read_image_dataset_index(filepath):
+    """Reads an image dataset index, returns the relative paths, the labels and the class count."""
+    data = np.fromfile(filepath, dtype=np.uint8)
+    header = data[:IMAGE_INDEX_HEADER.itemsize].view(IMAGE_INDEX_HEADER)[0]
+    if header["magic"] != b"FMLI" or int(header["version"]) != 1:
+        raise ValueError(f"Invalid image dataset index: {filepath}")
+
+    num_samples = int(header["samples"])
+    num_classes = int(header["classes"])
+
+    begin = IMAGE_INDEX_HEADER.itemsize
+    samples = data[begin:begin + num_samples * IMAGE_INDEX_SAMPLE.itemsize].view(IMAGE_INDEX_SAMPLE)
+
+    # The class name entries are skipped, only the labels are trained on
+    begin += (num_samples + num_classes) * IMAGE_INDEX_SAMPLE.itemsize
+    blob = data[begin:begin + int(header["path_bytes"])].tobytes()
+
+    paths = [blob[offset:offset + length].decode("utf-8") 
+             for offset, length in zip(samples["offset"].tolist(), samples["length"].tolist())]
+    return paths, samples["label"].astype(np.int64), num_classes
+
+def load_image_datasets(model_path):
+    """Loads the image datasets added with MLModel::AddImageDataset as "inputs/<name>" path and
+    "labels/<name>" one-hot columns, None if there are none."""
+    directory = f"{model_path}/train/s-image_data"
+    if not os.path.exists(f"{directory}/manifest.json"):
+        return None
+
+    datasets = []
+    for dataset in load_json(f"{directory}/manifest.json")["datasets"]:
+        paths, labels, num_classes = read_image_dataset_index(f"{directory}/{dataset['index']}")
+        datasets.append((dataset, [f"{dataset['root']}/{path}" for path in paths], labels, num_classes))
+
+    columns = {}
+    for dataset, paths, labels, num_classes in datasets:
+        # One-hot labels span the label output, datasets sharing a label use the widest one
+        width = max(other.get("label_width", classes) for other, _, _, classes in datasets if other["label"] == dataset["label"])
+        one_hot = np.zeros((len(labels), width), dtype=np.float32)
+        one_hot[np.arange(len(labels)), labels] = 1.0
+
+        columns.setdefault(f"inputs/{dataset['input']}", []).extend(paths)
+        columns.setdefault(f"labels/{dataset['label']}", []).append(one_hot)
+
+    return {name: (column if name.startswith("inputs/") else np.concatenate(column)) for name, column in columns.items()}
+
+def append_image_datasets(columns, dataset_columns):
+    """Appends the image dataset samples after the other supervised samples, both must have the same columns."""
+    if columns is None:
+        return dataset_columns
+    if dataset_columns is None:
+        return columns
+
+    if set(columns) != set(dataset_columns):
+        raise ValueError("Image datasets must have the same inputs and labels as the other supervised samples.")
+
+    merged = {}
+    for name, column in columns.items():
+        if name.startswith("inputs/"):
+            # JSON rows hold single element lists
+            merged[name] = [path if isinstance(path, str) else path[0] for path in column] + dataset_columns[name]
+        else:
+            # One-hot labels of fewer classes are zero padded
+            head = np.asarray(column, dtype=np.float32).reshape(len(column), -1)
+            tail = dataset_columns[name]
+            width = max(head.shape[1], tail.shape[1])
+            merged[name] = np.concatenate([np.pad(head, ((0, 0), (0, width - head.shape[1]))),
+                                           np.pad(tail, ((0, 0), (0, width - tail.shape[1])))])
+    return merged
+
+def training_data_exists(model_path, prefix):
+    directory = f"{model_path}/train/{prefix}-train_data"
+    return (os.path.exists(f"{directory}/manifest.json") or 
+            os.path.exists(f"{directory}.json") or 
+            os.path.exists(f"{model_path}/train/{prefix}-train_log.json") or
+            (prefix == "s" and os.path.exists(f"{model_path}/train/s-image_data/manifest.json")) or
+            (prefix == "r" and os.path.exists(f"{model_path}/train/r-replay/manifest.json")))
+
+def load_training_data(model_path, prefix):
+    """Loads training data from the binary column format or JSON, None if there is none."""
+    directory = f"{model_path}/train/{prefix}-train_data"
+    if os.path.exists(f"{directory}/manifest.json"):
+        return load_columns(directory)
+    if os.path.exists(f"{directory}.json"):
+        return load_json(f"{directory}.json")
+    return None
+
+def columns_from_supervised_data(train_data):
+    """Flattens the JSON training data layout into "inputs/<name>" and "labels/<name>" columns."""
+    columns = {}
+    for group in ("inputs", "labels"):
+        for key, rows in train_data.get(group, {}).items():
+            columns[f"{group}/{key}"] = rows
+    return columns
+
+def supervised_data_from_columns(columns):
+    """Groups "inputs/<name>" and "labels/<name>" columns into the JSON training data layout."""
+    train_data = {"inputs": {}, "labels": {}}
+    for name, column in columns.items():
+        group, _, key = name.partition("/")
+        train_data[group][key] = column
+    return train_data
+
+def reward_columns_from_json(train_data):
+    """Converts JSON reward samples into the column layout of the binary format."""
+    columns = {
+        "state": np.array([sample["state"] for sample in train_data], dtype=np.float32),
+        "action": np.array([sample["action"] for sample in train_data], dtype=np.float32),
+        "reward": np.array([sample["reward"] for sample in train_data], dtype=np.float32),
+        "done": np.array([sample.get("done", 0.0) for sample in train_data], dtype=np.float32),
+    }
+
+    # Optional next_state, next_action
+    if any("next_state" in sample for sample in train_data):
+        columns["has_next"] = np.array(["next_state" in sample for sample in train_data], dtype=bool)
+        columns["next_state"] = np.array([sample.get("next_state", np.zeros_like(state)) 
+                                          for sample, state in zip(train_data, columns["state"])], dtype=np.float32)
+        columns["next_action"] = np.array([sample.get("next_action", sample["action"]) for sample in train_data], dtype=np.float32)
+
+    return columns
+
 def load_image_as_tensor(path, target_shape, dtype):
     img = tf.io.read_file(path)
     img = tf.image.decode_image(img, channels=target_shape[-1], dtype=dtype, expand_animations=False)
@@ -35,28 +384,215 @@ def discounted_returns(rewards, gamma):
         returns[t] = running
     return returns
 
-def train_supervised(model, layout, train_config, train_data):
+def configure_distribution(train_config):
+    """Configures the TF runtime threads and creates the training strategy, must run before the first TF op.
+
+    "mirrored" splits the host CPU into num_workers logical devices, each training a replica on its share of every
+    batch. Gradients are all-reduced before each update, batch_size is per worker."""
+    distribution = train_config.get("distribution", "none")
+    cpu_count = os.cpu_count() or 1
+
+    if distribution == "none":
+        threads = train_config.get("threads_per_worker", 0)
+        if threads > 0:
+            tf.config.threading.set_intra_op_parallelism_threads(threads)
+        return tf.distribute.get_strategy()
+
+    if distribution != "mirrored":
+        raise ValueError(f"Unsupported distribution '{distribution}', expected 'none' or 'mirrored'.")
+
+    # Unset counts fill the host, one thread per worker if neither is given
+    threads = train_config.get("threads_per_worker", 0)
+    workers = train_config.get("num_workers", 0) or max(1, cpu_count // max(1, threads))
+    threads = threads or max(1, cpu_count // workers)
+
+    # The intra-op pool is shared by all replicas, each replica runs its ops concurrently to the others
+    tf.config.threading.set_intra_op_parallelism_threads(workers * threads)
+    tf.config.threading.set_inter_op_parallelism_threads(workers)
+
+    cpu = tf.config.list_physical_devices("CPU")[0]
+    tf.config.set_logical_device_configuration(cpu, [tf.config.LogicalDeviceConfiguration() for _ in range(workers)])
+
+    devices = [device.name for device in tf.config.list_logical_devices("CPU")]
+    print(f"Data Parallel Training On {len(devices)} Workers With {threads} Threads Each")
+    return tf.distribute.MirroredStrategy(devices=devices, cross_device_ops=tf.distribute.ReductionToOneDevice())
+
+def create_optimizer(train_config):
+    """Creates the configured optimizer starting at the configured learning rate."""
+    name = train_config.get("optimizer", "adam").lower()
+    optimizers = {
+        "adam": tf.keras.optimizers.Adam,
+        "adamw": tf.keras.optimizers.AdamW,
+        "sgd": tf.keras.optimizers.SGD,
+        "rmsprop": tf.keras.optimizers.RMSprop
+    }
+    if name not in optimizers:
+        raise ValueError(f"Unsupported optimizer '{name}', expected one of {list(optimizers)}.")
+
+    return optimizers[name](learning_rate=train_config.get("learning_rate", 1e-3))
+
+def compile_model(model, train_config, default_loss):
+    """Compiles the model with the configured optimizer, loss and metrics."""
+    model.compile(optimizer=create_optimizer(train_config),
+                  loss=train_config.get("loss_function") or default_loss,
+                  metrics=train_config.get("metrics", []))
+
+def training_callbacks(train_config, has_validation, reporter):
+    """Creates the learning rate schedule and early stopping callbacks, followed by the metrics reporter."""
+    monitor = "val_loss" if has_validation else "loss"
+    min_learning_rate = train_config.get("min_learning_rate", 1e-6)
+
+    callbacks = []
+
+    schedule = train_config.get("lr_schedule", "constant")
+    if schedule == "reduce_on_plateau":
+        callbacks.append(tf.keras.callbacks.ReduceLROnPlateau(
+            monitor=monitor,
+            factor=train_config.get("lr_decay_factor", 0.5),
+            patience=train_config.get("lr_patience", 2),
+            min_lr=min_learning_rate,
+            verbose=1))
+    elif schedule == "cosine":
+        learning_rate = train_config.get("learning_rate", 1e-3)
+        epochs = max(1, train_config.get("epochs", 1))
+
+        def cosine(epoch, current):
+            return min_learning_rate + 0.5 * (learning_rate - min_learning_rate) * (1.0 + math.cos(math.pi * epoch / epochs))
+
+        callbacks.append(tf.keras.callbacks.LearningRateScheduler(cosine))
+    elif schedule != "constant":
+        raise ValueError(f"Unsupported learning rate schedule '{schedule}'.")
+
+    if train_config.get("early_stopping", False):
+        callbacks.append(tf.keras.callbacks.EarlyStopping(
+            monitor=monitor,
+            patience=train_config.get("early_stopping_patience", 5),
+            min_delta=train_config.get("early_stopping_min_delta", 0.0),
+            restore_best_weights=True,
+            verbose=1))
+
+    callbacks.append(reporter)
+    return callbacks
+
+def image_cache_path(model_path, train_config, paths, image_specs):
+    """Resolves the tf.data cache file of decoded images, None if caching is disabled.
+
+    The file name is keyed by the image paths and target shapes, so a cache written for other samples is never reused."""
+    cache = train_config.get("data_cache", "")
+    if not cache:
+        return None
+
+    if not os.path.isabs(cache):
+        cache = os.path.join(model_path, "train", cache)
+    os.makedirs(cache, exist_ok=True)
+
+    digest = hashlib.sha1()
+    digest.update(json.dumps({name: [list(shape), dtype.name] for name, (shape, dtype) in image_specs.items()}).encode("utf-8"))
+    for path in paths:
+        digest.update(path.encode("utf-8"))
+        digest.update(b"\0")
+    return os.path.join(cache, digest.hexdigest())
+
+def create_image_datasets(model_path, layout, train_config, train_data):
+    """Creates streaming training and validation datasets, images are decoded in parallel while training runs."""
+    inputs = {}
+    image_specs = {}
+    for input_spec in layout["inputs"]:
+        name = input_spec["name"]
+        dtype = tf_dtype_from_string(input_spec["dtype"])
+        shape = input_spec["shape"]
+
+        if input_spec.get("domain", "data") == "image":
+            # Binary columns hold plain paths, JSON rows hold single element lists
+            inputs[name] = [path if isinstance(path, str) else path[0] for path in train_data["inputs"][name]]
+            image_specs[name] = (shape[1:], dtype)
+        else:
+            target_shape = [dim for dim in shape if dim != -1]
+            inputs[name] = np.asarray(train_data["inputs"][name], dtype=dtype.as_numpy_dtype).reshape([-1] + target_shape)
+
+    labels = {}
+    for output_spec in layout["outputs"]:
+        name = output_spec["name"]
+        labels[name] = np.asarray(train_data["labels"][name], dtype=np.float32)
+
+    num_samples = len(next(iter(labels.values())))
+    num_validation = int(num_samples * train_config.get("validation_split", 0.0))
+    num_train = num_samples - num_validation
+
+    parallel_calls = train_config.get("data_parallel_calls", 0) or tf.data.AUTOTUNE
+    shuffle_buffer = max(1, min(train_config.get("shuffle_buffer", 1024), num_train))
+    batch_size = train_config.get("batch_size", 32)
+
+    # The cache of each split is keyed by the paths it decodes
+    cache_paths = [
+        image_cache_path(model_path, train_config, [path for name in image_specs for path in inputs[name][begin:end]], image_specs)
+        for begin, end in ((0, num_train), (num_train, num_samples))
+    ]
+
+    def decode(x, y):
+        x = dict(x)
+        for name, (shape, dtype) in image_specs.items():
+            x[name] = load_image_as_tensor(x[name], shape, dtype)
+        return x, y
+
+    def build(begin, end, cache_path, shuffle):
+        dataset = tf.data.Dataset.from_tensor_slices((
+            {name: values[begin:end] for name, values in inputs.items()},
+            {name: values[begin:end] for name, values in labels.items()}))
+
+        if cache_path is not None:
+            # Decoded images are cached once, the bounded shuffle buffer then holds decoded samples
+            dataset = dataset.map(decode, num_parallel_calls=parallel_calls).cache(cache_path)
+            if shuffle:
+                dataset = dataset.shuffle(shuffle_buffer, reshuffle_each_iteration=True)
+        else:
+            # Shuffling the paths before decoding keeps the shuffle buffer small
+            if shuffle:
+                dataset = dataset.shuffle(shuffle_buffer, reshuffle_each_iteration=True)
+            dataset = dataset.map(decode, num_parallel_calls=parallel_calls, deterministic=not shuffle)
+
+        return dataset.batch(batch_size).prefetch(tf.data.AUTOTUNE)
+
+    train_dataset = build(0, num_train, cache_paths[0], train_config.get("shuffle", True))
+    validation_dataset = build(num_train, num_samples, cache_paths[1], False) if num_validation > 0 else None
+    return train_dataset, validation_dataset, num_train
+
+def train_supervised(model, layout, train_config, train_data, model_path, checkpoints):
     print("Supervised Training Detected...")
 
+    eps = train_config.get("epochs", 1)
+    b_size = train_config.get("batch_size", 32)
+    shuffle = train_config.get("shuffle", True)
+    val_split = train_config.get("validation_split", 0.0)
+
+    # --- Compile model -------------------------------------------------------
+    compile_model(model, train_config, "categorical_crossentropy")
+    # -------------------------------------------------------------------------
+
+    initial_epoch = checkpoints.begin("supervised", model)
+
+    # Image inputs are streamed, decoding every image up front does not fit in memory for real datasets
+    if any(input_spec.get("domain", "data") == "image" for input_spec in layout["inputs"]):
+        print("Streaming Image Inputs...")
+
+        train_dataset, validation_dataset, num_train = create_image_datasets(model_path, layout, train_config, train_data)
+        reporter = MetricsReporter(num_train, eps)
+        has_validation = validation_dataset is not None
+        callbacks = training_callbacks(train_config, has_validation, reporter) + checkpoints.callbacks(has_validation)
+
+        model.fit(train_dataset, validation_data=validation_dataset, epochs=eps, initial_epoch=initial_epoch, 
+                  verbose=2, callbacks=callbacks)
+        checkpoints.end("supervised", model)
+        return
+
      # --- Prepare inputs and labels -------------------------------------------
     input_data = {}
     for input_spec in layout["inputs"]:
         name = input_spec["name"]
         dtype = tf_dtype_from_string(input_spec["dtype"])
         shape = input_spec["shape"]
-        domain = input_spec.get("domain", "data")
 
-        if (domain == "image"):
-            print(f"Loading Image Inputs For '{name}'...")
-
-            data_paths = train_data["inputs"][name]
-            img_tensors = [
-                load_image_as_tensor(path_list[0], shape[1:], dtype)
-                for path_list in data_paths
-            ]
-            tensor = tf.stack(img_tensors)
-        else:
-            tensor = tf.convert_to_tensor(train_data["inputs"][name], dtype=dtype)
+        tensor = tf.convert_to_tensor(train_data["inputs"][name], dtype=dtype)
 
         # Determine expected shape (ignore -1 for batch size)
         target_shape = [dim for dim in shape if dim != -1]
@@ -73,22 +609,24 @@ def train_supervised(model, layout, train_config, train_data):
         label_data[name] = tensor
     # -------------------------------------------------------------------------
 
-    # --- Compile model -------------------------------------------------------
-    model.compile(optimizer='adam', loss='categorical_crossentropy')
-    # -------------------------------------------------------------------------
-
     # --- Fit model -----------------------------------------------------------
-    eps = train_config.get("epochs", 1)
-    b_size = train_config.get("batch_size", 32)
-    learning_rate = train_config.get("learning_rate", 1e-3)
-    shuffle = train_config["shuffle"]
-    val_split = train_config["validation_split"]
-
-    model.fit(x=input_data, y=label_data, epochs=eps, batch_size=b_size)
+    num_samples = int(next(iter(label_data.values())).shape[0])
+    num_train = int(num_samples * (1.0 - val_split))
+    reporter = MetricsReporter(num_train, eps)
+    has_validation = num_train < num_samples
+    callbacks = training_callbacks(train_config, has_validation, reporter) + checkpoints.callbacks(has_validation)
+
+    model.fit(x=input_data, y=label_data, epochs=eps, initial_epoch=initial_epoch, batch_size=b_size, shuffle=shuffle, 
+              validation_split=val_split, verbose=2, callbacks=callbacks)
+    checkpoints.end("supervised", model)
     # -------------------------------------------------------------------------
 
 
-def train_with_reward(model, layout, train_config, train_data):
+def q_inputs(model, states, actions):
+    """Feeds the action as second input to Q(s, a) models, Q(s) models only receive the state."""
+    return [states, actions] if len(model.inputs) > 1 else states
+
+def train_with_reward(model, layout, train_config, columns, checkpoints, phase, td_error_path=None):
     print("Reward-Based Training Detected...")
 
     # --- Check model output dimension ---
@@ -101,70 +639,64 @@ def train_with_reward(model, layout, train_config, train_data):
         raise ValueError(f"Model output dimension must be 1 (scalar Q-value), but got {output_shape[-1]}.")
 
 
-    lr = train_config.get("learning_rate", 1e-3)
     gamma = train_config.get("gamma", 0.95)
     
-    optimizer = tf.keras.optimizers.Adam(learning_rate=lr)
-    model.compile(optimizer=optimizer, loss="mse")
-
-    states = []
-    actions = []
-    rewards = []
-    next_states = []
-
-
-    # Parse JSON into numpy arrays
-    for sample in train_data:
-        states.append(sample["state"])
-        actions.append(sample["action"])
-        rewards.append(sample["reward"])
+    compile_model(model, train_config, "mse")
+    initial_epoch = checkpoints.begin(phase, model)
 
-        if "next_state" in sample:
-            next_states.append(sample["next_state"])
-
-
-    states = np.array(states, dtype=np.float32)
-    actions = np.array(actions, dtype=np.int32)
-    rewards = np.array(rewards, dtype=np.float32)
-    
-    # Optional next_state, next_action, done
-    next_states = np.array([d.get("next_state") if "next_state" in d else None for d in train_data], dtype=object)
-    next_actions = np.array([d.get("next_action", a) for d, a in zip(train_data, actions)], dtype=np.float32)
-    dones = np.array([d.get("done", 0.0) for d in train_data], dtype=np.float32)
+    states = np.asarray(columns["state"], dtype=np.float32)
+    actions = np.asarray(columns["action"], dtype=np.float32)
+    rewards = np.asarray(columns["reward"], dtype=np.float32).reshape(-1)
+    dones = np.asarray(columns["done"], dtype=np.float32).reshape(-1) if "done" in columns else np.zeros_like(rewards)
 
     # Compute next Q-values safely
     q_next = np.zeros_like(rewards)
-    has_next = [ns is not None for ns in next_states]
-    if any(has_next):
+    if "next_state" in columns:
         # Only compute for samples that have next_state
-        valid_indices = [i for i, h in enumerate(has_next) if h]
-        valid_next_states = np.array([next_states[i] for i in valid_indices], dtype=np.float32)
-        valid_next_actions = np.array([next_actions[i] for i in valid_indices], dtype=np.float32)
-        q_next_vals = model.predict([valid_next_states, valid_next_actions], verbose=0).squeeze()
-        q_next[valid_indices] = q_next_vals
+        has_next = np.asarray(columns.get("has_next", np.ones(len(rewards), dtype=bool)), dtype=bool).reshape(-1)
+        if has_next.any():
+            valid_next_states = np.asarray(columns["next_state"], dtype=np.float32)[has_next]
+            valid_next_actions = np.asarray(columns.get("next_action", actions), dtype=np.float32)[has_next]
+            q_next_vals = model.predict(q_inputs(model, valid_next_states, valid_next_actions), verbose=0).reshape(-1)
+            q_next[has_next] = q_next_vals
 
     # Q-learning targets
     targets = rewards + gamma * (1 - dones) * q_next
     targets = targets.reshape(-1, 1)
 
-    early_stop = tf.keras.callbacks.EarlyStopping(
-        monitor='loss',
-        patience=5,        # how many epochs with no improvement before stopping
-        restore_best_weights=True
-    )
+    eps = train_config.get("epochs", 1)
+    val_split = train_config.get("validation_split", 0.0)
+    num_train = int(len(states) * (1.0 - val_split))
+    reporter = MetricsReporter(num_train, eps)
+    has_validation = num_train < len(states)
+    callbacks = training_callbacks(train_config, has_validation, reporter) + checkpoints.callbacks(has_validation)
+
+    # Importance sampling weights of prioritized replay minibatches
+    weights = np.asarray(columns["weight"], dtype=np.float32).reshape(-1) if "weight" in columns else None
 
     # Now just fit the model with (states, targets)
     history = model.fit(
-        states,
+        q_inputs(model, states, actions),
         targets,
-        epochs=train_config.get("epochs", 1),
+        sample_weight=weights,
+        epochs=eps,
+        initial_epoch=initial_epoch,
         batch_size=train_config.get("batch_size", 32),
-        verbose=1,
-        shuffle=True,
-        callbacks=[early_stop]
+        verbose=2,
+        shuffle=train_config.get("shuffle", True),
+        validation_split=val_split,
+        callbacks=callbacks
     )
 
-    print(f"[RL Training] Final Loss: {history.history['loss'][-1]:.4f} from {len(states)} samples")
+    checkpoints.end(phase, model)
+
+    if history.history.get("loss"):
+        print(f"[RL Training] Final Loss: {history.history['loss'][-1]:.4f} from {len(states)} samples")
+
+    # TD errors of the trained model, read back by the host to update the replay priorities
+    if td_error_path is not None:
+        q_values = model.predict(q_inputs(model, states, actions), verbose=0).reshape(-1)
+        np.save(td_error_path, (targets.reshape(-1) - q_values).astype(np.float32))
 
 
 
@@ -173,27 +705,60 @@ def main(model_path, input_version, output_version):
     layout = load_json(f"{model_path}/model_description.json")
     train_config = load_json(f"{model_path}/train/train_config.json")
 
-    has_supervised_data = os.path.exists(f"{model_path}/train/s-train_data.json")
-    has_reward_data = os.path.exists(f"{model_path}/train/r-train_data.json")
+    strategy = configure_distribution(train_config)
+    train_config["batch_size"] = train_config.get("batch_size", 32) * strategy.num_replicas_in_sync
 
-    s_train_data = load_json(f"{model_path}/train/s-train_data.json") if has_supervised_data else None
-    r_train_data = load_json(f"{model_path}/train/r-train_data.json") if has_reward_data else None
-    
-    # --- Load Keras model ----------------------------------------------------
-    input_model_path = f"{model_path}/Saved_{input_version}/"
-    model = tf.keras.models.load_model(input_model_path)
-    # -------------------------------------------------------------------------
+    s_train_data = load_training_data(model_path, "s")
+    r_train_data = load_training_data(model_path, "r")
 
-    if (has_supervised_data):
-        train_supervised(model, layout, train_config, s_train_data)
-    
-    if (has_reward_data):
-        train_with_reward(model, layout, train_config, r_train_data)
+    if s_train_data is not None and "inputs" in s_train_data:
+        s_train_data = columns_from_supervised_data(s_train_data)
+
+    if r_train_data is not None and isinstance(r_train_data, list):
+        r_train_data = reward_columns_from_json(r_train_data)
+
+    # Samples streamed through the training log come after the in-memory ones
+    s_train_data = merge_columns(s_train_data, load_training_log(model_path, "s"))
+    r_train_data = merge_columns(r_train_data, load_training_log(model_path, "r"))
+
+    # Images of added datasets come last
+    s_train_data = append_image_datasets(s_train_data, load_image_datasets(model_path))
+
+    # Minibatches drawn from the replay buffer are trained on separately to report their TD errors
+    replay_directory = f"{model_path}/train/r-replay"
+    replay_data = load_columns(replay_directory) if os.path.exists(f"{replay_directory}/manifest.json") else None
+
+    has_supervised_data = s_train_data is not None
+    has_reward_data = r_train_data is not None
+    has_replay_data = replay_data is not None
+
+    if has_supervised_data:
+        s_train_data = supervised_data_from_columns(s_train_data)
     
+    # Variables created in the scope are mirrored on every worker
+    with strategy.scope():
+        # --- Load Keras model ------------------------------------------------
+        input_model_path = f"{model_path}/Saved_{input_version}/"
+        model = tf.keras.models.load_model(input_model_path)
+        # ---------------------------------------------------------------------
+
+        # Weights of an interrupted run are restored, its completed phases are skipped
+        checkpoints = TrainingCheckpoints(model_path, int(input_version), train_config)
+        checkpoints.restore_weights(model)
+
+        if (has_supervised_data and not checkpoints.is_completed("supervised")):
+            train_supervised(model, layout, train_config, s_train_data, model_path, checkpoints)
+
+        if (has_reward_data and not checkpoints.is_completed("reward")):
+            train_with_reward(model, layout, train_config, r_train_data, checkpoints, "reward")
+
+        if (has_replay_data and not checkpoints.is_completed("replay")):
+            train_with_reward(model, layout, train_config, replay_data, checkpoints, "replay", f"{replay_directory}/td_errors.npy")
 
     # --- Save updated model --------------------------------------------------
     output_model_path = f"{model_path}/Saved_{output_version}/"
     model.save(output_model_path)
+    checkpoints.remove()
     print(f"Model Retrained and Saved to {output_model_path}")
     # -------------------------------------------------------------------------
 
@@ -214,9 +779,9 @@ if __name__ == "__main__":
         print("Missing Training Config Json File.")
         sys.exit(-1)
 
-    if (not os.path.exists(f"{model_path}/train/s-train_data.json") and
-        not os.path.exists(f"{model_path}/train/r-train_data.json")):
-        print("Missing Training Data Json File.")
+    if (not training_data_exists(model_path, "s") and
+        not training_data_exists(model_path, "r")):
+        print("Missing Training Data File.")
         sys.exit(-1)
 
     main(model_path, input_version, output_version)
\ No newline at end of file
@@ -44,6 +44,7 @@ public class ForgeML : ModuleRules
 			"Engine",
 			"Slate",
 			"SlateCore",
+			"ImageWrapper",
 			// ... add private dependencies that you statically link with here ...	
 		});
 		
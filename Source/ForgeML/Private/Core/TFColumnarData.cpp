@@ -0,0 +1,235 @@
+#include "Core/TFColumnarData.h"
+
+#include <fstream>
+#include <cstring>
+#include <sstream>
+#include <iostream>
+
+namespace TF
+{
+	// Version of the manifest layout, bumped on incompatible changes
+	static constexpr uint32_t ColumnarFormatVersion = 1;
+
+	// Alignment of the data following an .npy header, as expected by NumPy
+	static constexpr size_t NpyAlignment = 64;
+
+	std::string DataTypeToNpyDescr(DataType type)
+	{
+		switch (type)
+		{
+		case DataType::Bool:
+			return "|b1";
+		case DataType::UInt8:
+			return "|u1";
+		case DataType::Float32:
+			return "<f4";
+		case DataType::Float64:
+		case DataType::Double:
+			return "<f8";
+		case DataType::Int32:
+			return "<i4";
+		case DataType::Int64:
+			return "<i8";
+		default:
+			throw std::invalid_argument("Unsupported DataType");
+		}
+		return "";
+	}
+
+	void ColumnarData::WriteToDirectory(const std::filesystem::path& directory) const
+	{
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+
+		nlohmann::json manifest;
+		manifest["format"] = "npy";
+		manifest["version"] = ColumnarFormatVersion;
+		manifest["columns"] = nlohmann::json::object();
+		manifest["strings"] = nlohmann::json::object();
+
+		// Files are numbered, column names may contain characters that are not valid in paths
+		for (size_t i = 0; i < mColumns.size(); ++i)
+		{
+			const ColumnView& column = mColumns[i];
+			const std::string filename = "c" + std::to_string(i) + ".npy";
+
+			WriteNpyFile(directory / filename, column);
+			manifest["columns"][column.mName] = filename;
+		}
+
+		WriteStringColumns(directory, manifest);
+
+		std::ofstream ofs(directory / "manifest.json");
+		if (!ofs)
+			throw std::runtime_error("Failed to open file for writing: " + (directory / "manifest.json").string());
+
+		ofs << manifest.dump(4);
+	}
+
+	bool ColumnarData::WriteToSharedMemory(const std::filesystem::path& directory,
+										   SharedMemory& memory) const
+	{
+		// Columns start on the same alignment as .npy data
+		std::vector<size_t> offsets;
+		offsets.reserve(mColumns.size());
+
+		size_t total_bytes = 0;
+		for (const ColumnView& column : mColumns)
+		{
+			offsets.push_back(total_bytes);
+			total_bytes += (column.mBytes + NpyAlignment - 1) / NpyAlignment * NpyAlignment;
+		}
+
+		if (!memory.Create(total_bytes))
+		{
+			WriteToDirectory(directory);
+			return false;
+		}
+
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+
+		nlohmann::json manifest;
+		manifest["format"] = "shm";
+		manifest["version"] = ColumnarFormatVersion;
+		manifest["segment"] = 
+		{
+			{ "name", memory.GetName() },
+			{ "bytes", memory.GetSize() }
+		};
+		manifest["columns"] = nlohmann::json::object();
+		manifest["strings"] = nlohmann::json::object();
+
+		for (size_t i = 0; i < mColumns.size(); ++i)
+		{
+			const ColumnView& column = mColumns[i];
+			std::memcpy(memory.GetData() + offsets[i], column.mpData, column.mBytes);
+
+			manifest["columns"][column.mName] = 
+			{
+				{ "offset", offsets[i] },
+				{ "dtype", DataTypeToNpyDescr(column.mType) },
+				{ "shape", column.mShape }
+			};
+		}
+
+		WriteStringColumns(directory, manifest);
+
+		std::ofstream ofs(directory / "manifest.json");
+		if (!ofs)
+			throw std::runtime_error("Failed to open file for writing: " + (directory / "manifest.json").string());
+
+		ofs << manifest.dump(4);
+		return true;
+	}
+
+	void ColumnarData::WriteStringColumns(const std::filesystem::path& directory,
+										  nlohmann::json& manifest) const
+	{
+		for (size_t i = 0; i < mStringColumns.size(); ++i)
+		{
+			const StringColumnView& column = mStringColumns[i];
+			const std::string filename = "s" + std::to_string(i) + ".json";
+
+			std::ofstream ofs(directory / filename);
+			if (!ofs)
+				throw std::runtime_error("Failed to open file for writing: " + (directory / filename).string());
+
+			ofs << nlohmann::json(*column.mpValues).dump();
+			manifest["strings"][column.mName] = filename;
+		}
+	}
+
+	std::string ColumnarData::CreateNpyHeader(DataType type,
+											  const std::vector<int64_t>& shape)
+	{
+		std::stringstream dict;
+		dict << "{'descr': '" << DataTypeToNpyDescr(type) << "', 'fortran_order': False, 'shape': (";
+		for (size_t i = 0; i < shape.size(); ++i)
+		{
+			dict << shape[i];
+			if (shape.size() == 1 || i + 1 < shape.size())
+				dict << ",";
+			if (i + 1 < shape.size())
+				dict << " ";
+		}
+		dict << "), }";
+
+		// magic (6) + version (2) + header length (2)
+		static constexpr size_t PreambleSize = 10;
+
+		std::string header_dict = dict.str();
+		const size_t unpadded = PreambleSize + header_dict.size() + 1;
+		header_dict.append((NpyAlignment - unpadded % NpyAlignment) % NpyAlignment, ' ');
+		header_dict += '\n';
+
+		const uint16_t header_length = static_cast<uint16_t>(header_dict.size());
+
+		std::string header = "\x93NUMPY";
+		header += static_cast<char>(1);
+		header += static_cast<char>(0);
+		header += static_cast<char>(header_length & 0xFF);
+		header += static_cast<char>((header_length >> 8) & 0xFF);
+		header += header_dict;
+		return header;
+	}
+
+	void ColumnarData::WriteNpyFile(const std::filesystem::path& filepath,
+									const ColumnView& column)
+	{
+		std::ofstream ofs(filepath, std::ios::binary);
+		if (!ofs)
+			throw std::runtime_error("Failed to open file for writing: " + filepath.string());
+
+		const std::string header = CreateNpyHeader(column.mType, column.mShape);
+		ofs.write(header.data(), header.size());
+		ofs.write(static_cast<const char*>(column.mpData), column.mBytes);
+
+		if (!ofs)
+			throw std::runtime_error("Failed to write file: " + filepath.string());
+	}
+
+	bool ColumnarData::ReadNpyFile(const std::filesystem::path& filepath,
+								   std::vector<float>& values)
+	{
+		std::ifstream ifs(filepath, std::ios::binary);
+		if (!ifs)
+			return false;
+
+		char preamble[8] = {};
+		ifs.read(preamble, sizeof(preamble));
+		if (!ifs || std::string(preamble, 6) != "\x93NUMPY")
+		{
+			std::cerr << "Not A NumPy File: " << filepath << std::endl;
+			return false;
+		}
+
+		// Version 1.0 stores the header length in 2 bytes, later versions in 4
+		const uint8_t major_version = static_cast<uint8_t>(preamble[6]);
+		uint32_t header_length = 0;
+		unsigned char length_bytes[4] = {};
+		ifs.read(reinterpret_cast<char*>(length_bytes), major_version == 1 ? 2 : 4);
+		for (int i = (major_version == 1 ? 1 : 3); i >= 0; --i)
+			header_length = (header_length << 8) | length_bytes[i];
+
+		std::string header(header_length, '\0');
+		ifs.read(header.data(), header_length);
+		if (!ifs)
+			return false;
+
+		if (header.find("'descr': '<f4'") == std::string::npos || header.find("'fortran_order': False") == std::string::npos)
+		{
+			std::cerr << "Unsupported NumPy Layout In " << filepath << ", Expected C Ordered float32: " << header << std::endl;
+			return false;
+		}
+
+		const std::streampos data_start = ifs.tellg();
+		ifs.seekg(0, std::ios::end);
+		const size_t data_bytes = static_cast<size_t>(ifs.tellg() - data_start);
+		ifs.seekg(data_start);
+
+		values.resize(data_bytes / sizeof(float));
+		ifs.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(float));
+		return static_cast<bool>(ifs);
+	}
+}
@@ -1,5 +1,7 @@
 #include "Core/TFModelLayout.h"
 
+#include "Utils/HashUtils.h"
+
 #include <iostream>
 #include <fstream>
 
@@ -167,6 +169,14 @@ namespace TF
 		ofs << to_json().dump(4);
 	}
 
+	uint64_t ModelLayout::Hash() const
+	{
+		// JSON objects keep their keys sorted, so layer parameters serialize in a canonical order
+		nlohmann::json canonical = to_json();
+		canonical.erase("model_name");
+
+		return HashUtils::HashString(canonical.dump());
+	}
 
 	nlohmann::json ModelLayout::to_json() const
 	{
@@ -0,0 +1,260 @@
+#include "Core/TFReplayBuffer.h"
+#include "Core/TFColumnarData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace TF
+{
+	// Keeps transitions with a zero TD error sampleable
+	static constexpr double PriorityEpsilon = 1e-6;
+
+	SumTree::SumTree(uint32_t capacity)
+	{
+		while (mLeaves < capacity)
+			mLeaves <<= 1;
+
+		mNodes.assign(2 * static_cast<size_t>(mLeaves), 0.0);
+	}
+
+	void SumTree::Set(uint32_t index,
+					  double priority)
+	{
+		size_t node = mLeaves + index;
+		mNodes[node] = priority;
+
+		// Recompute rather than add the difference so rounding errors do not accumulate
+		for (node >>= 1; node >= 1; node >>= 1)
+			mNodes[node] = mNodes[2 * node] + mNodes[2 * node + 1];
+	}
+
+	uint32_t SumTree::Find(double prefix_sum) const
+	{
+		size_t node = 1;
+		while (node < mLeaves)
+		{
+			const size_t left = 2 * node;
+
+			// Rounding may push the value past the left sum, never descend into an empty subtree
+			if (prefix_sum < mNodes[left] || mNodes[left + 1] <= 0.0)
+			{
+				node = left;
+			}
+			else
+			{
+				prefix_sum -= mNodes[left];
+				node = left + 1;
+			}
+		}
+		return static_cast<uint32_t>(node - mLeaves);
+	}
+
+	void ReplayBatch::WriteToDirectory(const std::filesystem::path& directory) const
+	{
+		const int64_t rows = static_cast<int64_t>(mIndices.size());
+
+		const auto AddFloatColumn = [&](ColumnarData& data,
+										const std::string& name,
+										const std::vector<float>& values,
+										uint32_t width)
+		{
+			std::vector<int64_t> shape = { rows };
+			if (width > 0)
+				shape.push_back(width);
+
+			data.AddColumn({ name, DataType::Float32, shape, values.data(), values.size() * sizeof(float) });
+		};
+
+		ColumnarData data;
+		AddFloatColumn(data, "state", mStates, mStateWidth);
+		AddFloatColumn(data, "action", mActions, mActionWidth);
+		AddFloatColumn(data, "reward", mRewards, 0);
+		AddFloatColumn(data, "next_state", mNextStates, mStateWidth);
+		AddFloatColumn(data, "done", mDones, 0);
+		AddFloatColumn(data, "weight", mWeights, 0);
+
+		data.WriteToDirectory(directory);
+	}
+
+	ReplayBuffer::ReplayBuffer(uint32_t capacity,
+							   bool prioritized,
+							   float alpha,
+							   float beta)
+		: mCapacity(capacity),
+		mPrioritized(prioritized),
+		mAlpha(alpha),
+		mBeta(beta),
+		mRandom(std::random_device{}()),
+		mPriorities(prioritized ? capacity : 0)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("ReplayBuffer capacity must be greater than zero");
+	}
+
+	uint32_t ReplayBuffer::GetSize() const
+	{
+		const std::scoped_lock lock(mMutex);
+		return mSize;
+	}
+
+	void ReplayBuffer::SetBeta(float beta)
+	{
+		const std::scoped_lock lock(mMutex);
+		mBeta = beta;
+	}
+
+	void ReplayBuffer::Seed(uint32_t seed)
+	{
+		const std::scoped_lock lock(mMutex);
+		mRandom.seed(seed);
+	}
+
+	bool ReplayBuffer::Add(std::span<const float> state,
+						   std::span<const float> action,
+						   float reward,
+						   std::span<const float> next_state,
+						   bool done)
+	{
+		const std::scoped_lock lock(mMutex);
+
+		// The columns are allocated once the widths are known from the first transition
+		if (mStates.empty())
+		{
+			mStateWidth = static_cast<uint32_t>(state.size());
+			mActionWidth = static_cast<uint32_t>(action.size());
+
+			mStates.resize(static_cast<size_t>(mCapacity) * mStateWidth);
+			mActions.resize(static_cast<size_t>(mCapacity) * mActionWidth);
+			mRewards.resize(mCapacity);
+			mNextStates.resize(static_cast<size_t>(mCapacity) * mStateWidth);
+			mDones.resize(mCapacity);
+			mInsertions.resize(mCapacity);
+		}
+
+		if (state.size() != mStateWidth || next_state.size() != mStateWidth || action.size() != mActionWidth)
+		{
+			std::cerr << "Replay Transition Width Mismatch. Expected State: " << mStateWidth << ", Action: " << mActionWidth
+					  << ", Got State: " << state.size() << ", Next State: " << next_state.size() << ", Action: " << action.size() << std::endl;
+			return false;
+		}
+
+		const size_t slot = mHead;
+		std::copy(state.begin(), state.end(), mStates.begin() + slot * mStateWidth);
+		std::copy(action.begin(), action.end(), mActions.begin() + slot * mActionWidth);
+		std::copy(next_state.begin(), next_state.end(), mNextStates.begin() + slot * mStateWidth);
+		mRewards[slot] = reward;
+		mDones[slot] = done ? 1.0f : 0.0f;
+		mInsertions[slot] = ++mInsertCount;
+
+		if (mPrioritized)
+			mPriorities.Set(mHead, mMaxPriority);
+
+		mHead = (mHead + 1) % mCapacity;
+		mSize = std::min(mSize + 1, mCapacity);
+		return true;
+	}
+
+	bool ReplayBuffer::Sample(uint32_t count,
+							  ReplayBatch& batch)
+	{
+		const std::scoped_lock lock(mMutex);
+
+		batch = ReplayBatch();
+		if (mSize == 0 || count == 0)
+			return false;
+
+		batch.mStateWidth = mStateWidth;
+		batch.mActionWidth = mActionWidth;
+		batch.mIndices.resize(count);
+		batch.mWeights.assign(count, 1.0f);
+
+		if (mPrioritized && mPriorities.Total() > 0.0)
+		{
+			// Stratified, one draw per equal slice of the total priority
+			const double total = mPriorities.Total();
+			const double slice = total / count;
+
+			double max_weight = 0.0;
+			std::vector<double> weights(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				std::uniform_real_distribution<double> distribution(slice * i, slice * (i + 1));
+				const uint32_t index = std::min(mPriorities.Find(distribution(mRandom)), mSize - 1);
+
+				const double probability = mPriorities.Get(index) / total;
+				weights[i] = probability > 0.0 ? std::pow(mSize * probability, -static_cast<double>(mBeta)) : 0.0;
+				max_weight = std::max(max_weight, weights[i]);
+
+				batch.mIndices[i] = index;
+			}
+
+			for (uint32_t i = 0; i < count; ++i)
+				batch.mWeights[i] = max_weight > 0.0 ? static_cast<float>(weights[i] / max_weight) : 1.0f;
+		}
+		else
+		{
+			std::uniform_int_distribution<uint32_t> distribution(0, mSize - 1);
+			for (uint32_t& index : batch.mIndices)
+				index = distribution(mRandom);
+		}
+
+		batch.mStates.reserve(static_cast<size_t>(count) * mStateWidth);
+		batch.mActions.reserve(static_cast<size_t>(count) * mActionWidth);
+		batch.mNextStates.reserve(static_cast<size_t>(count) * mStateWidth);
+		batch.mRewards.reserve(count);
+		batch.mDones.reserve(count);
+		batch.mInsertions.reserve(count);
+
+		for (const uint32_t index : batch.mIndices)
+		{
+			const auto state = mStates.begin() + static_cast<size_t>(index) * mStateWidth;
+			const auto action = mActions.begin() + static_cast<size_t>(index) * mActionWidth;
+			const auto next_state = mNextStates.begin() + static_cast<size_t>(index) * mStateWidth;
+
+			batch.mStates.insert(batch.mStates.end(), state, state + mStateWidth);
+			batch.mActions.insert(batch.mActions.end(), action, action + mActionWidth);
+			batch.mNextStates.insert(batch.mNextStates.end(), next_state, next_state + mStateWidth);
+			batch.mRewards.push_back(mRewards[index]);
+			batch.mDones.push_back(mDones[index]);
+			batch.mInsertions.push_back(mInsertions[index]);
+		}
+		return true;
+	}
+
+	void ReplayBuffer::UpdatePriorities(const ReplayBatch& batch,
+										std::span<const float> td_errors)
+	{
+		const std::vector<uint32_t>& indices = batch.mIndices;
+		if (indices.size() != td_errors.size() || indices.size() != batch.mInsertions.size())
+		{
+			std::cerr << "Replay Priority Update Size Mismatch. Indices: " << indices.size() << ", TD Errors: " << td_errors.size() << std::endl;
+			return;
+		}
+
+		const std::scoped_lock lock(mMutex);
+		if (!mPrioritized)
+			return;
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			// The slot was emptied or overwritten while the batch was trained on, the error belongs to the old transition
+			if (indices[i] >= mSize || mInsertions[indices[i]] != batch.mInsertions[i])
+				continue;
+
+			const double priority = std::pow(std::abs(static_cast<double>(td_errors[i])) + PriorityEpsilon, static_cast<double>(mAlpha));
+			mPriorities.Set(indices[i], priority);
+			mMaxPriority = std::max(mMaxPriority, priority);
+		}
+	}
+
+	void ReplayBuffer::Clear()
+	{
+		const std::scoped_lock lock(mMutex);
+
+		mHead = 0;
+		mSize = 0;
+		mMaxPriority = 1.0;
+		mPriorities = SumTree(mPrioritized ? mCapacity : 0);
+	}
+}
@@ -0,0 +1,82 @@
+#include "Core/TFShardedTrainingData.h"
+
+#include <atomic>
+
+namespace TF
+{
+	/// <summary>
+	/// Retrieves the slot of the calling thread, assigned once per thread in order of first use.
+	/// </summary>
+	static uint32_t GetThreadSlot()
+	{
+		static std::atomic<uint32_t> next_slot = 0;
+		thread_local const uint32_t slot = next_slot++;
+		return slot;
+	}
+
+	ShardedTrainingData::ShardedTrainingData(uint32_t shard_count)
+		: mShardCount(shard_count > 0 ? shard_count : 1),
+		mShards(std::make_unique<Shard[]>(mShardCount))
+	{
+	}
+
+	void ShardedTrainingData::TakeAll(LabeledTrainingBatch& supervised_batch,
+									  RewardTrainingBatch& reward_batch)
+	{
+		for (uint32_t i = 0; i < mShardCount; ++i)
+		{
+			Shard& shard = mShards[i];
+
+			const std::scoped_lock lock(shard.mMutex);
+			supervised_batch.Append(std::move(shard.mSupervisedBatch));
+			reward_batch.Append(std::move(shard.mRewardBatch));
+		}
+	}
+
+	void ShardedTrainingData::CopyAll(LabeledTrainingBatch& supervised_batch,
+									  RewardTrainingBatch& reward_batch) const
+	{
+		for (uint32_t i = 0; i < mShardCount; ++i)
+		{
+			const Shard& shard = mShards[i];
+
+			LabeledTrainingBatch supervised_copy;
+			RewardTrainingBatch reward_copy;
+			{
+				const std::scoped_lock lock(shard.mMutex);
+				supervised_copy = shard.mSupervisedBatch;
+				reward_copy = shard.mRewardBatch;
+			}
+
+			supervised_batch.Append(std::move(supervised_copy));
+			reward_batch.Append(std::move(reward_copy));
+		}
+	}
+
+	uint64_t ShardedTrainingData::GetSupervisedCount() const
+	{
+		uint64_t count = 0;
+		for (uint32_t i = 0; i < mShardCount; ++i)
+		{
+			const std::scoped_lock lock(mShards[i].mMutex);
+			count += mShards[i].mSupervisedBatch.GetRowCount();
+		}
+		return count;
+	}
+
+	uint64_t ShardedTrainingData::GetRewardCount() const
+	{
+		uint64_t count = 0;
+		for (uint32_t i = 0; i < mShardCount; ++i)
+		{
+			const std::scoped_lock lock(mShards[i].mMutex);
+			count += mShards[i].mRewardBatch.mSamples.size();
+		}
+		return count;
+	}
+
+	uint32_t ShardedTrainingData::GetLocalShardIndex() const
+	{
+		return GetThreadSlot() % mShardCount;
+	}
+}
@@ -1,9 +1,234 @@
 #include "Core/TFTrainingBatch.h"
+#include "Core/TFColumnarData.h"
 
+#include <algorithm>
+#include <iostream>
 #include <fstream>
 
 namespace TF
 {
+	/// <summary>
+	/// Flattens nested JSON numbers into a float buffer.
+	/// </summary>
+	/// <returns>False if a non numeric value was found</returns>
+	static bool FlattenNumbers(const nlohmann::json& value, 
+							   std::vector<float>& output)
+	{
+		if (value.is_number() || value.is_boolean())
+		{
+			output.push_back(value.get<float>());
+			return true;
+		}
+
+		if (!value.is_array())
+			return false;
+
+		for (const auto& element : value)
+		{
+			if (!FlattenNumbers(element, output))
+				return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Adds a training column to a set of binary columns.
+	/// </summary>
+	static void AddColumnTo(const TrainingColumn& column, 
+							const std::string& name, 
+							ColumnarData& data)
+	{
+		if (column.IsString())
+		{
+			data.AddStringColumn({ name, &column.mStrings });
+			return;
+		}
+
+		data.AddColumn(
+		{
+			name,
+			DataType::Float32,
+			{ static_cast<int64_t>(column.mRows), static_cast<int64_t>(column.mWidth) },
+			column.mValues.data(),
+			column.mValues.size() * sizeof(float)
+		});
+	}
+
+	/// <summary>
+	/// Finds a column by name, creating it if needed.
+	/// </summary>
+	static TrainingColumn& FindOrAddColumn(std::vector<TrainingColumn>& columns, 
+										   const std::string& name)
+	{
+		for (TrainingColumn& column : columns)
+		{
+			if (column.mName == name)
+				return column;
+		}
+
+		TrainingColumn& column = columns.emplace_back();
+		column.mName = name;
+		return column;
+	}
+
+	bool TrainingColumn::AppendRow(std::span<const float> values)
+	{
+		if (IsString())
+		{
+			std::cerr << "Cannot Add Numeric Row To String Column '" << mName << "'" << std::endl;
+			return false;
+		}
+
+		if (mRows > 0 && values.size() != mWidth)
+		{
+			std::cerr << "Row Width Mismatch For Column '" << mName << "'. Expected: " << mWidth << ", Got: " << values.size() << std::endl;
+			return false;
+		}
+
+		mWidth = static_cast<uint32_t>(values.size());
+		mValues.insert(mValues.end(), values.begin(), values.end());
+		++mRows;
+		return true;
+	}
+
+	bool TrainingColumn::AppendRow(const std::string& value)
+	{
+		if (mRows > 0 && !IsString())
+		{
+			std::cerr << "Cannot Add String Row To Numeric Column '" << mName << "'" << std::endl;
+			return false;
+		}
+
+		mStrings.push_back(value);
+		++mRows;
+		return true;
+	}
+
+	bool TrainingColumn::AppendRow(const nlohmann::json& value)
+	{
+		// Strings may be given directly or as single element rows (e.g., { "image.png" })
+		if (value.is_string())
+			return AppendRow(value.get<std::string>());
+		if (value.is_array() && value.size() == 1 && value.front().is_string())
+			return AppendRow(value.front().get<std::string>());
+
+		std::vector<float> values;
+		if (!FlattenNumbers(value, values))
+		{
+			std::cerr << "Unsupported Row Value For Column '" << mName << "': " << value.dump() << std::endl;
+			return false;
+		}
+		return AppendRow(std::span<const float>(values));
+	}
+
+	bool TrainingColumn::CanAppend(const TrainingColumn& other) const
+	{
+		return mRows == 0 || other.mRows == 0 ||
+			   (IsString() == other.IsString() && (IsString() || mWidth == other.mWidth));
+	}
+
+	bool TrainingColumn::Append(TrainingColumn&& other)
+	{
+		if (other.mRows == 0)
+			return true;
+
+		if (mRows == 0)
+		{
+			*this = std::move(other);
+			other = TrainingColumn{ mName };
+			return true;
+		}
+
+		if (!CanAppend(other))
+		{
+			std::cerr << "Incompatible Columns '" << mName << "' Cannot Be Merged" << std::endl;
+			return false;
+		}
+
+		mValues.insert(mValues.end(), other.mValues.begin(), other.mValues.end());
+		mStrings.insert(mStrings.end(), std::make_move_iterator(other.mStrings.begin()), std::make_move_iterator(other.mStrings.end()));
+		mRows += other.mRows;
+
+		other.mValues.clear();
+		other.mStrings.clear();
+		other.mRows = 0;
+		return true;
+	}
+
+	nlohmann::json TrainingColumn::RowToJson(size_t row) const
+	{
+		if (IsString())
+			return nlohmann::json::array({ mStrings[row] });
+
+		const auto begin = mValues.begin() + row * mWidth;
+		return nlohmann::json(std::vector<float>(begin, begin + mWidth));
+	}
+
+	TrainingColumn& LabeledTrainingBatch::GetInput(const std::string& name)
+	{
+		return FindOrAddColumn(mInputs, name);
+	}
+
+	TrainingColumn& LabeledTrainingBatch::GetLabel(const std::string& name)
+	{
+		return FindOrAddColumn(mLabels, name);
+	}
+
+	uint64_t LabeledTrainingBatch::GetRowCount() const
+	{
+		return mLabels.empty() ? 0 : mLabels.front().mRows;
+	}
+
+	bool LabeledTrainingBatch::HasConsistentRows() const
+	{
+		const uint64_t rows = GetRowCount();
+		for (const auto& column : mInputs)
+		{
+			if (column.mRows != rows)
+				return false;
+		}
+
+		for (const auto& column : mLabels)
+		{
+			if (column.mRows != rows)
+				return false;
+		}
+		return true;
+	}
+
+	bool LabeledTrainingBatch::Append(LabeledTrainingBatch&& other)
+	{
+		// Checked up front, a partially appended batch would leave the rows misaligned
+		const auto CanAppendAll = [](const std::vector<TrainingColumn>& columns,
+									 const std::vector<TrainingColumn>& other_columns)
+		{
+			for (const auto& other_column : other_columns)
+			{
+				for (const auto& column : columns)
+				{
+					if (column.mName == other_column.mName && !column.CanAppend(other_column))
+					{
+						std::cerr << "Incompatible Columns '" << column.mName << "' Cannot Be Merged, Batch Not Appended" << std::endl;
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+
+		if (!CanAppendAll(mInputs, other.mInputs) || !CanAppendAll(mLabels, other.mLabels))
+			return false;
+
+		for (auto& column : other.mInputs)
+			GetInput(column.mName).Append(std::move(column));
+
+		for (auto& column : other.mLabels)
+			GetLabel(column.mName).Append(std::move(column));
+
+		other.Clear();
+		return true;
+	}
+
 	void LabeledTrainingBatch::ReadFromFile(const std::filesystem::path& filepath)
 	{
 		std::ifstream ifs(filepath);
@@ -31,14 +256,36 @@ namespace TF
 		ofs << to_json().dump(4);
 	}
 
+	void LabeledTrainingBatch::WriteToDirectory(const std::filesystem::path& directory,
+												SharedMemory* shared_memory) const
+	{
+		ColumnarData data;
+		for (const auto& column : mInputs)
+			AddColumnTo(column, "inputs/" + column.mName, data);
+
+		for (const auto& column : mLabels)
+			AddColumnTo(column, "labels/" + column.mName, data);
+
+		if (shared_memory)
+			data.WriteToSharedMemory(directory, *shared_memory);
+		else
+			data.WriteToDirectory(directory);
+	}
+
 	nlohmann::json LabeledTrainingBatch::to_json() const
 	{
 		nlohmann::json result;
 		for (const auto& input : mInputs)
-			result["inputs"][input.mName].push_back(input.mData);
+		{
+			for (size_t row = 0; row < input.mRows; ++row)
+				result["inputs"][input.mName].push_back(input.RowToJson(row));
+		}
 
 		for (const auto& label : mLabels)
-			result["labels"][label.mName].push_back(label.mData);
+		{
+			for (size_t row = 0; row < label.mRows; ++row)
+				result["labels"][label.mName].push_back(label.RowToJson(row));
+		}
 
 		return result;
 	}
@@ -49,20 +296,16 @@ namespace TF
 
 		for (auto& [key, val] : inputJson["inputs"].items())
 		{
-			batch.mInputs.push_back(
-			{ 
-				key, 
-				val.get<std::vector<nlohmann::json>>() 
-			});
+			TrainingColumn& column = batch.GetInput(key);
+			for (const auto& row : val)
+				column.AppendRow(row);
 		}
 
 		for (auto& [key, val] : inputJson["labels"].items())
 		{
-			batch.mLabels.push_back(
-			{ 
-				key, 
-				val.get<std::vector<nlohmann::json>>() 
-			});
+			TrainingColumn& column = batch.GetLabel(key);
+			for (const auto& row : val)
+				column.AppendRow(row);
 		}
 		return batch;
 	}
@@ -93,6 +336,82 @@ namespace TF
 		ofs << to_json().dump(4);
 	}
 
+	void RewardTrainingBatch::WriteToDirectory(const std::filesystem::path& directory,
+											   SharedMemory* shared_memory) const
+	{
+		TrainingColumn states{ "state" };
+		TrainingColumn actions{ "action" };
+		std::vector<float> rewards;
+		std::vector<float> dones;
+		rewards.reserve(mSamples.size());
+		dones.reserve(mSamples.size());
+
+		for (const auto& sample : mSamples)
+		{
+			if (!states.AppendRow(sample.mState) || !actions.AppendRow(sample.mAction))
+				throw std::runtime_error("Inconsistent reward training sample");
+
+			rewards.push_back(sample.mReward);
+			dones.push_back(sample.mDone ? 1.0f : 0.0f);
+		}
+
+		ColumnarData data;
+		AddColumnTo(states, "state", data);
+		AddColumnTo(actions, "action", data);
+		data.AddColumn(
+		{
+			"reward",
+			DataType::Float32,
+			{ static_cast<int64_t>(rewards.size()) },
+			rewards.data(),
+			rewards.size() * sizeof(float)
+		});
+		data.AddColumn(
+		{
+			"done",
+			DataType::Float32,
+			{ static_cast<int64_t>(dones.size()) },
+			dones.data(),
+			dones.size() * sizeof(float)
+		});
+
+		// Next states are optional per sample, missing ones are zero filled and flagged
+		TrainingColumn next_states{ "next_state" };
+		std::vector<uint8_t> has_next;
+		const bool any_next = std::any_of(mSamples.begin(), mSamples.end(), [](const RewardData& sample)
+		{
+			return !sample.mNextState.is_null();
+		});
+
+		if (any_next)
+		{
+			const std::vector<float> zeros(states.mWidth, 0.0f);
+			for (const auto& sample : mSamples)
+			{
+				const bool valid = !sample.mNextState.is_null();
+				if (valid ? !next_states.AppendRow(sample.mNextState) : !next_states.AppendRow(std::span<const float>(zeros)))
+					throw std::runtime_error("Inconsistent reward training sample");
+
+				has_next.push_back(valid ? 1 : 0);
+			}
+
+			AddColumnTo(next_states, "next_state", data);
+			data.AddColumn(
+			{
+				"has_next",
+				DataType::Bool,
+				{ static_cast<int64_t>(has_next.size()) },
+				has_next.data(),
+				has_next.size() * sizeof(uint8_t)
+			});
+		}
+
+		if (shared_memory)
+			data.WriteToSharedMemory(directory, *shared_memory);
+		else
+			data.WriteToDirectory(directory);
+	}
+
 	nlohmann::json RewardTrainingBatch::to_json() const
 	{
 		nlohmann::json result;
@@ -104,6 +423,9 @@ namespace TF
 			entry["state"] = sample.mState;
 			entry["action"] = sample.mAction;
 			entry["reward"] = sample.mReward;
+			entry["done"] = sample.mDone;
+			if (!sample.mNextState.is_null())
+				entry["next_state"] = sample.mNextState;
 
 			result.emplace_back(entry);
 		}
@@ -127,6 +449,8 @@ namespace TF
 
 			data.mAction = entry.at("action");
 			data.mReward = entry.at("reward").get<float>();
+			data.mNextState = entry.value("next_state", nlohmann::json());
+			data.mDone = entry.value("done", false);
 
 			batch.mSamples.push_back(std::move(data));
 		}
@@ -12,7 +12,7 @@ namespace TF
 
 		nlohmann::json j;
 		ifs >> j;
-		TrainingConfig batch = from_json(j);
+		*this = from_json(j);
 	}
 
 	void TrainingConfig::WriteToFile(const std::filesystem::path& filepath) const
@@ -38,6 +38,27 @@ namespace TF
 		result["gamma"] = gamma;
 		result["shuffle"] = shuffle;
 		result["validation_split"] = validation_split;
+		result["data_format"] = data_format;
+		result["data_transport"] = data_transport;
+		result["replay_batches"] = replay_batches;
+		result["data_parallel_calls"] = data_parallel_calls;
+		result["shuffle_buffer"] = shuffle_buffer;
+		result["data_cache"] = data_cache;
+		result["optimizer"] = optimizer;
+		result["loss_function"] = loss_function;
+		result["metrics"] = metrics;
+		result["early_stopping"] = early_stopping;
+		result["early_stopping_patience"] = early_stopping_patience;
+		result["early_stopping_min_delta"] = early_stopping_min_delta;
+		result["lr_schedule"] = lr_schedule;
+		result["lr_decay_factor"] = lr_decay_factor;
+		result["lr_patience"] = lr_patience;
+		result["min_learning_rate"] = min_learning_rate;
+		result["checkpoint_every"] = checkpoint_every;
+		result["resume"] = resume;
+		result["distribution"] = distribution;
+		result["num_workers"] = num_workers;
+		result["threads_per_worker"] = threads_per_worker;
 		// Add other fields as needed
 
 		return result;
@@ -59,6 +80,48 @@ namespace TF
 			config.shuffle = inputJson["shuffle"].get<bool>();
 		if (inputJson.contains("validation_split"))
 			config.validation_split = inputJson["validation_split"].get<float>();
+		if (inputJson.contains("data_format"))
+			config.data_format = inputJson["data_format"].get<std::string>();
+		if (inputJson.contains("data_transport"))
+			config.data_transport = inputJson["data_transport"].get<std::string>();
+		if (inputJson.contains("replay_batches"))
+			config.replay_batches = inputJson["replay_batches"].get<uint32_t>();
+		if (inputJson.contains("data_parallel_calls"))
+			config.data_parallel_calls = inputJson["data_parallel_calls"].get<uint32_t>();
+		if (inputJson.contains("shuffle_buffer"))
+			config.shuffle_buffer = inputJson["shuffle_buffer"].get<uint32_t>();
+		if (inputJson.contains("data_cache"))
+			config.data_cache = inputJson["data_cache"].get<std::string>();
+		if (inputJson.contains("optimizer"))
+			config.optimizer = inputJson["optimizer"].get<std::string>();
+		if (inputJson.contains("loss_function"))
+			config.loss_function = inputJson["loss_function"].get<std::string>();
+		if (inputJson.contains("metrics"))
+			config.metrics = inputJson["metrics"].get<std::vector<std::string>>();
+		if (inputJson.contains("early_stopping"))
+			config.early_stopping = inputJson["early_stopping"].get<bool>();
+		if (inputJson.contains("early_stopping_patience"))
+			config.early_stopping_patience = inputJson["early_stopping_patience"].get<uint32_t>();
+		if (inputJson.contains("early_stopping_min_delta"))
+			config.early_stopping_min_delta = inputJson["early_stopping_min_delta"].get<float>();
+		if (inputJson.contains("lr_schedule"))
+			config.lr_schedule = inputJson["lr_schedule"].get<std::string>();
+		if (inputJson.contains("lr_decay_factor"))
+			config.lr_decay_factor = inputJson["lr_decay_factor"].get<float>();
+		if (inputJson.contains("lr_patience"))
+			config.lr_patience = inputJson["lr_patience"].get<uint32_t>();
+		if (inputJson.contains("min_learning_rate"))
+			config.min_learning_rate = inputJson["min_learning_rate"].get<float>();
+		if (inputJson.contains("checkpoint_every"))
+			config.checkpoint_every = inputJson["checkpoint_every"].get<uint32_t>();
+		if (inputJson.contains("resume"))
+			config.resume = inputJson["resume"].get<bool>();
+		if (inputJson.contains("distribution"))
+			config.distribution = inputJson["distribution"].get<std::string>();
+		if (inputJson.contains("num_workers"))
+			config.num_workers = inputJson["num_workers"].get<uint32_t>();
+		if (inputJson.contains("threads_per_worker"))
+			config.threads_per_worker = inputJson["threads_per_worker"].get<uint32_t>();
 		// Add other fields as needed
 
 		return config;
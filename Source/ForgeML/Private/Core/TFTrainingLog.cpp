@@ -0,0 +1,418 @@
+#include "Core/TFTrainingLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace TF
+{
+	// Version of the segment manifest layout, bumped on incompatible changes
+	static constexpr uint32_t TrainingLogFormatVersion = 1;
+
+	// Time the writer waits for more records before committing a group
+	static constexpr std::chrono::milliseconds GroupCommitInterval(5);
+
+	static constexpr const char* SegmentPrefix = "segment-";
+	static constexpr const char* ManifestFilename = "manifest.json";
+	static constexpr const char* SchemaFilename = "schema.json";
+
+	/// <summary>
+	/// Creates the directory name of a segment, zero padded so names sort by index.
+	/// </summary>
+	static std::string SegmentName(uint32_t index)
+	{
+		static constexpr size_t Digits = 6;
+
+		const std::string number = std::to_string(index);
+		return SegmentPrefix + std::string(Digits - std::min(Digits, number.size()), '0') + number;
+	}
+
+	/// <summary>
+	/// Retrieves the size of a record in bytes.
+	/// </summary>
+	static uint64_t RecordBytes(const std::vector<TrainingColumn>& record)
+	{
+		uint64_t bytes = 0;
+		for (const auto& column : record)
+			bytes += column.mValues.size() * sizeof(float);
+		return bytes;
+	}
+
+	/// <summary>
+	/// Reads a JSON file, returning a discarded value if it cannot be parsed.
+	/// </summary>
+	static nlohmann::json ReadJsonFile(const std::filesystem::path& filepath)
+	{
+		std::ifstream ifs(filepath);
+		if (!ifs)
+			return nlohmann::json(nlohmann::json::value_t::discarded);
+
+		return nlohmann::json::parse(ifs, nullptr, false);
+	}
+
+	/// <summary>
+	/// Lists the segment directories of a log, oldest first.
+	/// </summary>
+	static std::vector<std::filesystem::path> ListSegments(const std::filesystem::path& directory)
+	{
+		std::vector<std::filesystem::path> segments;
+		for (const auto& entry : std::filesystem::directory_iterator(directory))
+		{
+			if (entry.is_directory() && entry.path().filename().string().rfind(SegmentPrefix, 0) == 0)
+				segments.push_back(entry.path());
+		}
+
+		std::sort(segments.begin(), segments.end());
+		return segments;
+	}
+
+	TrainingLog::TrainingLog(const std::filesystem::path& directory,
+							 uint64_t max_in_flight_bytes,
+							 uint64_t segment_bytes)
+		: mDirectory(directory),
+		mMaxInFlightBytes(max_in_flight_bytes),
+		mSegmentBytes(segment_bytes)
+	{
+		std::filesystem::create_directories(mDirectory);
+		RecoverSegments();
+
+		mWriter = std::thread(&TrainingLog::WriterLoop, this);
+	}
+
+	TrainingLog::~TrainingLog()
+	{
+		{
+			const std::scoped_lock lock(mQueueMutex);
+			mStop = true;
+		}
+		mQueueCondition.notify_all();
+		mSpaceCondition.notify_all();
+
+		if (mWriter.joinable())
+			mWriter.join();
+
+		try
+		{
+			const std::scoped_lock lock(mSegmentMutex);
+			SealActiveSegment();
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Failed To Seal Training Log " << mDirectory << ": " << e.what() << std::endl;
+		}
+	}
+
+	bool TrainingLog::Append(std::vector<TrainingColumn>&& record)
+	{
+		if (record.empty() || record.front().mRows == 0)
+			return false;
+
+		for (const auto& column : record)
+		{
+			if (column.IsString() || column.mRows != record.front().mRows)
+			{
+				std::cerr << "Training Log Only Supports Numeric Records With Aligned Rows, Rejected Column '" << column.mName << "'" << std::endl;
+				return false;
+			}
+		}
+
+		const uint64_t bytes = RecordBytes(record);
+		const uint64_t rows = record.front().mRows;
+
+		std::unique_lock lock(mQueueMutex);
+
+		for (const auto& column : record)
+		{
+			const auto [found, inserted] = mWidths.try_emplace(column.mName, column.mWidth);
+			if (found->second != column.mWidth)
+			{
+				std::cerr << "Training Log Width Mismatch For Column '" << column.mName << "'. Expected: " << found->second << ", Got: " << column.mWidth << std::endl;
+				return false;
+			}
+		}
+
+		// A record larger than the window is still accepted once the queue is empty
+		mSpaceCondition.wait(lock, [&]()
+		{
+			return mStop || mFailed || mInFlightBytes == 0 || mInFlightBytes + bytes <= mMaxInFlightBytes;
+		});
+
+		if (mStop || mFailed)
+			return false;
+
+		mQueue.push_back(std::move(record));
+		mInFlightBytes += bytes;
+		mQueuedRows += rows;
+		++mQueuedRecords;
+
+		lock.unlock();
+		mQueueCondition.notify_one();
+		return true;
+	}
+
+	bool TrainingLog::Flush()
+	{
+		std::unique_lock lock(mQueueMutex);
+		mFlushRequested = true;
+		mQueueCondition.notify_one();
+
+		// Records are written in queue order, so steady producers cannot hold the flush back
+		const uint64_t target = mQueuedRecords;
+		mSpaceCondition.wait(lock, [&]()
+		{
+			return mWrittenRecords >= target || mFailed;
+		});
+
+		return !mFailed;
+	}
+
+	std::vector<std::filesystem::path> TrainingLog::Seal()
+	{
+		Flush();
+
+		const std::scoped_lock lock(mSegmentMutex);
+		SealActiveSegment();
+
+		std::vector<std::filesystem::path> sealed;
+		for (const auto& segment : ListSegments(mDirectory))
+		{
+			if (std::filesystem::exists(segment / ManifestFilename))
+				sealed.push_back(segment);
+		}
+		return sealed;
+	}
+
+	void TrainingLog::Remove(const std::vector<std::filesystem::path>& segments)
+	{
+		const std::scoped_lock lock(mSegmentMutex);
+		for (const auto& segment : segments)
+		{
+			const nlohmann::json manifest = ReadJsonFile(segment / ManifestFilename);
+			if (!manifest.is_discarded())
+				mSealedRows -= std::min(mSealedRows, manifest.value("rows", uint64_t(0)));
+
+			std::error_code ec;
+			std::filesystem::remove_all(segment, ec);
+		}
+	}
+
+	bool TrainingLog::HasData() const
+	{
+		{
+			const std::scoped_lock lock(mQueueMutex);
+			if (mQueuedRows > 0)
+				return true;
+		}
+
+		const std::scoped_lock lock(mSegmentMutex);
+		return mSealedRows + mActiveRows > 0;
+	}
+
+	uint64_t TrainingLog::GetInFlightBytes() const
+	{
+		const std::scoped_lock lock(mQueueMutex);
+		return mInFlightBytes;
+	}
+
+	void TrainingLog::WriterLoop()
+	{
+		std::unique_lock lock(mQueueMutex);
+		while (true)
+		{
+			mQueueCondition.wait(lock, [&]()
+			{
+				return mStop || !mQueue.empty();
+			});
+
+			if (mQueue.empty())
+				break;
+
+			// Gather more records into the group, unless someone waits on them or the window is filling up
+			mQueueCondition.wait_for(lock, GroupCommitInterval, [&]()
+			{
+				return mStop || mFlushRequested || mInFlightBytes * 2 >= mMaxInFlightBytes;
+			});
+
+			std::vector<std::vector<TrainingColumn>> group;
+			std::swap(group, mQueue);
+			mFlushRequested = false;
+			lock.unlock();
+
+			bool success = false;
+			try
+			{
+				const std::scoped_lock segment_lock(mSegmentMutex);
+				success = WriteRecords(group);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Failed To Write Training Log " << mDirectory << ": " << e.what() << std::endl;
+			}
+
+			uint64_t bytes = 0;
+			uint64_t rows = 0;
+			for (const auto& record : group)
+			{
+				bytes += RecordBytes(record);
+				rows += record.front().mRows;
+			}
+
+			lock.lock();
+			mWrittenRecords += group.size();
+			mInFlightBytes -= bytes;
+			mQueuedRows -= rows;
+			if (!success)
+				mFailed = true;
+
+			mSpaceCondition.notify_all();
+		}
+	}
+
+	bool TrainingLog::WriteRecords(const std::vector<std::vector<TrainingColumn>>& records)
+	{
+		for (const auto& record : records)
+		{
+			if (mActiveSegment.empty())
+			{
+				mActiveSegment = mDirectory / SegmentName(mNextSegment++);
+				std::filesystem::create_directories(mActiveSegment);
+			}
+
+			for (const auto& column : record)
+			{
+				const auto [found, inserted] = mActiveColumns.try_emplace(column.mName);
+				SegmentColumn& file = found->second;
+				if (inserted)
+				{
+					file.mFilename = "c" + std::to_string(mActiveColumns.size() - 1) + ".bin";
+					file.mWidth = column.mWidth;
+					file.mStream.open(mActiveSegment / file.mFilename, std::ios::binary | std::ios::app);
+
+					// The schema must exist before any data so an interrupted segment can be recovered
+					WriteSchema();
+				}
+
+				const size_t bytes = column.mValues.size() * sizeof(float);
+				file.mStream.write(reinterpret_cast<const char*>(column.mValues.data()), bytes);
+				file.mRows += column.mRows;
+				mActiveBytes += bytes;
+			}
+			mActiveRows += record.front().mRows;
+
+			if (mActiveBytes >= mSegmentBytes)
+				SealActiveSegment();
+		}
+
+		bool success = true;
+		for (auto& [name, file] : mActiveColumns)
+		{
+			file.mStream.flush();
+			if (!file.mStream)
+			{
+				std::cerr << "Failed To Write Training Log Column '" << name << "' In " << mActiveSegment << std::endl;
+				success = false;
+			}
+		}
+		return success;
+	}
+
+	void TrainingLog::SealActiveSegment()
+	{
+		if (mActiveSegment.empty())
+			return;
+
+		// Rows are only complete once every column holds them
+		uint64_t rows = mActiveColumns.empty() ? 0 : UINT64_MAX;
+
+		nlohmann::json columns = nlohmann::json::object();
+		for (auto& [name, file] : mActiveColumns)
+		{
+			file.mStream.close();
+			rows = std::min(rows, file.mRows);
+			columns[name] = { { "file", file.mFilename }, { "width", file.mWidth } };
+		}
+
+		WriteManifest(mActiveSegment, columns, rows);
+		mSealedRows += rows;
+
+		mActiveSegment.clear();
+		mActiveColumns.clear();
+		mActiveBytes = 0;
+		mActiveRows = 0;
+	}
+
+	void TrainingLog::RecoverSegments()
+	{
+		for (const auto& segment : ListSegments(mDirectory))
+		{
+			const std::string name = segment.filename().string();
+			mNextSegment = std::max(mNextSegment, static_cast<uint32_t>(std::stoul(name.substr(std::char_traits<char>::length(SegmentPrefix)))) + 1);
+
+			nlohmann::json manifest = ReadJsonFile(segment / ManifestFilename);
+			if (manifest.is_discarded())
+			{
+				// Interrupted segment, keep the rows that were fully written
+				const nlohmann::json schema = ReadJsonFile(segment / SchemaFilename);
+				if (schema.is_discarded() || !schema.contains("columns"))
+				{
+					std::error_code ec;
+					std::filesystem::remove_all(segment, ec);
+					continue;
+				}
+
+				uint64_t rows = UINT64_MAX;
+				for (const auto& [column, info] : schema["columns"].items())
+				{
+					const uint64_t row_bytes = info["width"].get<uint64_t>() * sizeof(float);
+
+					std::error_code ec;
+					const uint64_t file_bytes = std::filesystem::file_size(segment / info["file"].get<std::string>(), ec);
+					rows = std::min(rows, ec || row_bytes == 0 ? 0 : file_bytes / row_bytes);
+				}
+
+				WriteManifest(segment, schema["columns"], rows == UINT64_MAX ? 0 : rows);
+				manifest = ReadJsonFile(segment / ManifestFilename);
+			}
+
+			mSealedRows += manifest.value("rows", uint64_t(0));
+			for (const auto& [column, info] : manifest["columns"].items())
+				mWidths[column] = info["width"].get<uint32_t>();
+		}
+	}
+
+	void TrainingLog::WriteSchema() const
+	{
+		nlohmann::json columns = nlohmann::json::object();
+		for (const auto& [name, file] : mActiveColumns)
+			columns[name] = { { "file", file.mFilename }, { "width", file.mWidth } };
+
+		std::ofstream ofs(mActiveSegment / SchemaFilename, std::ios::trunc);
+		if (!ofs)
+			throw std::runtime_error("Failed to open file for writing: " + (mActiveSegment / SchemaFilename).string());
+
+		ofs << nlohmann::json{ { "columns", columns } }.dump(4);
+	}
+
+	void TrainingLog::WriteManifest(const std::filesystem::path& segment,
+									const nlohmann::json& columns,
+									uint64_t rows)
+	{
+		nlohmann::json manifest;
+		manifest["format"] = "raw";
+		manifest["version"] = TrainingLogFormatVersion;
+		manifest["dtype"] = "<f4";
+		manifest["rows"] = rows;
+		manifest["columns"] = columns;
+
+		// Written under a temporary name, a segment only counts as sealed once the manifest is complete
+		const std::filesystem::path partial = segment / (std::string(ManifestFilename) + ".partial");
+		{
+			std::ofstream ofs(partial, std::ios::trunc);
+			if (!ofs)
+				throw std::runtime_error("Failed to open file for writing: " + partial.string());
+
+			ofs << manifest.dump(4);
+		}
+		std::filesystem::rename(partial, segment / ManifestFilename);
+	}
+}
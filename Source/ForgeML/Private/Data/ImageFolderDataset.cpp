@@ -0,0 +1,442 @@
+#include "Data/ImageFolderDataset.h"
+
+#include "Utils/ThreadPool.h"
+#include "Utils/HashUtils.h"
+
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <stdexcept>
+#include <charconv>
+#include <unordered_map>
+
+namespace TF
+{
+	static constexpr uint32_t IndexVersion = 1;
+
+	// Header of an index file, followed by the samples, the class name entries, the paths and the class names
+	struct IndexHeader
+	{
+		char mMagic[4] = { 'F', 'M', 'L', 'I' };
+		uint32_t mVersion = IndexVersion;
+		uint64_t mFingerprint = 0;
+		uint64_t mSampleCount = 0;
+		uint32_t mClassCount = 0;
+		uint32_t mReserved = 0;
+		uint64_t mPathBytes = 0;
+		uint64_t mNameBytes = 0;
+	};
+
+	// The trainer reads the samples as a packed (uint64, uint32, uint32) record array
+	static_assert(sizeof(ImageFolderDataset::Sample) == 16, "Index samples must be packed.");
+
+	/// <summary>
+	/// Advances a splitmix64 generator.
+	/// </summary>
+	/// <param name="state">The generator state</param>
+	/// <returns>The next random value</returns>
+	static uint64_t SplitMix64(uint64_t& state)
+	{
+		uint64_t value = (state += 0x9E3779B97F4A7C15ull);
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+
+	/// <summary>
+	/// Checks whether a file has an image extension.
+	/// </summary>
+	/// <param name="path">The file path</param>
+	/// <returns>True if the file is an image</returns>
+	static bool IsImageFile(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		return extension == ".jpg" || extension == ".jpeg" || extension == ".png" || extension == ".bmp" || extension == ".gif";
+	}
+
+	/// <summary>
+	/// Parses a folder or label map key as a label.
+	/// </summary>
+	/// <param name="name">The name</param>
+	/// <param name="label">The output label</param>
+	/// <returns>True if the name is a non-negative integer</returns>
+	static bool ParseLabel(const std::string& name,
+						   uint32_t& label)
+	{
+		const char* end = name.data() + name.size();
+		const auto [ptr, ec] = std::from_chars(name.data(), end, label);
+		return !name.empty() && ec == std::errc() && ptr == end;
+	}
+
+	/// <summary>
+	/// Lists the class folders of a dataset in sorted order.
+	/// </summary>
+	/// <param name="root">The dataset root</param>
+	/// <param name="folders">The output class folders</param>
+	/// <returns>True if the root was read</returns>
+	static bool ListClassFolders(const std::filesystem::path& root,
+								 std::vector<std::filesystem::path>& folders)
+	{
+		std::error_code ec;
+		for (std::filesystem::directory_iterator iter(root, ec), end; !ec && iter != end; iter.increment(ec))
+		{
+			if (iter->is_directory(ec))
+				folders.push_back(iter->path());
+		}
+
+		if (ec)
+			return false;
+
+		std::sort(folders.begin(), folders.end());
+		return true;
+	}
+
+	bool ImageFolderDataset::Scan(const std::filesystem::path& root,
+								  const std::filesystem::path& label_map_path)
+	{
+		// Taken before listing, images added during the scan make the index stale rather than missing
+		const uint64_t fingerprint = ComputeFingerprint(root, label_map_path);
+
+		std::vector<std::filesystem::path> folders;
+		if (!ListClassFolders(root, folders))
+		{
+			std::cerr << "Failed To Read Dataset: " << root.string() << std::endl;
+			return false;
+		}
+
+		// Labels of the class folders, from the label map or the folder names
+		std::vector<uint32_t> folder_labels(folders.size(), 0);
+		std::vector<std::string> class_names;
+
+		if (!label_map_path.empty())
+		{
+			std::ifstream ifs(label_map_path);
+			const nlohmann::json label_map = nlohmann::json::parse(ifs, nullptr, false);
+			if (!label_map.is_object())
+			{
+				std::cerr << "Failed To Read Label Map: " << label_map_path.string() << std::endl;
+				return false;
+			}
+
+			std::unordered_map<std::string, uint32_t> labels_by_name;
+			for (const auto& [key, value] : label_map.items())
+			{
+				uint32_t label = 0;
+				if (!ParseLabel(key, label) || !value.is_string())
+				{
+					std::cerr << "Invalid Label Map Entry '" << key << "' In: " << label_map_path.string() << std::endl;
+					return false;
+				}
+
+				if (label >= class_names.size())
+					class_names.resize(label + 1);
+
+				class_names[label] = value.get<std::string>();
+				labels_by_name[class_names[label]] = label;
+			}
+
+			for (size_t i = 0; i < folders.size(); ++i)
+			{
+				const std::string name = folders[i].filename().string();
+
+				uint32_t label = 0;
+				if (ParseLabel(name, label) && label < class_names.size() && !class_names[label].empty())
+				{
+					folder_labels[i] = label;
+					continue;
+				}
+
+				const auto found = labels_by_name.find(name);
+				if (found == labels_by_name.end())
+				{
+					std::cerr << "Class Folder '" << name << "' Not Found In Label Map: " << label_map_path.string() << std::endl;
+					return false;
+				}
+				folder_labels[i] = found->second;
+			}
+		}
+		else
+		{
+			const bool numeric = std::all_of(folders.begin(), folders.end(), [&](const std::filesystem::path& folder)
+			{
+				uint32_t label = 0;
+				return ParseLabel(folder.filename().string(), label);
+			});
+
+			for (size_t i = 0; i < folders.size(); ++i)
+			{
+				if (numeric)
+					ParseLabel(folders[i].filename().string(), folder_labels[i]);
+				else
+					folder_labels[i] = static_cast<uint32_t>(i);
+
+				if (folder_labels[i] >= class_names.size())
+					class_names.resize(folder_labels[i] + 1);
+
+				class_names[folder_labels[i]] = folders[i].filename().string();
+			}
+		}
+
+		// Each class folder is listed on its own worker
+		std::vector<std::vector<std::string>> folder_files(folders.size());
+		ThreadPool::GetShared().ParallelFor(folders.size(), [&](size_t i)
+		{
+			const std::string folder_name = folders[i].filename().string();
+
+			std::error_code ec;
+			for (std::filesystem::directory_iterator iter(folders[i], ec), end; !ec && iter != end; iter.increment(ec))
+			{
+				if (iter->is_regular_file(ec) && IsImageFile(iter->path()))
+					folder_files[i].push_back(folder_name + "/" + iter->path().filename().string());
+			}
+
+			std::sort(folder_files[i].begin(), folder_files[i].end());
+		});
+
+		size_t sample_count = 0;
+		size_t path_bytes = 0;
+		for (const std::vector<std::string>& files : folder_files)
+		{
+			sample_count += files.size();
+			for (const std::string& file : files)
+				path_bytes += file.size();
+		}
+
+		auto paths = std::make_shared<std::string>();
+		paths->reserve(path_bytes);
+
+		std::vector<Sample> samples;
+		samples.reserve(sample_count);
+		for (size_t i = 0; i < folders.size(); ++i)
+		{
+			for (const std::string& file : folder_files[i])
+			{
+				samples.push_back({ paths->size(), static_cast<uint32_t>(file.size()), folder_labels[i] });
+				paths->append(file);
+			}
+		}
+
+		mRoot = root;
+		mpPaths = std::move(paths);
+		mSamples = std::move(samples);
+		mClassNames = std::move(class_names);
+		mFingerprint = fingerprint;
+		return true;
+	}
+
+	bool ImageFolderDataset::Open(const std::filesystem::path& root,
+								  const std::filesystem::path& index_path,
+								  const std::filesystem::path& label_map_path)
+	{
+		const uint64_t fingerprint = ComputeFingerprint(root, label_map_path);
+		if (fingerprint != 0 && ReadIndex(root, index_path) && mFingerprint == fingerprint)
+			return true;
+
+		if (!Scan(root, label_map_path))
+			return false;
+
+		// A stale or missing index only costs the scan, the dataset is still usable
+		WriteIndex(index_path);
+		return true;
+	}
+
+	bool ImageFolderDataset::WriteIndex(const std::filesystem::path& index_path) const
+	{
+		// Only the paths of the samples are written, so shards get compact indices
+		std::string paths;
+		std::vector<Sample> samples;
+		samples.reserve(mSamples.size());
+		for (size_t i = 0; i < mSamples.size(); ++i)
+		{
+			const std::string_view path = GetRelativePath(i);
+			samples.push_back({ paths.size(), mSamples[i].mLength, mSamples[i].mLabel });
+			paths.append(path);
+		}
+
+		std::string names;
+		std::vector<Sample> name_entries;
+		name_entries.reserve(mClassNames.size());
+		for (size_t label = 0; label < mClassNames.size(); ++label)
+		{
+			name_entries.push_back({ names.size(), static_cast<uint32_t>(mClassNames[label].size()), static_cast<uint32_t>(label) });
+			names.append(mClassNames[label]);
+		}
+
+		IndexHeader header;
+		header.mFingerprint = mFingerprint;
+		header.mSampleCount = samples.size();
+		header.mClassCount = static_cast<uint32_t>(name_entries.size());
+		header.mPathBytes = paths.size();
+		header.mNameBytes = names.size();
+
+		std::error_code ec;
+		if (index_path.has_parent_path())
+			std::filesystem::create_directories(index_path.parent_path(), ec);
+
+		// Written aside and renamed, a reader never sees a partial index
+		const std::filesystem::path partial_path = index_path.string() + ".partial";
+		{
+			std::ofstream out(partial_path, std::ios::binary | std::ios::trunc);
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(Sample));
+			out.write(reinterpret_cast<const char*>(name_entries.data()), name_entries.size() * sizeof(Sample));
+			out.write(paths.data(), paths.size());
+			out.write(names.data(), names.size());
+
+			if (!out)
+			{
+				std::cerr << "Failed To Write Dataset Index: " << index_path.string() << std::endl;
+				std::filesystem::remove(partial_path, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(partial_path, index_path, ec);
+		if (ec)
+		{
+			std::cerr << "Failed To Write Dataset Index: " << index_path.string() << std::endl;
+			std::filesystem::remove(partial_path, ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool ImageFolderDataset::ReadIndex(const std::filesystem::path& root,
+									   const std::filesystem::path& index_path)
+	{
+		std::ifstream in(index_path, std::ios::binary);
+		if (!in)
+			return false;
+
+		IndexHeader header;
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		const IndexHeader expected;
+		if (!in ||
+			std::memcmp(header.mMagic, expected.mMagic, sizeof(header.mMagic)) != 0 ||
+			header.mVersion != IndexVersion)
+		{
+			return false;
+		}
+
+		std::error_code ec;
+		const uint64_t file_size = std::filesystem::file_size(index_path, ec);
+		if (ec || file_size != sizeof(header) + (header.mSampleCount + header.mClassCount) * sizeof(Sample) + header.mPathBytes + header.mNameBytes)
+			return false;
+
+		std::vector<Sample> samples(header.mSampleCount);
+		std::vector<Sample> name_entries(header.mClassCount);
+		auto paths = std::make_shared<std::string>(header.mPathBytes, '\0');
+		std::string names(header.mNameBytes, '\0');
+
+		in.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(Sample));
+		in.read(reinterpret_cast<char*>(name_entries.data()), name_entries.size() * sizeof(Sample));
+		in.read(paths->data(), paths->size());
+		in.read(names.data(), names.size());
+		if (!in)
+			return false;
+
+		for (const Sample& sample : samples)
+		{
+			if (sample.mOffset + sample.mLength > paths->size() || sample.mLabel >= header.mClassCount)
+				return false;
+		}
+
+		std::vector<std::string> class_names(header.mClassCount);
+		for (const Sample& entry : name_entries)
+		{
+			if (entry.mOffset + entry.mLength > names.size() || entry.mLabel >= header.mClassCount)
+				return false;
+
+			class_names[entry.mLabel] = names.substr(entry.mOffset, entry.mLength);
+		}
+
+		mRoot = root;
+		mpPaths = std::move(paths);
+		mSamples = std::move(samples);
+		mClassNames = std::move(class_names);
+		mFingerprint = header.mFingerprint;
+		return true;
+	}
+
+	void ImageFolderDataset::Shuffle(uint64_t seed)
+	{
+		// Fisher-Yates driven by splitmix64, the order only depends on the seed and the sample count
+		uint64_t state = seed;
+		for (size_t i = mSamples.size(); i > 1; --i)
+		{
+			const size_t j = static_cast<size_t>(SplitMix64(state) % i);
+			std::swap(mSamples[i - 1], mSamples[j]);
+		}
+	}
+
+	ImageFolderDataset ImageFolderDataset::GetShard(uint32_t index,
+													uint32_t count) const
+	{
+		if (count == 0 || index >= count)
+			throw std::invalid_argument("Shard Index Must Be Less Than The Shard Count.");
+
+		ImageFolderDataset shard;
+		shard.mRoot = mRoot;
+		shard.mpPaths = mpPaths;
+		shard.mClassNames = mClassNames;
+		shard.mFingerprint = mFingerprint;
+
+		shard.mSamples.reserve(mSamples.size() / count + 1);
+		for (size_t i = index; i < mSamples.size(); i += count)
+			shard.mSamples.push_back(mSamples[i]);
+
+		return shard;
+	}
+
+	std::string_view ImageFolderDataset::GetRelativePath(size_t index) const
+	{
+		const Sample& sample = mSamples[index];
+		return std::string_view(*mpPaths).substr(sample.mOffset, sample.mLength);
+	}
+
+	std::filesystem::path ImageFolderDataset::GetPath(size_t index) const
+	{
+		return mRoot / std::filesystem::path(std::string(GetRelativePath(index)));
+	}
+
+	uint64_t ImageFolderDataset::ComputeFingerprint(const std::filesystem::path& root,
+													const std::filesystem::path& label_map_path)
+	{
+		std::vector<std::filesystem::path> folders;
+		if (!ListClassFolders(root, folders))
+			return 0;
+
+		// Adding or removing an image changes the modification time of its class folder
+		uint64_t hash = HashUtils::HashString(std::to_string(IndexVersion));
+		for (const std::filesystem::path& folder : folders)
+		{
+			std::error_code ec;
+			const int64_t modified = static_cast<int64_t>(std::filesystem::last_write_time(folder, ec).time_since_epoch().count());
+
+			hash = HashUtils::HashString(folder.filename().string(), hash);
+			hash = HashUtils::Hash(&modified, sizeof(modified), hash);
+		}
+
+		if (!label_map_path.empty())
+		{
+			// An unreadable label map is reported by the scan, which fails on it
+			try
+			{
+				hash = HashUtils::HashFile(label_map_path, hash);
+			}
+			catch (const std::exception&)
+			{
+				return 0;
+			}
+		}
+
+		return hash == 0 ? 1 : hash;
+	}
+}
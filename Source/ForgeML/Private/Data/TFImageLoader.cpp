@@ -3,60 +3,322 @@
 #include "CppFlowLib.h"
 #include "OpenCVLib.h"
 
+#include "Utils/ThreadPool.h"
+#include "Utils/DiskCache.h"
+#include "Utils/HashUtils.h"
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <cmath>
+#include <filesystem>
+#include <type_traits>
+
 namespace TF
 {
-	bool ConvertToChannels(cv::Mat& img, 
-						   uint32_t desired_channels, 
-						   bool to_rgb = true) 
-	{
-		int current_channels = img.channels();
+	// Bytes read from an image file to find the JPEG frame header, enough to skip EXIF data and thumbnails
+	static constexpr size_t JpegHeaderBytes = 128 * 1024;
 
-		// If already matches, no conversion needed
-		if (current_channels == desired_channels) 
-			return true;
+	// Bumped whenever the conversion changes, invalidating previously cached tensors
+	static constexpr uint32_t CachedTensorVersion = 2;
 
-		int code = -1;
+	// Header of a cached tensor entry, followed by the raw values so the file can be memory-mapped
+	struct CachedTensorHeader
+	{
+		char mMagic[4] = { 'F', 'M', 'L', 'T' };
+		uint32_t mVersion = CachedTensorVersion;
+		uint32_t mDataType = 0;
+		uint32_t mReserved = 0;
+		uint64_t mValueCount = 0;
+	};
 
-		// Define dynamic conversion logic
-		switch (current_channels) 
+	/// <summary>
+	/// Reads the dimensions of a JPEG from its frame header (SOF marker) without decoding it.
+	/// </summary>
+	/// <param name="data">The start of the encoded image</param>
+	/// <param name="size">The number of available bytes</param>
+	/// <param name="width">The output width in pixels</param>
+	/// <param name="height">The output height in pixels</param>
+	/// <param name="components">The output number of color components</param>
+	/// <returns>True if the data is a JPEG and its frame header was found</returns>
+	static bool ReadJpegHeader(const uint8_t* data,
+							   size_t size,
+							   uint32_t& width,
+							   uint32_t& height,
+							   uint32_t& components)
+	{
+		if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+			return false;
+
+		size_t position = 2;
+		while (position < size)
 		{
-			case 1:
+			if (data[position] != 0xFF)
+				return false;
+
+			// Markers may be preceded by fill bytes
+			while (position < size && data[position] == 0xFF)
+				++position;
+
+			if (position + 2 >= size)
+				return false;
+
+			const uint8_t marker = data[position++];
+
+			// Standalone markers carry no segment
+			if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+				continue;
+
+			// Start of scan or end of image before any frame header
+			if (marker == 0xDA || marker == 0xD9)
+				return false;
+
+			const size_t length = (static_cast<size_t>(data[position]) << 8) | data[position + 1];
+			if (length < 2)
+				return false;
+
+			// SOF0 - SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+			const bool is_frame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+			if (is_frame)
 			{
-				if (desired_channels == 3)
-					code = to_rgb ? cv::COLOR_GRAY2RGB : cv::COLOR_GRAY2BGR;
-				else if (desired_channels == 4)
-					code = to_rgb ? cv::COLOR_GRAY2RGBA : cv::COLOR_GRAY2BGRA;
-				break;
+				// Length (2), precision (1), height (2), width (2), components (1)
+				if (position + 8 > size)
+					return false;
+
+				height = (static_cast<uint32_t>(data[position + 3]) << 8) | data[position + 4];
+				width = (static_cast<uint32_t>(data[position + 5]) << 8) | data[position + 6];
+				components = data[position + 7];
+				return width > 0 && height > 0;
 			}
-			case 3:
+
+			position += length;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Builds the affine map from source to destination channels (destination = weights * source + offsets),
+	/// matching the cv::cvtColor conversions between gray, three and four channel images.
+	/// </summary>
+	/// <param name="src_channels">The number of source channels</param>
+	/// <param name="dst_channels">The number of destination channels</param>
+	/// <param name="to_rgb">Whether the source is treated as RGB rather than BGR for gray conversions</param>
+	/// <param name="weights">The output weights per destination and source channel</param>
+	/// <param name="offsets">The output offset per destination channel</param>
+	/// <returns>True if the conversion is supported</returns>
+	static bool BuildChannelMap(int src_channels,
+								int dst_channels,
+								bool to_rgb,
+								float (&weights)[4][4],
+								float (&offsets)[4])
+	{
+		for (int d = 0; d < 4; ++d)
+		{
+			offsets[d] = 0.0f;
+			for (int s = 0; s < 4; ++s)
+				weights[d][s] = 0.0f;
+		}
+
+		const bool has_color = src_channels == 3 || src_channels == 4;
+
+		// If already matches, no conversion needed
+		if (src_channels == dst_channels)
+		{
+			for (int c = 0; c < dst_channels; ++c)
+				weights[c][c] = 1.0f;
+		}
+		else if (src_channels == 1 && (dst_channels == 3 || dst_channels == 4))
+		{
+			for (int c = 0; c < 3; ++c)
+				weights[c][0] = 1.0f;
+		}
+		else if (has_color && dst_channels == 1)
+		{
+			weights[0][0] = to_rgb ? 0.299f : 0.114f;
+			weights[0][1] = 0.587f;
+			weights[0][2] = to_rgb ? 0.114f : 0.299f;
+		}
+		else if (has_color && (dst_channels == 3 || dst_channels == 4))
+		{
+			for (int c = 0; c < 3; ++c)
+				weights[c][c] = 1.0f;
+		}
+		else
+		{
+			std::cerr << "Unsupported channel conversion: from "  
+					  << std::to_string(src_channels) << " to "
+					  << std::to_string(dst_channels) << std::endl;
+			return false;
+		}
+
+		// Added alpha channels are opaque
+		if (dst_channels == 4 && src_channels != 4)
+			offsets[3] = 255.0f;
+
+		return true;
+	}
+
+	/// <summary>
+	/// Computes the bilinear source taps of every destination coordinate along one axis,
+	/// using the pixel center alignment of cv::INTER_LINEAR.
+	/// </summary>
+	/// <param name="src_size">The source size along the axis</param>
+	/// <param name="dst_size">The destination size along the axis</param>
+	/// <param name="lower">The output lower source index per destination index</param>
+	/// <param name="upper">The output upper source index per destination index</param>
+	/// <param name="weights">The output weight of the upper source index</param>
+	static void ComputeTaps(int src_size,
+							int dst_size,
+							std::vector<int>& lower,
+							std::vector<int>& upper,
+							std::vector<float>& weights)
+	{
+		lower.resize(dst_size);
+		upper.resize(dst_size);
+		weights.resize(dst_size);
+
+		const double scale = static_cast<double>(src_size) / dst_size;
+		for (int i = 0; i < dst_size; ++i)
+		{
+			const double position = std::clamp((i + 0.5) * scale - 0.5, 0.0, static_cast<double>(src_size - 1));
+			const int index = static_cast<int>(position);
+
+			lower[i] = index;
+			upper[i] = std::min(index + 1, src_size - 1);
+			weights[i] = static_cast<float>(position - index);
+		}
+	}
+
+	/// <summary>
+	/// Struct representing the precomputed work of converting an image into a tensor.
+	/// </summary>
+	struct ConversionPlan
+	{
+		int mSrcChannels = 0;
+		int mDstChannels = 0;
+		int mWidth = 0;
+		int mHeight = 0;
+
+		float mChannelWeights[4][4] = {};
+		float mChannelOffsets[4] = {};
+
+		std::vector<int> mXLower, mXUpper, mYLower, mYUpper;
+		std::vector<float> mXWeights, mYWeights;
+
+		// Output strides of a row, column and channel in the shape order
+		size_t mRowStride = 0;
+		size_t mColStride = 0;
+		size_t mChannelStride = 0;
+
+		// Unscaled, unconverted interleaved bytes, the rows are copied as they are
+		bool mIsCopy = false;
+	};
+
+	static inline void StoreValue(float value, float& output)
+	{
+		output = value;
+	}
+
+	static inline void StoreValue(float value, uint8_t& output)
+	{
+		output = static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+	}
+
+	/// <summary>
+	/// Writes every output value of an 8-bit image following the conversion plan.
+	/// </summary>
+	/// <param name="source">The 8-bit source image</param>
+	/// <param name="plan">The conversion plan</param>
+	/// <param name="output">The output buffer</param>
+	template<typename T>
+	static void WritePixels(const cv::Mat& source,
+							const ConversionPlan& plan,
+							T* output)
+	{
+		if constexpr (std::is_same_v<T, uint8_t>)
+		{
+			if (plan.mIsCopy)
 			{
-				if (desired_channels == 1)
-					code = to_rgb ? cv::COLOR_RGB2GRAY : cv::COLOR_BGR2GRAY;
-				else if (desired_channels == 4)
-					code = to_rgb ? cv::COLOR_RGB2RGBA : cv::COLOR_BGR2BGRA;
-				else if (desired_channels == 3 && !to_rgb)
-					code = cv::COLOR_RGB2BGR;  // fallback
-				break;
+				const size_t row_bytes = static_cast<size_t>(plan.mWidth) * plan.mDstChannels;
+				for (int y = 0; y < plan.mHeight; ++y)
+					std::memcpy(output + y * plan.mRowStride, source.ptr<uint8_t>(y), row_bytes);
+				return;
 			}
-			case 4:
+		}
+
+		const int src_channels = plan.mSrcChannels;
+
+		// Single pass: every output value is interpolated from the source pixels, converted,
+		// normalized and written straight to its place in the shape order
+		for (int y = 0; y < plan.mHeight; ++y)
+		{
+			const uint8_t* top_row = source.ptr<uint8_t>(plan.mYLower[y]);
+			const uint8_t* bottom_row = source.ptr<uint8_t>(plan.mYUpper[y]);
+			const float wy = plan.mYWeights[y];
+
+			T* output_row = output + y * plan.mRowStride;
+			for (int x = 0; x < plan.mWidth; ++x)
 			{
-				if (desired_channels == 1)
-					code = to_rgb ? cv::COLOR_RGBA2GRAY : cv::COLOR_BGRA2GRAY;
-				else if (desired_channels == 3)
-					code = to_rgb ? cv::COLOR_RGBA2RGB : cv::COLOR_BGRA2BGR;
-				break;
+				const uint8_t* top_left = top_row + plan.mXLower[x] * src_channels;
+				const uint8_t* top_right = top_row + plan.mXUpper[x] * src_channels;
+				const uint8_t* bottom_left = bottom_row + plan.mXLower[x] * src_channels;
+				const uint8_t* bottom_right = bottom_row + plan.mXUpper[x] * src_channels;
+				const float wx = plan.mXWeights[x];
+
+				float pixel[4];
+				for (int s = 0; s < src_channels; ++s)
+				{
+					const float top = top_left[s] + (top_right[s] - top_left[s]) * wx;
+					const float bottom = bottom_left[s] + (bottom_right[s] - bottom_left[s]) * wx;
+					pixel[s] = top + (bottom - top) * wy;
+				}
+
+				T* output_pixel = output_row + x * plan.mColStride;
+				for (int c = 0; c < plan.mDstChannels; ++c)
+				{
+					float value = plan.mChannelOffsets[c];
+					for (int s = 0; s < src_channels; ++s)
+						value += plan.mChannelWeights[c][s] * pixel[s];
+
+					StoreValue(value, output_pixel[c * plan.mChannelStride]);
+				}
 			}
 		}
+	}
 
-		if (code == -1)
+	/// <summary>
+	/// Creates a tensor of the data type, filled by the given function.
+	/// </summary>
+	/// <param name="type">The data type of the tensor</param>
+	/// <param name="value_count">The number of values</param>
+	/// <param name="shape">The tensor shape</param>
+	/// <param name="fill">The function writing the values, returning false on failure</param>
+	/// <param name="output">The output tensor</param>
+	/// <returns>True whether the tensor was filled</returns>
+	template<typename FillFunc>
+	static bool CreateTensor(DataType type,
+							 size_t value_count,
+							 const std::vector<int64_t>& shape,
+							 FillFunc&& fill,
+							 cppflow::tensor& output)
+	{
+		if (type == DataType::UInt8)
 		{
-			std::cerr << "Unsupported channel conversion: from "  
-					  << std::to_string(current_channels) << " to "
-					  << std::to_string(desired_channels);
-			return false;
+			std::vector<uint8_t> values(value_count);
+			if (!fill(static_cast<void*>(values.data())))
+				return false;
+
+			output = cppflow::tensor(values, shape);
+			return true;
 		}
 
-		cv::cvtColor(img, img, code);
+		std::vector<float> values(value_count);
+		if (!fill(static_cast<void*>(values.data())))
+			return false;
+
+		output = cppflow::tensor(values, shape);
 		return true;
 	}
 
@@ -91,119 +353,383 @@ namespace TF
 	}
 	}
 
+	void ImageTensorLoader::SetDataType(DataType type)
+	{
+		if (type != DataType::Float32 && type != DataType::UInt8)
+			throw std::invalid_argument("Image tensors must be Float32 or UInt8.");
+
+		if (type == DataType::UInt8 && (mNormalize || !mMean.empty() || !mStdDev.empty()))
+			throw std::invalid_argument("UInt8 image tensors hold raw pixel values, normalization must be disabled.");
+
+		mDataType = type;
+	}
+
+	void ImageTensorLoader::SetNormalization(const std::vector<float>& mean, 
+											 const std::vector<float>& std_dev)
+	{
+		// Single values are broadcast to every channel
+		const auto Expand = [this](const std::vector<float>& values, const char* name)
+		{
+			if (values.empty() || values.size() == mChannels)
+				return values;
+
+			if (values.size() != 1)
+				throw std::invalid_argument(std::string("Normalization ") + name + " must hold one value or one per channel.");
+
+			return std::vector<float>(mChannels, values[0]);
+		};
+
+		if (mDataType == DataType::UInt8 && (!mean.empty() || !std_dev.empty()))
+			throw std::invalid_argument("UInt8 image tensors hold raw pixel values, normalization must be disabled.");
+
+		std::vector<float> expanded_mean = Expand(mean, "mean");
+		std::vector<float> expanded_std_dev = Expand(std_dev, "std_dev");
+
+		for (float value : expanded_std_dev)
+		{
+			if (value == 0.0f)
+				throw std::invalid_argument("Normalization std_dev must not be zero.");
+		}
+
+		mMean = std::move(expanded_mean);
+		mStdDev = std::move(expanded_std_dev);
+	}
+
 	bool ImageTensorLoader::Load(const std::string& image_path, cppflow::tensor& output)
 	{
-		cv::Mat image = cv::imread(image_path, cv::IMREAD_UNCHANGED);
-		if (image.empty())
+		return CreateTensor(mDataType, GetImageSize(), GetTensorShape(1), [&](void* values)
 		{
-			std::cerr << "Failed to load image: " << image_path << std::endl;
+			return LoadInto(image_path, values);
+		}, output);
+	}
+
+	bool ImageTensorLoader::Load(const uint8_t* pixels, 
+								 uint32_t width, 
+								 uint32_t height, 
+								 uint32_t channels, 
+								 size_t stride, 
+								 cppflow::tensor& output)
+	{
+		return CreateTensor(mDataType, GetImageSize(), GetTensorShape(1), [&](void* values)
+		{
+			return LoadInto(pixels, width, height, channels, stride, values);
+		}, output);
+	}
+
+	bool ImageTensorLoader::LoadInto(const uint8_t* pixels, 
+									 uint32_t width, 
+									 uint32_t height, 
+									 uint32_t channels, 
+									 size_t stride, 
+									 void* output) const
+	{
+		if (!pixels || width == 0 || height == 0 || channels < 1 || channels > 4 || channels == 2)
+		{
+			std::cerr << "Invalid Pixel Buffer." << std::endl;
 			return false;
 		}
 
-		bool isGrayScale = mChannelOrder == ChannelOrder::GrayScale;
+		const size_t row_bytes = static_cast<size_t>(width) * channels;
+		if (stride != 0 && stride < row_bytes)
+		{
+			std::cerr << "Pixel Buffer Stride Smaller Than A Row: " << stride << " < " << row_bytes << std::endl;
+			return false;
+		}
+
+		// Wraps the caller's buffer, ConvertInto never writes to it
+		const cv::Mat image(static_cast<int>(height),
+							static_cast<int>(width),
+							CV_8UC(channels),
+							const_cast<uint8_t*>(pixels),
+							stride != 0 ? stride : row_bytes);
 
-		ConvertToChannels(image, mChannels, !isGrayScale);
+		return ConvertInto(image, output);
+	}
+
+	bool ImageTensorLoader::Load(const uint8_t* encoded, 
+								 size_t size, 
+								 cppflow::tensor& output)
+	{
+		if (!encoded || size == 0)
+		{
+			std::cerr << "No Encoded Image Data." << std::endl;
+			return false;
+		}
+
+		const cv::Mat buffer(1, static_cast<int>(size), CV_8UC1, const_cast<uint8_t*>(encoded));
+		const cv::Mat image = cv::imdecode(buffer, SelectDecodeFlags(encoded, size));
+		if (image.empty())
+		{
+			std::cerr << "Failed to decode image of " << size << " bytes." << std::endl;
+			return false;
+		}
 
+		return CreateTensor(mDataType, GetImageSize(), GetTensorShape(1), [&](void* values)
+		{
+			return ConvertInto(image, values);
+		}, output);
+	}
 
-		cv::resize(image, image, cv::Size(mWidth, mHeight));
-		if (mNormalize)
+	bool ImageTensorLoader::LoadBatch(const std::vector<std::string>& image_paths, cppflow::tensor& output)
+	{
+		if (image_paths.empty())
 		{
-			image.convertTo(image, CV_32FC(mChannels), 1.0 / 255.0);
+			std::cerr << "No Images To Load." << std::endl;
+			return false;
 		}
 
-		std::vector<float> input_data;
-		const auto InputPixel = [&](uint32_t x, uint32_t y, uint32_t c) -> bool
+		// Every image is written straight into its slice of the batch
+		const size_t image_bytes = GetImageSize() * GetElementSize();
+
+		return CreateTensor(mDataType,
+							image_paths.size() * GetImageSize(),
+							GetTensorShape(static_cast<int64_t>(image_paths.size())),
+							[&](void* values)
 		{
-			switch (mChannelOrder)
+			std::atomic<bool> success = true;
+			ThreadPool::GetShared().ParallelFor(image_paths.size(), [&](size_t i)
 			{
-				case ChannelOrder::GrayScale:
-					input_data.push_back(image.at<float>(y, x));
-					return true;
-				case ChannelOrder::BGR:
-				case ChannelOrder::RGB:
-					input_data.push_back(image.at<cv::Vec3f>(y, x)[c]);
-					return true;
-				case ChannelOrder::BGRA:
-				case ChannelOrder::RGBA:
-					input_data.push_back(image.at<cv::Vec4f>(y, x)[c]);
-					return true;
-				default:
-					std::cerr << "Unsupported Channel Order." << std::endl;
-					return false;
-			}
-		};
+				if (!LoadInto(image_paths[i], static_cast<uint8_t*>(values) + i * image_bytes))
+					success = false;
+			});
+			return success.load();
+		}, output);
+	}
 
+	std::vector<int64_t> ImageTensorLoader::GetTensorShape(int64_t batch_size) const
+	{
 		switch (mShapeOrder)
 		{
-			case ShapeOrder::HeightWidthChannels:
-			{
-				for (uint32_t y = 0; y < mHeight; ++y)
-					for (uint32_t x = 0; x < mWidth; ++x)
-						for (uint32_t c = 0; c < mChannels; ++c)
-							if (!InputPixel(x, y, c))
-								continue;
-				break;
-			}
 			case ShapeOrder::WidthHeightChannels:
-			{
-				for (uint32_t x = 0; x < mWidth; ++x)
-					for (uint32_t y = 0; y < mHeight; ++y)
-						for (uint32_t c = 0; c < mChannels; ++c)
-							if (!InputPixel(x, y, c))
-								continue;
-				break;
-			}
+				return { batch_size, static_cast<int64_t>(mWidth), static_cast<int64_t>(mHeight), static_cast<int64_t>(mChannels) };
+			case ShapeOrder::HeightWidthChannels:
+				return { batch_size, static_cast<int64_t>(mHeight), static_cast<int64_t>(mWidth), static_cast<int64_t>(mChannels) };
 			case ShapeOrder::ChannelsHeightWidth:
-			{
-				for (uint32_t c = 0; c < mChannels; ++c)
-					for (uint32_t y = 0; y < mHeight; ++y)
-						for (uint32_t x = 0; x < mWidth; ++x)
-							if (!InputPixel(x, y, c))
-								continue;
-				break;
-			}
+				return { batch_size, static_cast<int64_t>(mChannels), static_cast<int64_t>(mHeight), static_cast<int64_t>(mWidth) };
 			case ShapeOrder::ChannelsWidthHeight:
-			{
-				for (uint32_t c = 0; c < mChannels; ++c)
-					for (uint32_t x = 0; x < mWidth; ++x)
-						for (uint32_t y = 0; y < mHeight; ++y)
-							if (!InputPixel(x, y, c))
-								continue;
-				break;
-			}
+				return { batch_size, static_cast<int64_t>(mChannels), static_cast<int64_t>(mWidth), static_cast<int64_t>(mHeight) };
 			default:
-				std::cerr << "Unsupported Shape Order." << std::endl;
-				return false;
+				throw std::invalid_argument("Invalid Shape Order.");
+		}
+	}
+
+	int ImageTensorLoader::SelectDecodeFlags(const uint8_t* header, size_t size) const
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t components = 0;
+		if (mDecodeOversampling <= 0.0f || !ReadJpegHeader(header, size, width, height, components))
+			return cv::IMREAD_UNCHANGED;
+
+		// Reduced decodes always yield gray or BGR, like full JPEG decodes
+		const bool is_gray = components == 1;
+		const std::pair<uint32_t, int> reductions[] =
+		{
+			{ 8, is_gray ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8 },
+			{ 4, is_gray ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4 },
+			{ 2, is_gray ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2 },
+		};
+
+		const double min_width = static_cast<double>(mWidth) * mDecodeOversampling;
+		const double min_height = static_cast<double>(mHeight) * mDecodeOversampling;
+
+		for (const auto& [factor, flags] : reductions)
+		{
+			const double reduced_width = std::ceil(static_cast<double>(width) / factor);
+			const double reduced_height = std::ceil(static_cast<double>(height) / factor);
+
+			// Full decodes ignore the EXIF orientation, reduced ones must as well
+			if (reduced_width >= min_width && reduced_height >= min_height)
+				return flags | cv::IMREAD_IGNORE_ORIENTATION;
+		}
+
+		return cv::IMREAD_UNCHANGED;
+	}
+
+	bool ImageTensorLoader::LoadInto(const std::string& image_path, void* output) const
+	{
+		const std::string cache_key = mpCache ? GetCacheKey(image_path) : "";
+		if (!cache_key.empty() && ReadCached(cache_key, output))
+			return true;
+
+		int flags = cv::IMREAD_UNCHANGED;
+		if (mDecodeOversampling > 0.0f)
+		{
+			std::vector<uint8_t> header(JpegHeaderBytes);
+
+			std::ifstream file(image_path, std::ios::binary);
+			file.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+			flags = SelectDecodeFlags(header.data(), static_cast<size_t>(file.gcount()));
 		}
 
-		
+		const cv::Mat image = cv::imread(image_path, flags);
+		if (image.empty())
+		{
+			std::cerr << "Failed to load image: " << image_path << std::endl;
+			return false;
+		}
+
+		if (!ConvertInto(image, output))
+			return false;
+
+		if (!cache_key.empty())
+			WriteCached(cache_key, output);
+
+		return true;
+	}
+
+	std::string ImageTensorLoader::GetCacheKey(const std::string& image_path) const
+	{
+		std::error_code ec;
+		const std::filesystem::path path = std::filesystem::absolute(image_path, ec);
+		if (ec)
+			return "";
+
+		const auto modified = std::filesystem::last_write_time(path, ec);
+		if (ec)
+			return "";
+
+		const uint64_t file_size = std::filesystem::file_size(path, ec);
+		if (ec)
+			return "";
+
+		// Everything that changes the converted values is part of the key
+		std::string identity = path.generic_string() +
+							   "|" + std::to_string(modified.time_since_epoch().count()) +
+							   "|" + std::to_string(file_size) +
+							   "|" + std::to_string(CachedTensorVersion) +
+							   "|" + std::to_string(mWidth) + "x" + std::to_string(mHeight) + "x" + std::to_string(mChannels) +
+							   "|" + std::to_string(mNormalize) +
+							   "|" + std::to_string(static_cast<int>(mChannelOrder)) +
+							   "|" + std::to_string(static_cast<int>(mShapeOrder)) +
+							   "|" + std::to_string(mDecodeOversampling) +
+							   "|" + std::to_string(static_cast<int>(mDataType));
 
-		if (input_data.empty())
+		for (float mean : mMean)
+			identity += "|m" + std::to_string(mean);
+		for (float std_dev : mStdDev)
+			identity += "|s" + std::to_string(std_dev);
+
+		return "tensor-" + HashUtils::ToHex(HashUtils::HashString(identity));
+	}
+
+	bool ImageTensorLoader::ReadCached(const std::string& cache_key, void* output) const
+	{
+		std::filesystem::path entry;
+		if (!mpCache->Lookup(cache_key, entry))
+			return false;
+
+		std::ifstream in(entry, std::ios::binary);
+
+		CachedTensorHeader header;
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		const CachedTensorHeader expected;
+		if (!in || 
+			std::memcmp(header.mMagic, expected.mMagic, sizeof(header.mMagic)) != 0 ||
+			header.mVersion != CachedTensorVersion ||
+			header.mDataType != static_cast<uint32_t>(mDataType) ||
+			header.mValueCount != GetImageSize())
 		{
-			std::cerr << "Failed to convert image data to tensor format." << std::endl;
 			return false;
 		}
 
+		// Straight into the destination, e.g., the image's slice of a batch
+		in.read(static_cast<char*>(output), static_cast<std::streamsize>(GetImageSize() * GetElementSize()));
+		return static_cast<bool>(in);
+	}
+
+	void ImageTensorLoader::WriteCached(const std::string& cache_key, const void* values) const
+	{
+		CachedTensorHeader header;
+		header.mDataType = static_cast<uint32_t>(mDataType);
+		header.mValueCount = GetImageSize();
+
+		const size_t value_bytes = GetImageSize() * GetElementSize();
+
+		std::vector<uint8_t> entry(sizeof(header) + value_bytes);
+		std::memcpy(entry.data(), &header, sizeof(header));
+		std::memcpy(entry.data() + sizeof(header), values, value_bytes);
+
+		mpCache->Write(cache_key, entry.data(), entry.size());
+	}
+
+	bool ImageTensorLoader::ConvertInto(const cv::Mat& image, void* output) const
+	{
+		// The kernel reads 8-bit pixels, deeper images are brought to 8-bit first
+		cv::Mat source = image;
+		if (image.depth() != CV_8U)
+			image.convertTo(source, CV_MAKETYPE(CV_8U, image.channels()), image.depth() == CV_16U ? 1.0 / 257.0 : 1.0);
+
+		ConversionPlan plan;
+		plan.mSrcChannels = source.channels();
+		plan.mDstChannels = static_cast<int>(mChannels);
+		plan.mWidth = static_cast<int>(mWidth);
+		plan.mHeight = static_cast<int>(mHeight);
+
+		if (!BuildChannelMap(plan.mSrcChannels, plan.mDstChannels, mChannelOrder != ChannelOrder::GrayScale, plan.mChannelWeights, plan.mChannelOffsets))
+			return false;
+
+		// Folds the [0, 1] scaling and the mean/std normalization into the channel map,
+		// unnormalized images keep their [0, 255] range
+		const float range_scale = mNormalize ? 1.0f / 255.0f : 1.0f;
+		for (int c = 0; c < plan.mDstChannels; ++c)
+		{
+			const float mean = mMean.empty() ? 0.0f : mMean[c];
+			const float std_dev = mStdDev.empty() ? 1.0f : mStdDev[c];
+			const float scale = range_scale / std_dev;
+
+			for (int s = 0; s < plan.mSrcChannels; ++s)
+				plan.mChannelWeights[c][s] *= scale;
+			plan.mChannelOffsets[c] = plan.mChannelOffsets[c] * scale - mean / std_dev;
+		}
+
+		ComputeTaps(source.cols, plan.mWidth, plan.mXLower, plan.mXUpper, plan.mXWeights);
+		ComputeTaps(source.rows, plan.mHeight, plan.mYLower, plan.mYUpper, plan.mYWeights);
+
 		switch (mShapeOrder)
 		{
-			case ShapeOrder::WidthHeightChannels:
-				output = cppflow::tensor(input_data, { 1, static_cast<int64_t>(mWidth), static_cast<int64_t>(mHeight), static_cast<int64_t>(mChannels) });
-				break;
 			case ShapeOrder::HeightWidthChannels:
-				output = cppflow::tensor(input_data, { 1, static_cast<int64_t>(mHeight), static_cast<int64_t>(mWidth), static_cast<int64_t>(mChannels) });
+				plan.mRowStride = static_cast<size_t>(plan.mWidth) * plan.mDstChannels;
+				plan.mColStride = plan.mDstChannels;
+				plan.mChannelStride = 1;
+				break;
+			case ShapeOrder::WidthHeightChannels:
+				plan.mRowStride = plan.mDstChannels;
+				plan.mColStride = static_cast<size_t>(plan.mHeight) * plan.mDstChannels;
+				plan.mChannelStride = 1;
 				break;
 			case ShapeOrder::ChannelsHeightWidth:
-				output = cppflow::tensor(input_data, { 1, static_cast<int64_t>(mChannels), static_cast<int64_t>(mHeight), static_cast<int64_t>(mWidth) });
+				plan.mRowStride = plan.mWidth;
+				plan.mColStride = 1;
+				plan.mChannelStride = static_cast<size_t>(plan.mWidth) * plan.mHeight;
 				break;
 			case ShapeOrder::ChannelsWidthHeight:
-				output = cppflow::tensor(input_data, { 1, static_cast<int64_t>(mChannels), static_cast<int64_t>(mWidth), static_cast<int64_t>(mHeight) });
+				plan.mRowStride = 1;
+				plan.mColStride = plan.mHeight;
+				plan.mChannelStride = static_cast<size_t>(plan.mWidth) * plan.mHeight;
 				break;
 			default:
-			{
-				std::cerr << "Invalid Shape Order." << std::endl;
+				std::cerr << "Unsupported Shape Order." << std::endl;
 				return false;
-			}
 		}
+
+		if (mDataType == DataType::UInt8)
+		{
+			// Raw bytes at the tensor size already in the tensor layout
+			plan.mIsCopy = source.cols == plan.mWidth &&
+						   source.rows == plan.mHeight &&
+						   plan.mSrcChannels == plan.mDstChannels &&
+						   mShapeOrder == ShapeOrder::HeightWidthChannels;
+
+			WritePixels(source, plan, static_cast<uint8_t*>(output));
+		}
+		else
+		{
+			WritePixels(source, plan, static_cast<float*>(output));
+		}
+
 		return true;
 	}
 }
\ No newline at end of file
@@ -1,15 +1,107 @@
 #include "Models/MLModel.h"
 
+#include "Core/TFColumnarData.h"
+
 #include "Utils/ConsoleUtils.h"
+#include "Utils/DiskCache.h"
+#include "Utils/HashUtils.h"
 
 #include "Interfaces/IPluginManager.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 
 #include <regex>
 #include <unordered_set>
+#include <thread>
 
 namespace TF
 {
+	// Python interpreter running the plugin scripts, launched directly without a shell
+	static constexpr const char* PythonExecutable = "python";
+
+	// Default maximum size of the shared model cache (8 GB)
+	static constexpr uint64_t DefaultModelCacheLimit = 8ull * 1024 * 1024 * 1024;
+
+	// File recording which cache key a SavedModel directory was produced from
+	static constexpr const char* CacheStampFilename = "forgeml_cache_key.txt";
+
+	static DiskCache& GetModelCache()
+	{
+		static DiskCache cache(TCHAR_TO_UTF8(*FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/ModelCache"))), 
+							   DefaultModelCacheLimit);
+		return cache;
+	}
+
+	static std::string ReadCacheStamp(const std::filesystem::path& model_path)
+	{
+		std::ifstream in(model_path / CacheStampFilename);
+		if (!in.is_open())
+			return "";
+
+		std::string key;
+		std::getline(in, key);
+		return key;
+	}
+
+	static void WriteCacheStamp(const std::filesystem::path& model_path, 
+								const std::string& key)
+	{
+		std::ofstream out(model_path / CacheStampFilename, std::ios::trunc);
+		out << key;
+	}
+
+	static bool CopyModelDirectory(const std::filesystem::path& source,
+								   const std::filesystem::path& destination)
+	{
+		std::error_code ec;
+		std::filesystem::remove_all(destination, ec);
+		std::filesystem::create_directories(destination.parent_path(), ec);
+		std::filesystem::copy(source, 
+							  destination, 
+							  std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, 
+							  ec);
+		if (ec)
+		{
+			std::cerr << "Failed to Copy Cached Model From " << source << " To " << destination << ": " << ec.message() << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	static bool AppendSupervisedRecord(TrainingLog& log,
+									   TrainingColumn&& input,
+									   TrainingColumn&& label)
+	{
+		if (input.IsString() || label.IsString())
+		{
+			std::cerr << "Training Log Only Supports Numeric Samples, Rejected '" << input.mName << "' / '" << label.mName << "'" << std::endl;
+			return false;
+		}
+
+		// Same column names as the binary training data
+		input.mName = "inputs/" + input.mName;
+		label.mName = "labels/" + label.mName;
+
+		std::vector<TrainingColumn> record;
+		record.push_back(std::move(input));
+		record.push_back(std::move(label));
+		return log.Append(std::move(record));
+	}
+
+	static void WriteSegmentList(const std::filesystem::path& filepath,
+								 const std::vector<std::filesystem::path>& segments)
+	{
+		nlohmann::json list;
+		list["segments"] = nlohmann::json::array();
+		for (const auto& segment : segments)
+			list["segments"].push_back(segment.string());
+
+		std::ofstream ofs(filepath);
+		if (!ofs)
+			throw std::runtime_error("Failed to open file for writing: " + filepath.string());
+
+		ofs << list.dump(4);
+	}
+
 	MLModel::MLModel(const std::string& modelname,
 					 const std::filesystem::path& output)
 		: mName(modelname),
@@ -30,16 +122,36 @@ namespace TF
 
 	MLModel::~MLModel()
 	{
+		std::shared_ptr<TrainingJob> job;
+		{
+			const std::scoped_lock lock(mTrainingJobMutex);
+			job = mpTrainingJob;
+		}
+
+		// The job references this model, it must finish before the model goes away
+		if (job)
+		{
+			job->Cancel();
+			job->Wait();
+		}
+
 		mpModel = nullptr;
 	}
 
 	bool MLModel::LoadFrom(const std::filesystem::path& loadpath,
 						   const std::filesystem::path& output)
 	{
+		if (!std::filesystem::exists(loadpath))
+		{
+			std::cerr << "Load Model Path Does Not Exist: " << loadpath << std::endl;
+			return false;
+		}
+
 		std::string output_path = loadpath.string();
 		mName = loadpath.stem().string();
 
-		if (loadpath.has_extension() && loadpath.extension() == ".onnx")
+		const bool is_onnx = loadpath.has_extension() && loadpath.extension() == ".onnx";
+		if (is_onnx)
 		{
 			if (output.empty())
 			{
@@ -68,25 +180,13 @@ namespace TF
 				return false;
 		}
 
-
 		const std::string model_path = CreateModelName();
-		if (!std::filesystem::exists(loadpath))
-		{
-			std::cerr << "Load Model Path Does Not Exist: " << loadpath << std::endl;
-			return false;
-		}
-
 
-		std::stringstream cmd;
-		cmd << "python \"" 
-			<< mScriptDirectory 
-			<< "/extract_model_info.py\""
-			<< " \"" << output_path << "\"";
-
-		if (ConsoleUtils::Execute(cmd.str().c_str()) < 0)
+		// Converted models carry their io names along with the cached conversion
+		if (!is_onnx || !std::filesystem::exists(output_path + "/cppflow_io_names.json"))
 		{
-			std::cerr << "Failed to Extract Info From SavedModel {" << output_path << "}" << std::endl;
-			return false;
+			if (!ExtractModelInfo(output_path))
+				return false;
 		}
 
 		// Load JSON with input/output tensor names
@@ -186,17 +286,8 @@ namespace TF
 		}
 
 
-		std::stringstream cmd;
-		cmd << "python \"" 
-			<< mScriptDirectory 
-			<< "/extract_model_info.py\""
-			<< " \"" << model_path << "\"";
-
-		if (ConsoleUtils::Execute(cmd.str().c_str()) < 0)
-		{
-			std::cerr << "Failed to Extract Info From SavedModel {" << model_path << "}" << std::endl;
+		if (!ExtractModelInfo(model_path))
 			return false;
-		}
 
 		// Load JSON with input/output tensor names
 		std::ifstream in(model_path + "/cppflow_io_names.json");
@@ -241,6 +332,21 @@ namespace TF
 		});
 	}
 
+	bool MLModel::GetInputType(const std::string& name,
+							   DataType& dtype) const
+	{
+		const auto found = std::find_if(mLayout.mInputs.begin(), mLayout.mInputs.end(), [&](const Input& input)
+		{
+			return input.mName == name;
+		});
+
+		if (found == mLayout.mInputs.end())
+			return false;
+
+		dtype = found->mType;
+		return true;
+	}
+
 	void MLModel::AddOutput(const std::string& name)
 	{
 		mLayout.mOutputs.push_back(
@@ -259,37 +365,205 @@ namespace TF
 		});
 	}
 
-	void MLModel::AddSupervisedTrainingData(const std::string& input_name, 
+	bool MLModel::AddSupervisedTrainingData(const std::string& input_name, 
 											const nlohmann::json& input_values,
 											const std::string& label_name,
 											const nlohmann::json& label_outputs)
 	{
-		const std::scoped_lock lock(mTrainingMutex);
+		TrainingColumn input{ input_name };
+		TrainingColumn label{ label_name };
+		if (!input.AppendRow(input_values) || !label.AppendRow(label_outputs))
+			return false;
 
-		NamedInput input;
-		input.mName = input_name;
-		input.mData = input_values;
+		if (!ValidateTrainingInput(input_name, input.mWidth, input.IsString()))
+			return false;
 
-		NamedLabel label;
-		label.mName = label_name;
-		label.mData = label_outputs;
+		if (mpSupervisedTrainingLog)
+			return AppendSupervisedRecord(*mpSupervisedTrainingLog, std::move(input), std::move(label));
 
-		mSupervisedTrainingBatch.mInputs.push_back(input);
-		mSupervisedTrainingBatch.mLabels.push_back(label);
+		return mTrainingShards.ForLocalShard([&](LabeledTrainingBatch& supervised_batch, RewardTrainingBatch&)
+		{
+			TrainingColumn& input_column = supervised_batch.GetInput(input_name);
+			TrainingColumn& label_column = supervised_batch.GetLabel(label_name);
+
+			// Check both columns before appending so a rejected sample leaves them aligned
+			if ((input_column.mRows > 0 && (input_column.IsString() != input.IsString() || input_column.mWidth != input.mWidth)) ||
+				(label_column.mRows > 0 && (label_column.IsString() != label.IsString() || label_column.mWidth != label.mWidth)))
+			{
+				std::cerr << "Training Sample Does Not Match Previous Samples Of '" << input_name << "' / '" << label_name << "'" << std::endl;
+				return false;
+			}
+
+			input_column.Append(std::move(input));
+			label_column.Append(std::move(label));
+			return true;
+		});
+	}
+
+	bool MLModel::AddSupervisedTrainingRow(const std::string& input_name, 
+										   std::span<const float> input_values,
+										   const std::string& label_name,
+										   std::span<const float> label_outputs)
+	{
+		if (!ValidateTrainingInput(input_name, input_values.size(), false))
+			return false;
+
+		if (mpSupervisedTrainingLog)
+		{
+			TrainingColumn input{ input_name };
+			TrainingColumn label{ label_name };
+			input.AppendRow(input_values);
+			label.AppendRow(label_outputs);
+
+			return AppendSupervisedRecord(*mpSupervisedTrainingLog, std::move(input), std::move(label));
+		}
+
+		return mTrainingShards.ForLocalShard([&](LabeledTrainingBatch& supervised_batch, RewardTrainingBatch&)
+		{
+			TrainingColumn& input_column = supervised_batch.GetInput(input_name);
+			TrainingColumn& label_column = supervised_batch.GetLabel(label_name);
+
+			// Check both columns before appending so a rejected sample leaves them aligned
+			if ((input_column.mRows > 0 && (input_column.IsString() || input_column.mWidth != input_values.size())) ||
+				(label_column.mRows > 0 && (label_column.IsString() || label_column.mWidth != label_outputs.size())))
+			{
+				std::cerr << "Training Sample Does Not Match Previous Samples Of '" << input_name << "' / '" << label_name << "'" << std::endl;
+				return false;
+			}
+
+			return input_column.AppendRow(input_values) && label_column.AppendRow(label_outputs);
+		});
+	}
+
+	bool MLModel::AddImageDataset(const std::string& input_name,
+								  const ImageFolderDataset& dataset,
+								  const std::string& label_name)
+	{
+		if (dataset.GetSize() == 0)
+		{
+			std::cerr << "Image Dataset For '" << input_name << "' Is Empty." << std::endl;
+			return false;
+		}
+
+		if (!ValidateTrainingInput(input_name, 0, true))
+			return false;
+
+		// The one-hot labels must match the label output rather than the classes present in the dataset
+		uint32_t label_width = 0;
+		if (!ResolveOutputWidth(label_name, label_width))
+			return false;
+
+		if (label_width == 0)
+		{
+			label_width = dataset.GetClassCount();
+		}
+		else if (dataset.GetClassCount() > label_width)
+		{
+			std::cerr << "Image Dataset For '" << input_name << "' Has " << dataset.GetClassCount() << " Classes, Output '" 
+					  << label_name << "' Only Has " << label_width << " Values." << std::endl;
+			return false;
+		}
+
+		const std::scoped_lock lock(mTrainingMutex);
+		mImageDatasets.push_back({ input_name, label_name, dataset, label_width });
+		return true;
 	}
 
 	void MLModel::AddRewardData(const nlohmann::json& state_values,
 								const nlohmann::json& action_values, 
-								float reward)
+								float reward,
+								const nlohmann::json& next_state_values,
+								bool done)
 	{
-		const std::scoped_lock lock(mTrainingMutex);
+		const bool has_next = !next_state_values.is_null();
+
+		if (mpReplayBuffer || mpRewardTrainingLog)
+		{
+			TrainingColumn states{ "state" };
+			TrainingColumn actions{ "action" };
+			TrainingColumn next_states{ "next_state" };
+			if (!states.AppendRow(state_values) || 
+				!actions.AppendRow(action_values) || 
+				(has_next && !next_states.AppendRow(next_state_values)))
+			{
+				return;
+			}
+
+			// Without a next state the reward alone is the target, as at the end of an episode
+			if (!has_next)
+				next_states.AppendRow(std::span<const float>(std::vector<float>(states.mWidth, 0.0f)));
+
+			if (mpReplayBuffer)
+			{
+				mpReplayBuffer->Add(states.mValues, actions.mValues, reward, next_states.mValues, done || !has_next);
+				return;
+			}
+
+			const float flags[2] = { has_next ? 1.0f : 0.0f, done ? 1.0f : 0.0f };
+
+			TrainingColumn rewards{ "reward" };
+			TrainingColumn has_nexts{ "has_next" };
+			TrainingColumn dones{ "done" };
+			rewards.AppendRow(std::span<const float>(&reward, 1));
+			has_nexts.AppendRow(std::span<const float>(&flags[0], 1));
+			dones.AppendRow(std::span<const float>(&flags[1], 1));
+
+			std::vector<TrainingColumn> record;
+			record.push_back(std::move(states));
+			record.push_back(std::move(actions));
+			record.push_back(std::move(rewards));
+			record.push_back(std::move(next_states));
+			record.push_back(std::move(has_nexts));
+			record.push_back(std::move(dones));
+			mpRewardTrainingLog->Append(std::move(record));
+			return;
+		}
 
 		RewardData sample;
 		sample.mState = state_values;
 		sample.mAction = action_values;
 		sample.mReward = reward;
+		sample.mNextState = next_state_values;
+		sample.mDone = done;
 
-		mRewardTrainingBatch.mSamples.push_back(sample);
+		mTrainingShards.ForLocalShard([&](LabeledTrainingBatch&, RewardTrainingBatch& reward_batch)
+		{
+			reward_batch.mSamples.push_back(std::move(sample));
+		});
+	}
+
+	uint64_t MLModel::GetSupervisedSampleCount() const
+	{
+		const std::scoped_lock lock(mTrainingMutex);
+
+		uint64_t dataset_count = 0;
+		for (const ImageDatasetSource& source : mImageDatasets)
+			dataset_count += source.mDataset.GetSize();
+
+		return mSupervisedTrainingBatch.GetRowCount() + mTrainingShards.GetSupervisedCount() + dataset_count;
+	}
+
+	uint64_t MLModel::GetRewardSampleCount() const
+	{
+		const std::scoped_lock lock(mTrainingMutex);
+		return mRewardTrainingBatch.mSamples.size() + mTrainingShards.GetRewardCount();
+	}
+
+	void MLModel::EnableReplayBuffer(uint32_t capacity,
+									 bool prioritized,
+									 float alpha,
+									 float beta)
+	{
+		mpReplayBuffer = std::make_unique<ReplayBuffer>(capacity, prioritized, alpha, beta);
+	}
+
+	void MLModel::EnableTrainingLog(uint64_t max_in_flight_bytes,
+									uint64_t segment_bytes)
+	{
+		const std::string model_path_root = GetModelRoot();
+
+		mpSupervisedTrainingLog = std::make_unique<TrainingLog>(model_path_root + "/train/s-train_log", max_in_flight_bytes, segment_bytes);
+		mpRewardTrainingLog = std::make_unique<TrainingLog>(model_path_root + "/train/r-train_log", max_in_flight_bytes, segment_bytes);
 	}
 
 	void MLModel::SaveLayoutJson(const std::filesystem::path& path) const
@@ -299,7 +573,11 @@ namespace TF
 
 	void MLModel::SaveTrainingJson(const std::filesystem::path& path) const
 	{
-		mSupervisedTrainingBatch.WriteToFile(path);
+		LabeledTrainingBatch supervised_batch;
+		RewardTrainingBatch reward_batch;
+		CopyTrainingData(supervised_batch, reward_batch);
+
+		supervised_batch.WriteToFile(path);
 	}
 
 	bool MLModel::CreateModel()
@@ -312,24 +590,44 @@ namespace TF
 		const std::string model_description_path = model_path_root + "/model_description.json";
 		mLayout.WriteToFile(model_description_path);
 
-		// Run the Python script to create the model
-		std::stringstream python_script;
-		python_script << "python \"" 
-					  << mScriptDirectory 
-					  << "/build_model_from_json.py\"" 
-					  << " \"" << model_path_root << "\""
-					  << " \"0\"";
+		mModelVersion = 0;
 
-		std::string output;
-		if (ConsoleUtils::Execute(python_script.str().c_str(), &output) < 0)
+		const std::string build_script_path = mScriptDirectory + "/build_model_from_json.py";
+
+		// Key on the layout and the builder itself, so builder changes invalidate old entries
+		const std::string cache_key = "layout-" + HashUtils::ToHex(HashUtils::HashString(HashUtils::ToHex(mLayout.Hash()), 
+																						 HashUtils::HashFile(build_script_path)));
+
+		const std::string base_model_path = CreateModelName();
+		if (ReadCacheStamp(base_model_path) != cache_key)
 		{
-			std::cerr << "Failed Model Creation {" << mName << "}: \n\t" << output << std::endl;
-			return false;
-		}
+			DiskCache& cache = GetModelCache();
 
-		mModelVersion = 0;
+			std::filesystem::path cached_path;
+			if (!cache.Lookup(cache_key, cached_path) || !CopyModelDirectory(cached_path, base_model_path))
+			{
+				// Run the Python script to create the model
+				const std::vector<std::string> build_cmd = 
+				{ 
+					PythonExecutable, "-u", 
+					build_script_path, 
+					model_path_root, 
+					"0" 
+				};
+
+				std::string output;
+				if (ConsoleUtils::Execute(build_cmd, &output) != 0)
+				{
+					std::cerr << "Failed Model Creation {" << mName << "}: \n\t" << output << std::endl;
+					return false;
+				}
 
-		UE_LOG(LogTemp, Log, TEXT("%s"), *FString(output.c_str()));
+				UE_LOG(LogTemp, Log, TEXT("%s"), *FString(output.c_str()));
+
+				WriteCacheStamp(base_model_path, cache_key);
+				cache.Insert(cache_key, base_model_path);
+			}
+		}
 
 		// Load JSON with input/output tensor names
 		const std::string model_path = CreateModelName();
@@ -370,13 +668,6 @@ namespace TF
 							 float validation_split,
 							 bool clean_data)
 	{
-		const std::scoped_lock lock(mTrainingMutex);
-
-		const bool hasSupervised = mSupervisedTrainingBatch;
-		const bool hasReward = mRewardTrainingBatch;
-		if (!hasSupervised && !hasReward)
-			return false;
-		
 		TF::TrainingConfig config;
 		config.epochs			= epochs;
 		config.batch_size		= batchSize;
@@ -385,49 +676,406 @@ namespace TF
 		config.shuffle			= shuffle;
 		config.validation_split = validation_split;
 
+		return TrainModel(config, clean_data);
+	}
+
+	bool MLModel::TrainModel(const TrainingConfig& config,
+							 bool clean_data)
+	{
+		std::shared_ptr<TrainingJob> job = TrainModelAsync(config, nullptr, clean_data);
+		if (!job)
+			return false;
+
+		return job->Wait();
+	}
+
+	bool MLModel::HasTrainingCheckpoint() const
+	{
+		std::ifstream ifs(GetModelRoot() + "/train/checkpoints/state.json");
+		if (!ifs)
+			return false;
+
+		const nlohmann::json state = nlohmann::json::parse(ifs, nullptr, false);
+		if (state.is_discarded() || !state.contains("input_version"))
+			return false;
+
+		// Checkpoints continue the run that started from this version only
+		return state["input_version"].get<uint32_t>() == mModelVersion.load();
+	}
+
+	std::shared_ptr<TrainingJob> MLModel::TrainModelAsync(const TrainingConfig& config,
+														  TrainingJob::MetricsCallback on_metrics,
+														  bool clean_data)
+	{
+		const std::scoped_lock job_lock(mTrainingJobMutex);
+		if (mpTrainingJob && mpTrainingJob->IsRunning())
+		{
+			std::cerr << "Training Already In Progress On {" << mName << "}" << std::endl;
+			return nullptr;
+		}
+
+		{
+			const bool hasSupervised = GetSupervisedSampleCount() > 0 || (mpSupervisedTrainingLog && mpSupervisedTrainingLog->HasData());
+			const bool hasReward = GetRewardSampleCount() > 0 || 
+								   (mpRewardTrainingLog && mpRewardTrainingLog->HasData()) || 
+								   (mpReplayBuffer && mpReplayBuffer->GetSize() > 0);
+			if (!hasSupervised && !hasReward)
+				return nullptr;
+		}
+
+		auto job = std::make_shared<TrainingJob>(std::move(on_metrics));
+		mpTrainingJob = job;
+
+		std::thread([this, job, config, clean_data]()
+		{
+			TrainingJobState state = TrainingJobState::Failed;
+			try
+			{
+				state = RunTraining(*job, config, clean_data);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Training Failed On {" << mName << "}: " << e.what() << std::endl;
+			}
+			job->Complete(state);
+		}).detach();
+
+		return job;
+	}
+
+	void MLModel::CopyTrainingData(LabeledTrainingBatch& supervised_batch,
+								   RewardTrainingBatch& reward_batch) const
+	{
+		const std::scoped_lock lock(mTrainingMutex);
+
+		LabeledTrainingBatch supervised_copy = mSupervisedTrainingBatch;
+		RewardTrainingBatch reward_copy = mRewardTrainingBatch;
+		supervised_batch.Append(std::move(supervised_copy));
+		reward_batch.Append(std::move(reward_copy));
+
+		mTrainingShards.CopyAll(supervised_batch, reward_batch);
+	}
+
+	bool MLModel::ValidateTrainingInput(const std::string& input_name,
+										size_t input_width,
+										bool is_path) const
+	{
+		// Loaded models carry no layout to validate against
+		if (mLayout.mInputs.empty())
+			return true;
+
+		const auto found = std::find_if(mLayout.mInputs.begin(), mLayout.mInputs.end(), [&](const Input& input)
+		{
+			return input.mName == input_name;
+		});
+
+		if (found == mLayout.mInputs.end())
+		{
+			std::cerr << "Training Input '" << input_name << "' Not Found In Model Layout." << std::endl;
+			return false;
+		}
+
+		if (found->mDomain == DomainType::Image)
+		{
+			if (!is_path)
+			{
+				std::cerr << "Training Input '" << input_name << "' Expects An Image Path." << std::endl;
+				return false;
+			}
+			return true;
+		}
+
+		// The first dimension is the batch, the remaining ones make up a single sample
+		size_t expected_width = 1;
+		for (size_t i = 1; i < found->mShape.size(); ++i)
+		{
+			// Dynamic dimensions cannot be checked
+			if (found->mShape[i] < 0)
+				return true;
+
+			expected_width *= static_cast<size_t>(found->mShape[i]);
+		}
+
+		if (is_path || input_width != expected_width)
+		{
+			std::cerr << "Training Input '" << input_name << "' Shape Mismatch. Expected: " << expected_width << " Values, Got: " << input_width << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool MLModel::ResolveOutputWidth(const std::string& output_name,
+									 uint32_t& width) const
+	{
+		width = 0;
+
+		// Loaded models carry no layout to resolve the width from
+		if (mLayout.mInputs.empty())
+			return true;
+
+		const bool is_output = std::any_of(mLayout.mOutputs.begin(), mLayout.mOutputs.end(), [&](const Output& output)
+		{
+			return output.mName == output_name;
+		});
+
+		if (!is_output)
+		{
+			std::cerr << "Training Label '" << output_name << "' Not Found In Model Layout." << std::endl;
+			return false;
+		}
+
+		// Layers keeping the shape of their input are followed back to the layer setting the width
+		std::string name = output_name;
+		for (size_t depth = 0; depth < mLayout.mLayers.size(); ++depth)
+		{
+			const auto found = std::find_if(mLayout.mLayers.begin(), mLayout.mLayers.end(), [&](const Layer& layer)
+			{
+				const auto param = layer.mParameters.find("output_name");
+				return param != layer.mParameters.end() && param->second == name;
+			});
+
+			if (found == mLayout.mLayers.end())
+				break;
+
+			if (found->mType == LayerType::Dense)
+			{
+				const auto units = found->mParameters.find("units");
+				if (units == found->mParameters.end() || !units->second.is_number_integer() || units->second.get<int64_t>() <= 0)
+					break;
+
+				width = units->second.get<uint32_t>();
+				return true;
+			}
+
+			const auto input = found->mParameters.find("input_name");
+			if ((found->mType != LayerType::Activation && found->mType != LayerType::Dropout && found->mType != LayerType::BatchNormalization) ||
+				input == found->mParameters.end() || !input->second.is_string())
+			{
+				break;
+			}
+
+			name = input->second.get<std::string>();
+		}
+
+		std::cerr << "Width Of Output '" << output_name << "' Cannot Be Resolved From The Model Layout." << std::endl;
+		return false;
+	}
+
+	TrainingJobState MLModel::RunTraining(TrainingJob& job,
+										  const TrainingConfig& config,
+										  bool clean_data)
+	{
+		// Freeze the collected samples for this run, new samples go into fresh buffers meanwhile
+		TrainingSnapshot snapshot;
+		{
+			const std::scoped_lock lock(mTrainingMutex);
+			std::swap(snapshot.mSupervisedBatch, mSupervisedTrainingBatch);
+			std::swap(snapshot.mRewardBatch, mRewardTrainingBatch);
+			std::swap(snapshot.mImageDatasets, mImageDatasets);
+
+			// The shards are merged only here, producers never wait on each other
+			mTrainingShards.TakeAll(snapshot.mSupervisedBatch, snapshot.mRewardBatch);
+		}
+
+		// Logged samples are consumed from the sealed segments, samples logged during the run go into new ones
+		if (mpSupervisedTrainingLog)
+			snapshot.mSupervisedSegments = mpSupervisedTrainingLog->Seal();
+		if (mpRewardTrainingLog)
+			snapshot.mRewardSegments = mpRewardTrainingLog->Seal();
+
+		// Only the drawn minibatches are handed over, the replay buffer itself stays in memory
+		if (mpReplayBuffer)
+			mpReplayBuffer->Sample(config.replay_batches * config.batch_size, snapshot.mReplayBatch);
+
+		const bool hasSupervised = snapshot.mSupervisedBatch || !snapshot.mSupervisedSegments.empty() || !snapshot.mImageDatasets.empty();
+		const bool hasReward = snapshot.mRewardBatch || !snapshot.mRewardSegments.empty() || snapshot.mReplayBatch;
+		if (!hasSupervised && !hasReward)
+			return TrainingJobState::Failed;
+
+		// Puts the frozen samples back in front of the ones collected during the run
+		const auto RestoreTrainingData = [&]()
+		{
+			const std::scoped_lock lock(mTrainingMutex);
+
+			// Rows that no longer match the frozen columns stay in the live batch instead of vanishing
+			if (snapshot.mSupervisedBatch.Append(std::move(mSupervisedTrainingBatch)))
+				std::swap(snapshot.mSupervisedBatch, mSupervisedTrainingBatch);
+			else
+				std::cerr << "Frozen Supervised Samples Of {" << mName << "} Could Not Be Restored" << std::endl;
+
+			snapshot.mRewardBatch.Append(std::move(mRewardTrainingBatch));
+			std::swap(snapshot.mRewardBatch, mRewardTrainingBatch);
+
+			mImageDatasets.insert(mImageDatasets.begin(), 
+								  std::make_move_iterator(snapshot.mImageDatasets.begin()), 
+								  std::make_move_iterator(snapshot.mImageDatasets.end()));
+		};
+
+		// A failure to write the trainer inputs or load the trained model must not lose the frozen samples
+		TrainingJobState state = TrainingJobState::Failed;
+		try
+		{
+			state = ExecuteTraining(job, config, snapshot);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Training Failed On {" << mName << "}: " << e.what() << std::endl;
+		}
+
+		if (state != TrainingJobState::Succeeded || !clean_data)
+		{
+			RestoreTrainingData();
+		}
+		else
+		{
+			// Unconsumed segments simply stay on disk for the next run
+			if (mpSupervisedTrainingLog)
+				mpSupervisedTrainingLog->Remove(snapshot.mSupervisedSegments);
+			if (mpRewardTrainingLog)
+				mpRewardTrainingLog->Remove(snapshot.mRewardSegments);
+		}
+
+		return state;
+	}
+
+	TrainingJobState MLModel::ExecuteTraining(TrainingJob& job,
+											  const TrainingConfig& config,
+											  const TrainingSnapshot& snapshot)
+	{
+		if (snapshot.mSupervisedBatch && !snapshot.mSupervisedBatch.HasConsistentRows())
+		{
+			std::cerr << "Supervised Training Columns Of {" << mName << "} Have Mismatching Row Counts" << std::endl;
+			return TrainingJobState::Failed;
+		}
+
 		const std::string model_path_root = GetModelRoot();
 		config.WriteToFile(model_path_root + "/train/train_config.json");
 
+		// Remove data of previous runs so the trainer only sees this run's samples
+		std::error_code ec;
+		std::filesystem::remove(model_path_root + "/train/s-train_data.json", ec);
+		std::filesystem::remove(model_path_root + "/train/r-train_data.json", ec);
+		std::filesystem::remove_all(model_path_root + "/train/s-train_data", ec);
+		std::filesystem::remove_all(model_path_root + "/train/r-train_data", ec);
+		std::filesystem::remove(model_path_root + "/train/s-train_log.json", ec);
+		std::filesystem::remove(model_path_root + "/train/r-train_log.json", ec);
+		std::filesystem::remove_all(model_path_root + "/train/r-replay", ec);
+		std::filesystem::remove_all(model_path_root + "/train/s-image_data", ec);
+
+		const bool write_json = config.data_format == "json";
+
+		// Segments must stay alive until the trainer exits, only their descriptors are written to disk
+		const bool use_shared_memory = config.data_transport == "shared_memory";
+		SharedMemory supervised_memory;
+		SharedMemory reward_memory;
+
+		if (snapshot.mSupervisedBatch)
+		{
+			if (write_json)
+				snapshot.mSupervisedBatch.WriteToFile(model_path_root + "/train/s-train_data.json");
+			else
+				snapshot.mSupervisedBatch.WriteToDirectory(model_path_root + "/train/s-train_data", use_shared_memory ? &supervised_memory : nullptr);
+		}
 
-		if (mSupervisedTrainingBatch)
-			mSupervisedTrainingBatch.WriteToFile(model_path_root + "/train/s-train_data.json");
+		if (snapshot.mRewardBatch)
+		{
+			if (write_json)
+				snapshot.mRewardBatch.WriteToFile(model_path_root + "/train/r-train_data.json");
+			else
+				snapshot.mRewardBatch.WriteToDirectory(model_path_root + "/train/r-train_data", use_shared_memory ? &reward_memory : nullptr);
+		}
 
-		if (mRewardTrainingBatch)
-			mRewardTrainingBatch.WriteToFile(model_path_root + "/train/r-train_data.json");
+		if (!snapshot.mSupervisedSegments.empty())
+			WriteSegmentList(model_path_root + "/train/s-train_log.json", snapshot.mSupervisedSegments);
 
+		if (!snapshot.mRewardSegments.empty())
+			WriteSegmentList(model_path_root + "/train/r-train_log.json", snapshot.mRewardSegments);
 
-		std::stringstream trainCmd;
-		trainCmd << "python \"" 
-				 << mScriptDirectory 
-				 << "/train_model_from_json.py\""
-				 << " \"" << model_path_root << "\""
-				 << " \"" << mModelVersion.load() << "\""
-				 << " \"" << mModelVersion.load() + 1 << "\"";
+		if (snapshot.mReplayBatch)
+			snapshot.mReplayBatch.WriteToDirectory(model_path_root + "/train/r-replay");
 
-		std::string output;
-		if (ConsoleUtils::Execute(trainCmd.str().c_str(), &output) < 0)
+		if (!snapshot.mImageDatasets.empty())
 		{
-			std::cerr << "Failed Execute Training On {" << mName << "}: \n\t" << output << std::endl;
-			return false;
+			// Only the compact indices are handed over, the trainer resolves the paths and one-hot labels
+			const std::filesystem::path dataset_directory = model_path_root + "/train/s-image_data";
+
+			nlohmann::json manifest;
+			manifest["datasets"] = nlohmann::json::array();
+			for (size_t i = 0; i < snapshot.mImageDatasets.size(); ++i)
+			{
+				const ImageDatasetSource& source = snapshot.mImageDatasets[i];
+				const std::string index_name = std::to_string(i) + ".index";
+				if (!source.mDataset.WriteIndex(dataset_directory / index_name))
+					return TrainingJobState::Failed;
+
+				manifest["datasets"].push_back(
+				{
+					{ "input", source.mInputName },
+					{ "label", source.mLabelName },
+					{ "root", source.mDataset.GetRoot().generic_string() },
+					{ "index", index_name },
+					{ "label_width", source.mLabelWidth }
+				});
+			}
+
+			std::ofstream ofs(dataset_directory / "manifest.json");
+			if (!ofs)
+				throw std::runtime_error("Failed to open file for writing: " + (dataset_directory / "manifest.json").string());
+
+			ofs << manifest.dump(4);
 		}
 
-		UE_LOG(LogTemp, Log, TEXT("%s"), *FString(output.c_str()));
+		if (job.IsCancelRequested())
+			return TrainingJobState::Cancelled;
 
-		// Update Model
+		const std::vector<std::string> train_cmd = 
+		{ 
+			PythonExecutable, "-u", 
+			mScriptDirectory + "/train_model_from_json.py", 
+			model_path_root, 
+			std::to_string(mModelVersion.load()), 
+			std::to_string(mModelVersion.load() + 1) 
+		};
+
+		std::shared_ptr<ConsoleUtils::ProcessHandle> process = ConsoleUtils::ExecuteAsync(train_cmd, [&job](const std::string& line, bool is_error)
 		{
-			const std::scoped_lock model_lock(mModelMutex);
+			job.OnOutputLine(line, is_error);
+		});
+		job.AttachProcess(process);
+
+		const ConsoleUtils::ProcessResult result = process->Wait();
 
-			const std::string output_path = CreateModelName(++mModelVersion);
-			mpModel = std::make_unique<cppflow::model>(output_path);
+		const std::string output = job.GetOutput();
+		if (result.mCancelled)
+		{
+			std::cerr << "Training Cancelled On {" << mName << "}" << std::endl;
+			return TrainingJobState::Cancelled;
 		}
 
-		if (clean_data)
+		if (result.mExitCode != 0)
 		{
-			mSupervisedTrainingBatch.Clear();
-			mRewardTrainingBatch.Clear();
+			std::cerr << "Failed Execute Training On {" << mName << "}: \n\t" << output << std::endl;
+			return TrainingJobState::Failed;
 		}
 
-		return true;
+		UE_LOG(LogTemp, Log, TEXT("%s"), *FString(output.c_str()));
+
+		// The trainer reports the TD errors of the drawn transitions to re-prioritize them
+		std::vector<float> td_errors;
+		if (snapshot.mReplayBatch && ColumnarData::ReadNpyFile(model_path_root + "/train/r-replay/td_errors.npy", td_errors))
+			mpReplayBuffer->UpdatePriorities(snapshot.mReplayBatch, td_errors);
+
+		// Update Model, the version is only promoted once the trained model has loaded
+		{
+			const uint32_t version = mModelVersion + 1;
+			auto model = std::make_unique<cppflow::model>(CreateModelName(static_cast<int32_t>(version)));
+
+			const std::scoped_lock model_lock(mModelMutex);
+			mpModel = std::move(model);
+			mModelVersion = version;
+		}
+
+		return TrainingJobState::Succeeded;
 	}
 
 	bool MLModel::Run(const LabeledTensor& input_tensors,
@@ -484,33 +1132,81 @@ namespace TF
 
 		mLayout.WriteToFile(dir_path / "model_layout.json");
 
-		if (mSupervisedTrainingBatch)
-			mSupervisedTrainingBatch.WriteToFile(dir_path / "s-train_data.json");
-		if (mRewardTrainingBatch)
-			mRewardTrainingBatch.WriteToFile(dir_path / "r-train_data.json");
+		LabeledTrainingBatch supervised_batch;
+		RewardTrainingBatch reward_batch;
+		CopyTrainingData(supervised_batch, reward_batch);
+
+		if (supervised_batch)
+			supervised_batch.WriteToFile(dir_path / "s-train_data.json");
+		if (reward_batch)
+			reward_batch.WriteToFile(dir_path / "r-train_data.json");
 
 		std::cout << "Model and Training Data Exported to: " << dir_path << std::endl;
 	}
 
+	void MLModel::SetModelCacheLimit(uint64_t max_bytes)
+	{
+		GetModelCache().SetSizeLimit(max_bytes);
+	}
+
 	bool MLModel::ConvertModelToSavedModel(const std::filesystem::path& filepath,
 										   const std::filesystem::path& outputpath)
 	{
-		std::stringstream cmd;
-		cmd << "python \"" 
-			<< mScriptDirectory 
-			<< "/convert_onnx_to_saved_model.py\""
-		    << " \"" << filepath.string() << "\""
-		    << " \"" << outputpath.string() << "\"";
+		const std::filesystem::path script_path = mScriptDirectory + "/convert_onnx_to_saved_model.py";
+
+		// Key on the model content and the converter itself, so converter changes invalidate old entries
+		const std::string cache_key = "onnx-" + HashUtils::ToHex(HashUtils::HashFile(filepath, HashUtils::HashFile(script_path)));
+
+		if (ReadCacheStamp(outputpath) == cache_key)
+			return true;
 
-		int32_t exit_code = std::system(cmd.str().c_str());
+		DiskCache& cache = GetModelCache();
+
+		std::filesystem::path cached_path;
+		if (cache.Lookup(cache_key, cached_path) && CopyModelDirectory(cached_path, outputpath))
+			return true;
+
+		const std::vector<std::string> convert_cmd = 
+		{ 
+			PythonExecutable, "-u", 
+			script_path.string(), 
+			filepath.string(), 
+			outputpath.string() 
+		};
+
+		std::string output;
+		int32_t exit_code = ConsoleUtils::Execute(convert_cmd, &output);
 		if (exit_code != 0)
 		{
-			std::cerr << "Failed to convert model to SavedModel format. Exit code: " << exit_code << std::endl;
+			std::cerr << "Failed to convert model to SavedModel format. Exit code: " << exit_code << "\n\t" << output << std::endl;
 			return false;
 		}
+
+		if (!ExtractModelInfo(outputpath))
+			return false;
+
+		WriteCacheStamp(outputpath, cache_key);
+		cache.Insert(cache_key, outputpath);
 		return true;	
 	}
 
+	bool MLModel::ExtractModelInfo(const std::filesystem::path& model_path)
+	{
+		const std::vector<std::string> extract_cmd = 
+		{ 
+			PythonExecutable, "-u", 
+			mScriptDirectory + "/extract_model_info.py", 
+			model_path.string() 
+		};
+
+		if (ConsoleUtils::Execute(extract_cmd) != 0)
+		{
+			std::cerr << "Failed to Extract Info From SavedModel {" << model_path << "}" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
 	std::string MLModel::GetModelRoot() const
 	{
 		return mOutputDirectory + "/" + mName;
@@ -0,0 +1,464 @@
+#include "Models/TiledInference.h"
+
+#include "Models/MLModel.h"
+#include "Utils/ThreadPool.h"
+#include "Utils/HashUtils.h"
+
+#include "OpenCVLib.h"
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+namespace TF
+{
+	/// <summary>
+	/// Computes the tile origins along an axis, the last tile is aligned to the end of the axis.
+	/// </summary>
+	/// <param name="length">The length of the axis in pixels</param>
+	/// <param name="tile">The tile length, at most the axis length</param>
+	/// <param name="stride">The distance between tiles</param>
+	/// <returns>The tile origins</returns>
+	static std::vector<uint32_t> ComputeOrigins(uint32_t length,
+												uint32_t tile,
+												uint32_t stride)
+	{
+		std::vector<uint32_t> origins;
+		for (uint32_t origin = 0; origin + tile < length; origin += stride)
+			origins.push_back(origin);
+
+		origins.push_back(length - tile);
+		return origins;
+	}
+
+	/// <summary>
+	/// Hashes the pixels of a tile row by row.
+	/// </summary>
+	/// <param name="pixels">The first pixel of the tile</param>
+	/// <param name="width">The width of the tile in pixels</param>
+	/// <param name="height">The height of the tile in pixels</param>
+	/// <param name="channels">The number of channels per pixel</param>
+	/// <param name="stride">The number of bytes between rows</param>
+	/// <returns>The tile key</returns>
+	static uint64_t HashTile(const uint8_t* pixels,
+							 uint32_t width,
+							 uint32_t height,
+							 uint32_t channels,
+							 size_t stride)
+	{
+		const uint32_t dims[3] = { width, height, channels };
+		uint64_t hash = HashUtils::Hash(dims, sizeof(dims));
+
+		const size_t row_bytes = static_cast<size_t>(width) * channels;
+		for (uint32_t y = 0; y < height; ++y)
+			hash = HashUtils::Hash(pixels + y * stride, row_bytes, hash);
+
+		return hash;
+	}
+
+	/// <summary>
+	/// Extracts the height, width and channels of a single tile output in the given layout.
+	/// </summary>
+	/// <param name="shape">The output shape without the batch dimension</param>
+	/// <param name="order">The layout of the output</param>
+	/// <param name="height">The output height</param>
+	/// <param name="width">The output width</param>
+	/// <param name="channels">The output channels</param>
+	/// <returns>True if the output has spatial dimensions</returns>
+	static bool GetSpatialDims(const std::vector<int64_t>& shape,
+							   ShapeOrder order,
+							   int64_t& height,
+							   int64_t& width,
+							   int64_t& channels)
+	{
+		// Maps without a channel dimension have a single channel
+		std::vector<int64_t> dims = shape;
+		if (dims.size() == 2)
+		{
+			const bool channels_first = order == ShapeOrder::ChannelsHeightWidth || order == ShapeOrder::ChannelsWidthHeight;
+			dims.insert(channels_first ? dims.begin() : dims.end(), 1);
+		}
+
+		if (dims.size() != 3)
+			return false;
+
+		switch (order)
+		{
+			case ShapeOrder::WidthHeightChannels:
+				width = dims[0]; height = dims[1]; channels = dims[2];
+				break;
+			case ShapeOrder::HeightWidthChannels:
+				height = dims[0]; width = dims[1]; channels = dims[2];
+				break;
+			case ShapeOrder::ChannelsHeightWidth:
+				channels = dims[0]; height = dims[1]; width = dims[2];
+				break;
+			case ShapeOrder::ChannelsWidthHeight:
+			default:
+				channels = dims[0]; width = dims[1]; height = dims[2];
+				break;
+		}
+		return height > 1 && width > 1 && channels > 0;
+	}
+
+	TiledInference::TiledInference(MLModel& model,
+								   const ImageTensorLoader& loader,
+								   const TiledInferenceConfig& config)
+		: mModel(model),
+		mLoader(loader),
+		mConfig(config)
+	{
+		if (mConfig.mTileWidth == 0 || mConfig.mTileHeight == 0)
+			throw std::invalid_argument("Tile Size Must Be Greater Than Zero.");
+
+		if (mConfig.mStrideX == 0)
+			mConfig.mStrideX = mConfig.mTileWidth;
+		if (mConfig.mStrideY == 0)
+			mConfig.mStrideY = mConfig.mTileHeight;
+
+		if (mConfig.mStrideX > mConfig.mTileWidth || mConfig.mStrideY > mConfig.mTileHeight)
+			throw std::invalid_argument("Tile Stride Must Not Exceed The Tile Size, The Image Would Not Be Covered.");
+	}
+
+	std::vector<ImageTile> TiledInference::ComputeTiles(uint32_t width,
+														uint32_t height) const
+	{
+		std::vector<ImageTile> tiles;
+		if (width == 0 || height == 0)
+			return tiles;
+
+		// Images smaller than a tile are run as a single (resized) tile
+		const uint32_t tile_width = std::min(mConfig.mTileWidth, width);
+		const uint32_t tile_height = std::min(mConfig.mTileHeight, height);
+
+		const std::vector<uint32_t> columns = ComputeOrigins(width, tile_width, mConfig.mStrideX);
+		const std::vector<uint32_t> rows = ComputeOrigins(height, tile_height, mConfig.mStrideY);
+
+		tiles.reserve(columns.size() * rows.size());
+		for (uint32_t y : rows)
+		{
+			for (uint32_t x : columns)
+			{
+				ImageTile& tile = tiles.emplace_back();
+				tile.mX = x;
+				tile.mY = y;
+				tile.mWidth = tile_width;
+				tile.mHeight = tile_height;
+			}
+		}
+		return tiles;
+	}
+
+	bool TiledInference::Run(const std::string& image_path,
+							 TiledInferenceResult& result)
+	{
+		cv::Mat image = cv::imread(image_path, cv::IMREAD_UNCHANGED);
+		if (image.empty())
+		{
+			std::cerr << "Failed To Load Image: " << image_path << std::endl;
+			return false;
+		}
+
+		// Tiles are cut from 8-bit pixels, deeper images are brought to 8-bit first
+		if (image.depth() != CV_8U)
+			image.convertTo(image, CV_MAKETYPE(CV_8U, image.channels()), image.depth() == CV_16U ? 1.0 / 257.0 : 1.0);
+
+		return Run(image.ptr<uint8_t>(),
+				   static_cast<uint32_t>(image.cols),
+				   static_cast<uint32_t>(image.rows),
+				   static_cast<uint32_t>(image.channels()),
+				   image.step,
+				   result);
+	}
+
+	bool TiledInference::Run(const uint8_t* pixels,
+							 uint32_t width,
+							 uint32_t height,
+							 uint32_t channels,
+							 size_t stride,
+							 TiledInferenceResult& result)
+	{
+		result = TiledInferenceResult();
+
+		if (!pixels || width == 0 || height == 0)
+		{
+			std::cerr << "Invalid Image For Tiled Inference." << std::endl;
+			return false;
+		}
+
+		if (stride == 0)
+			stride = static_cast<size_t>(width) * channels;
+
+		result.mTiles = ComputeTiles(width, height);
+
+		const bool use_cache = mConfig.mCacheCapacity > 0;
+		if (use_cache)
+		{
+			// Outputs of an earlier model version are stale
+			const std::scoped_lock lock(mCacheMutex);
+			if (mCacheModelVersion != mModel.GetModelVersion())
+			{
+				mCache.clear();
+				mCacheOrder.clear();
+				mCacheModelVersion = mModel.GetModelVersion();
+			}
+		}
+
+		const auto GetTilePixels = [&](const ImageTile& tile)
+		{
+			return pixels + tile.mY * stride + static_cast<size_t>(tile.mX) * channels;
+		};
+
+		// Reuses the outputs of tiles whose pixels were seen before
+		std::vector<uint64_t> keys(result.mTiles.size(), 0);
+		std::vector<size_t> pending;
+		pending.reserve(result.mTiles.size());
+		for (size_t i = 0; i < result.mTiles.size(); ++i)
+		{
+			ImageTile& tile = result.mTiles[i];
+			if (use_cache)
+			{
+				keys[i] = HashTile(GetTilePixels(tile), tile.mWidth, tile.mHeight, channels, stride);
+
+				CachedTile cached;
+				if (LookupTile(keys[i], cached))
+				{
+					tile.mOutputs = std::move(cached.mOutputs);
+					tile.mFromCache = true;
+					result.mOutputShapes.insert(cached.mShapes.begin(), cached.mShapes.end());
+					++result.mCachedTiles;
+					continue;
+				}
+			}
+			pending.push_back(i);
+		}
+
+		const size_t image_size = mLoader.GetImageSize();
+		const size_t image_bytes = image_size * mLoader.GetElementSize();
+		const size_t max_batch = mConfig.mMaxBatchSize > 0 ? mConfig.mMaxBatchSize : std::max<size_t>(pending.size(), 1);
+
+		for (size_t first = 0; first < pending.size(); first += max_batch)
+		{
+			const size_t batch_size = std::min(max_batch, pending.size() - first);
+
+			const std::vector<int64_t> shape = mLoader.GetTensorShape(static_cast<int64_t>(batch_size));
+
+			std::vector<uint8_t> byte_values;
+			std::vector<float> float_values;
+			uint8_t* batch_values = nullptr;
+			if (mLoader.GetDataType() == DataType::UInt8)
+			{
+				byte_values.resize(batch_size * image_size);
+				batch_values = byte_values.data();
+			}
+			else
+			{
+				float_values.resize(batch_size * image_size);
+				batch_values = reinterpret_cast<uint8_t*>(float_values.data());
+			}
+
+			// Tiles are converted in parallel straight into their slot of the batch
+			std::atomic<bool> converted = true;
+			ThreadPool::GetShared().ParallelFor(batch_size, [&](size_t i)
+			{
+				const ImageTile& tile = result.mTiles[pending[first + i]];
+				if (!mLoader.LoadInto(GetTilePixels(tile), tile.mWidth, tile.mHeight, channels, stride, batch_values + i * image_bytes))
+					converted = false;
+			});
+
+			if (!converted)
+			{
+				std::cerr << "Failed To Convert Image Tiles." << std::endl;
+				return false;
+			}
+
+			LabeledTensor inputs;
+			if (mLoader.GetDataType() == DataType::UInt8)
+				inputs[mConfig.mInputName] = cppflow::tensor(byte_values, shape);
+			else
+				inputs[mConfig.mInputName] = cppflow::tensor(float_values, shape);
+
+			LabeledTensor outputs;
+			if (!mModel.Run(inputs, outputs))
+			{
+				std::cerr << "Failed To Run Batch Of " << batch_size << " Image Tiles." << std::endl;
+				return false;
+			}
+
+			// Splits the batched outputs into rows of the tiles
+			for (const auto& [name, output] : outputs)
+			{
+				// Outputs are split and stitched as floats, other types (e.g., class indices) are converted first
+				cppflow::tensor tensor = output;
+				if (tensor.dtype() != TF_FLOAT)
+				{
+					try
+					{
+						tensor = cppflow::cast(output, output.dtype(), TF_FLOAT);
+					}
+					catch (const std::exception& e)
+					{
+						std::cerr << "Failed To Convert Output To Float: " << name << ", " << e.what() << std::endl;
+						return false;
+					}
+				}
+
+				const std::vector<float> values = tensor.get_data<float>();
+				const std::vector<int64_t> output_shape = tensor.shape().get_data<int64_t>();
+
+				if (output_shape.empty() || output_shape[0] != static_cast<int64_t>(batch_size) || values.size() % batch_size != 0)
+				{
+					std::cerr << "Output Is Not Batched Over The Tiles: " << name << std::endl;
+					return false;
+				}
+
+				result.mOutputShapes[name] = std::vector<int64_t>(output_shape.begin() + 1, output_shape.end());
+
+				const size_t row_size = values.size() / batch_size;
+				for (size_t i = 0; i < batch_size; ++i)
+				{
+					ImageTile& tile = result.mTiles[pending[first + i]];
+					tile.mOutputs[name].assign(values.begin() + i * row_size, values.begin() + (i + 1) * row_size);
+				}
+			}
+
+			if (use_cache)
+			{
+				for (size_t i = 0; i < batch_size; ++i)
+				{
+					const size_t index = pending[first + i];
+
+					CachedTile cached;
+					cached.mOutputs = result.mTiles[index].mOutputs;
+					for (const auto& [name, values] : cached.mOutputs)
+						cached.mShapes[name] = result.mOutputShapes[name];
+
+					StoreTile(keys[index], cached);
+				}
+			}
+		}
+
+		StitchOutputs(width, height, result);
+		return true;
+	}
+
+	void TiledInference::ClearCache()
+	{
+		const std::scoped_lock lock(mCacheMutex);
+		mCache.clear();
+		mCacheOrder.clear();
+	}
+
+	bool TiledInference::LookupTile(uint64_t key,
+									CachedTile& tile)
+	{
+		const std::scoped_lock lock(mCacheMutex);
+
+		const auto iter = mCache.find(key);
+		if (iter == mCache.end())
+			return false;
+
+		mCacheOrder.splice(mCacheOrder.begin(), mCacheOrder, iter->second.second);
+		tile = iter->second.first;
+		return true;
+	}
+
+	void TiledInference::StoreTile(uint64_t key,
+								   const CachedTile& tile)
+	{
+		const std::scoped_lock lock(mCacheMutex);
+
+		const auto iter = mCache.find(key);
+		if (iter != mCache.end())
+		{
+			iter->second.first = tile;
+			mCacheOrder.splice(mCacheOrder.begin(), mCacheOrder, iter->second.second);
+			return;
+		}
+
+		mCacheOrder.push_front(key);
+		mCache.emplace(key, std::make_pair(tile, mCacheOrder.begin()));
+
+		while (mCache.size() > mConfig.mCacheCapacity)
+		{
+			mCache.erase(mCacheOrder.back());
+			mCacheOrder.pop_back();
+		}
+	}
+
+	void TiledInference::StitchOutputs(uint32_t width,
+									   uint32_t height,
+									   TiledInferenceResult& result) const
+	{
+		if (result.mTiles.empty())
+			return;
+
+		const ImageTile& first_tile = result.mTiles.front();
+
+		for (const auto& [name, shape] : result.mOutputShapes)
+		{
+			int64_t tile_height = 0, tile_width = 0, channels = 0;
+			if (!GetSpatialDims(shape, mConfig.mOutputOrder, tile_height, tile_width, channels))
+				continue;
+
+			// Outputs may be at a different resolution than the tiles, e.g., strided segmentation maps
+			const double scale_x = static_cast<double>(tile_width) / first_tile.mWidth;
+			const double scale_y = static_cast<double>(tile_height) / first_tile.mHeight;
+
+			StitchedOutput& stitched = result.mStitched[name];
+			stitched.mWidth = static_cast<uint32_t>(std::lround(width * scale_x));
+			stitched.mHeight = static_cast<uint32_t>(std::lround(height * scale_y));
+			stitched.mChannels = static_cast<uint32_t>(channels);
+			stitched.mValues.assign(static_cast<size_t>(stitched.mWidth) * stitched.mHeight * stitched.mChannels, 0.0f);
+
+			std::vector<uint32_t> counts(static_cast<size_t>(stitched.mWidth) * stitched.mHeight, 0);
+
+			const bool channels_first = mConfig.mOutputOrder == ShapeOrder::ChannelsHeightWidth || mConfig.mOutputOrder == ShapeOrder::ChannelsWidthHeight;
+			const bool width_major = mConfig.mOutputOrder == ShapeOrder::WidthHeightChannels || mConfig.mOutputOrder == ShapeOrder::ChannelsWidthHeight;
+
+			for (const ImageTile& tile : result.mTiles)
+			{
+				const auto iter = tile.mOutputs.find(name);
+				if (iter == tile.mOutputs.end() || iter->second.size() != static_cast<size_t>(tile_width * tile_height * channels))
+					continue;
+
+				const std::vector<float>& values = iter->second;
+
+				// Clamped, the last tiles are aligned to the image edge
+				const uint32_t origin_x = std::min(static_cast<uint32_t>(std::lround(tile.mX * scale_x)), stitched.mWidth - static_cast<uint32_t>(std::min<int64_t>(tile_width, stitched.mWidth)));
+				const uint32_t origin_y = std::min(static_cast<uint32_t>(std::lround(tile.mY * scale_y)), stitched.mHeight - static_cast<uint32_t>(std::min<int64_t>(tile_height, stitched.mHeight)));
+
+				const int64_t rows = std::min<int64_t>(tile_height, stitched.mHeight - origin_y);
+				const int64_t cols = std::min<int64_t>(tile_width, stitched.mWidth - origin_x);
+				for (int64_t y = 0; y < rows; ++y)
+				{
+					for (int64_t x = 0; x < cols; ++x)
+					{
+						const size_t pixel = (origin_y + y) * stitched.mWidth + origin_x + x;
+						++counts[pixel];
+
+						const int64_t spatial = width_major ? x * tile_height + y : y * tile_width + x;
+						for (int64_t c = 0; c < channels; ++c)
+						{
+							const int64_t source = channels_first ? c * tile_width * tile_height + spatial : spatial * channels + c;
+							stitched.mValues[pixel * channels + c] += values[source];
+						}
+					}
+				}
+			}
+
+			// Averages the overlapping tiles
+			for (size_t pixel = 0; pixel < counts.size(); ++pixel)
+			{
+				if (counts[pixel] <= 1)
+					continue;
+
+				const float weight = 1.0f / counts[pixel];
+				for (int64_t c = 0; c < channels; ++c)
+					stitched.mValues[pixel * channels + c] *= weight;
+			}
+		}
+	}
+}
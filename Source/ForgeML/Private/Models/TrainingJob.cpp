@@ -0,0 +1,116 @@
+#include "Models/TrainingJob.h"
+
+#include <nlohmann/json.hpp>
+
+#include <limits>
+
+namespace TF
+{
+	// Prefix of the lines the trainer uses to report per-epoch metrics
+	static constexpr const char* MetricsPrefix = "FORGEML_METRICS ";
+
+	TrainingJob::TrainingJob(MetricsCallback on_metrics)
+		: mOnMetrics(std::move(on_metrics))
+	{
+	}
+
+	void TrainingJob::Cancel()
+	{
+		mCancelRequested = true;
+
+		const std::scoped_lock lock(mMutex);
+		if (mpProcess)
+			mpProcess->Cancel();
+	}
+
+	bool TrainingJob::Wait() const
+	{
+		return mFuture.get();
+	}
+
+	std::vector<TrainingMetrics> TrainingJob::GetMetricsHistory() const
+	{
+		const std::scoped_lock lock(mMutex);
+		return mHistory;
+	}
+
+	std::string TrainingJob::GetOutput() const
+	{
+		const std::scoped_lock lock(mMutex);
+		return mOutput;
+	}
+
+	void TrainingJob::AttachProcess(std::shared_ptr<ConsoleUtils::ProcessHandle> process)
+	{
+		const std::scoped_lock lock(mMutex);
+		mpProcess = std::move(process);
+
+		// Cancellation may have been requested before the process existed
+		if (mCancelRequested)
+			mpProcess->Cancel();
+	}
+
+	void TrainingJob::OnOutputLine(const std::string& line,
+								   bool is_error)
+	{
+		TrainingMetrics metrics;
+		const bool is_metrics = !is_error && ParseMetrics(line, metrics);
+
+		{
+			const std::scoped_lock lock(mMutex);
+			mOutput += line;
+			mOutput += '\n';
+
+			if (is_metrics)
+				mHistory.push_back(metrics);
+		}
+
+		if (is_metrics && mOnMetrics)
+			mOnMetrics(metrics);
+	}
+
+	void TrainingJob::Complete(TrainingJobState state)
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+			mpProcess = nullptr;
+		}
+
+		mState = state;
+		mPromise.set_value(state == TrainingJobState::Succeeded);
+	}
+
+	bool TrainingJob::ParseMetrics(const std::string& line,
+								   TrainingMetrics& metrics)
+	{
+		if (line.rfind(MetricsPrefix, 0) != 0)
+			return false;
+
+		const nlohmann::json report = nlohmann::json::parse(line.substr(std::char_traits<char>::length(MetricsPrefix)), nullptr, false);
+		if (report.is_discarded() || !report.is_object())
+			return false;
+
+		metrics.mEpoch				= report.value("epoch", 0u);
+		metrics.mEpochs				= report.value("epochs", 0u);
+		metrics.mEpochSeconds		= report.value("seconds", 0.0f);
+		metrics.mSamplesPerSecond	= report.value("samples_per_sec", 0.0f);
+
+		if (report.contains("metrics") && report["metrics"].is_object())
+		{
+			for (const auto& [key, val] : report["metrics"].items())
+			{
+				// Non-finite values are reported as null, JSON has no NaN or Infinity
+				if (val.is_number())
+					metrics.mMetrics[key] = val.get<float>();
+				else if (val.is_null())
+					metrics.mMetrics[key] = std::numeric_limits<float>::quiet_NaN();
+			}
+		}
+
+		const auto found = metrics.mMetrics.find("loss");
+		if (found != metrics.mMetrics.end())
+			metrics.mLoss = found->second;
+
+		return true;
+	}
+}
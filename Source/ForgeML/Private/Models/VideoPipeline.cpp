@@ -0,0 +1,430 @@
+#include "Models/VideoPipeline.h"
+
+#include "Models/MLModel.h"
+
+#include "OpenCVLib.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace TF
+{
+	/// <summary>
+	/// Struct representing a captured frame waiting for preprocessing.
+	/// </summary>
+	struct VideoPipeline::RawFrame
+	{
+	public:
+		VideoFrameInfo mInfo;
+		cv::Mat mImage;
+	};
+
+	/// <summary>
+	/// Struct representing a preprocessed frame waiting for a batch.
+	/// </summary>
+	struct VideoPipeline::PreparedFrame
+	{
+	public:
+		VideoFrameInfo mInfo;
+		double mPreparedTime_s = 0.0;
+
+		// GetImageSize() values of the loader's data type
+		std::vector<uint8_t> mValues;
+	};
+
+	/// <summary>
+	/// Struct representing the outputs of a batch waiting for postprocessing.
+	/// </summary>
+	struct VideoPipeline::InferredBatch
+	{
+	public:
+		VideoBatchResult mResult;
+		double mInferredTime_s = 0.0;
+	};
+
+	void VideoPipeline::StageCounters::Add(double latency_s)
+	{
+		const uint64_t latency_us = static_cast<uint64_t>(std::max(latency_s, 0.0) * 1e6);
+
+		mFrames.fetch_add(1, std::memory_order_relaxed);
+		mTotalLatency_us.fetch_add(latency_us, std::memory_order_relaxed);
+
+		uint64_t max_latency_us = mMaxLatency_us.load(std::memory_order_relaxed);
+		while (latency_us > max_latency_us &&
+			   !mMaxLatency_us.compare_exchange_weak(max_latency_us, latency_us, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	VideoStageStats VideoPipeline::StageCounters::ToStats(double elapsed_s) const
+	{
+		VideoStageStats stats;
+		stats.mFrames = mFrames.load();
+		stats.mThroughput = elapsed_s > 0.0 ? stats.mFrames / elapsed_s : 0.0;
+		stats.mAverageLatency_ms = stats.mFrames > 0 ? mTotalLatency_us.load() / 1000.0 / stats.mFrames : 0.0;
+		stats.mMaxLatency_ms = mMaxLatency_us.load() / 1000.0;
+		return stats;
+	}
+
+	VideoPipeline::VideoPipeline(MLModel& model,
+								 const ImageTensorLoader& loader,
+								 const VideoPipelineConfig& config,
+								 ResultCallback on_result)
+		: mModel(model),
+		mLoader(loader),
+		mConfig(config),
+		mOnResult(std::move(on_result))
+	{
+		mConfig.mBatchSize = std::max(mConfig.mBatchSize, 1u);
+		mConfig.mQueueCapacity = std::max(mConfig.mQueueCapacity, 1u);
+
+		if (mConfig.mPreprocessWorkers == 0)
+			mConfig.mPreprocessWorkers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	VideoPipeline::~VideoPipeline()
+	{
+		Stop();
+	}
+
+	bool VideoPipeline::StartVideo(const std::string& video_path)
+	{
+		if (mIsRunning)
+		{
+			std::cerr << "Video Pipeline Already Running." << std::endl;
+			return false;
+		}
+
+		// Opened here so a bad path fails the call rather than ending the source silently
+		auto capture = std::make_unique<cv::VideoCapture>(video_path);
+		if (!capture->isOpened())
+		{
+			std::cerr << "Failed To Open Video: " << video_path << std::endl;
+			return false;
+		}
+
+		StartStages();
+
+		mSourceThread = std::thread(&VideoPipeline::SourceLoop, this, std::move(capture));
+		return true;
+	}
+
+	bool VideoPipeline::Start()
+	{
+		if (mIsRunning)
+		{
+			std::cerr << "Video Pipeline Already Running." << std::endl;
+			return false;
+		}
+
+		StartStages();
+
+		mAcceptsFrames = true;
+		return true;
+	}
+
+	bool VideoPipeline::PushFrame(const uint8_t* pixels,
+								  uint32_t width,
+								  uint32_t height,
+								  uint32_t channels,
+								  size_t stride)
+	{
+		if (!mAcceptsFrames)
+			return false;
+
+		if (!pixels || width == 0 || height == 0 || channels < 1 || channels > 4 || channels == 2)
+		{
+			std::cerr << "Invalid Frame." << std::endl;
+			return false;
+		}
+
+		const double capture_time_s = GetElapsed();
+
+		auto frame = std::make_unique<RawFrame>();
+		frame->mInfo.mIndex = mNextFrameIndex++;
+		frame->mInfo.mCaptureTime_s = capture_time_s;
+
+		// Copied, the caller may reuse its buffer as soon as the call returns
+		const size_t row_bytes = static_cast<size_t>(width) * channels;
+		frame->mImage = cv::Mat(static_cast<int>(height), static_cast<int>(width), CV_8UC(channels));
+		for (uint32_t y = 0; y < height; ++y)
+			std::memcpy(frame->mImage.ptr<uint8_t>(static_cast<int>(y)), pixels + y * (stride != 0 ? stride : row_bytes), row_bytes);
+
+		mSourceCounters.Add(GetElapsed() - capture_time_s);
+
+		return Enqueue(frame);
+	}
+
+	void VideoPipeline::Finish()
+	{
+		if (!mIsRunning)
+			return;
+
+		mAcceptsFrames = false;
+
+		if (mSourceThread.joinable())
+			mSourceThread.join();
+
+		JoinStages();
+	}
+
+	void VideoPipeline::Stop()
+	{
+		if (!mIsRunning)
+			return;
+
+		mAcceptsFrames = false;
+		mIsStopping = true;
+
+		if (mSourceThread.joinable())
+			mSourceThread.join();
+
+		JoinStages();
+	}
+
+	VideoPipelineStats VideoPipeline::GetStats() const
+	{
+		const double elapsed_s = mIsRunning ? GetElapsed() : mFinishedElapsed_s.load();
+
+		VideoPipelineStats stats;
+		stats.mSource = mSourceCounters.ToStats(elapsed_s);
+		stats.mPreprocess = mPreprocessCounters.ToStats(elapsed_s);
+		stats.mInference = mInferenceCounters.ToStats(elapsed_s);
+		stats.mPostprocess = mPostprocessCounters.ToStats(elapsed_s);
+		stats.mEndToEnd = mEndToEndCounters.ToStats(elapsed_s);
+		stats.mDroppedFrames = mDroppedFrames.load();
+		stats.mFailedFrames = mFailedFrames.load();
+		return stats;
+	}
+
+	void VideoPipeline::StartStages()
+	{
+		mpRawFrames = std::make_unique<BoundedQueue<std::unique_ptr<RawFrame>>>(mConfig.mQueueCapacity);
+		mpPreparedFrames = std::make_unique<BoundedQueue<std::unique_ptr<PreparedFrame>>>(std::max(mConfig.mQueueCapacity, mConfig.mBatchSize));
+		mpResults = std::make_unique<BoundedQueue<std::unique_ptr<InferredBatch>>>(mConfig.mQueueCapacity);
+
+		for (StageCounters* counters : { &mSourceCounters, &mPreprocessCounters, &mInferenceCounters, &mPostprocessCounters, &mEndToEndCounters })
+		{
+			counters->mFrames = 0;
+			counters->mTotalLatency_us = 0;
+			counters->mMaxLatency_us = 0;
+		}
+
+		mDroppedFrames = 0;
+		mFailedFrames = 0;
+		mNextFrameIndex = 0;
+		mIsStopping = false;
+		mStartTime = std::chrono::steady_clock::now();
+		mIsRunning = true;
+
+		for (uint32_t i = 0; i < mConfig.mPreprocessWorkers; ++i)
+			mPreprocessThreads.emplace_back(&VideoPipeline::PreprocessLoop, this);
+
+		mInferenceThread = std::thread(&VideoPipeline::InferenceLoop, this);
+		mPostprocessThread = std::thread(&VideoPipeline::PostprocessLoop, this);
+	}
+
+	double VideoPipeline::GetElapsed() const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - mStartTime).count();
+	}
+
+	bool VideoPipeline::Enqueue(std::unique_ptr<RawFrame>& frame)
+	{
+		switch (mConfig.mDropPolicy)
+		{
+			case FrameDropPolicy::Block:
+			{
+				return mpRawFrames->Push(frame);
+			}
+			case FrameDropPolicy::DropOldest:
+			{
+				while (!mpRawFrames->TryPush(frame))
+				{
+					// Makes room, a worker may have taken the oldest frame in the meantime
+					std::unique_ptr<RawFrame> oldest;
+					if (mpRawFrames->TryPop(oldest))
+						++mDroppedFrames;
+				}
+				return true;
+			}
+			case FrameDropPolicy::DropNewest:
+			default:
+			{
+				if (mpRawFrames->TryPush(frame))
+					return true;
+
+				++mDroppedFrames;
+				return false;
+			}
+		}
+	}
+
+	void VideoPipeline::JoinStages()
+	{
+		// Each stage drains its input before closing the input of the next one
+		mpRawFrames->Close();
+		for (std::thread& thread : mPreprocessThreads)
+			thread.join();
+		mPreprocessThreads.clear();
+
+		mpPreparedFrames->Close();
+		mInferenceThread.join();
+
+		mpResults->Close();
+		mPostprocessThread.join();
+
+		mFinishedElapsed_s = GetElapsed();
+		mIsRunning = false;
+	}
+
+	void VideoPipeline::SourceLoop(std::unique_ptr<cv::VideoCapture> capture)
+	{
+		while (!mIsStopping)
+		{
+			const double read_start_s = GetElapsed();
+
+			// A new matrix per frame, the previous ones are still in flight
+			auto frame = std::make_unique<RawFrame>();
+			if (!capture->read(frame->mImage) || frame->mImage.empty())
+				break;
+
+			frame->mInfo.mIndex = mNextFrameIndex++;
+			frame->mInfo.mCaptureTime_s = GetElapsed();
+
+			mSourceCounters.Add(frame->mInfo.mCaptureTime_s - read_start_s);
+
+			Enqueue(frame);
+		}
+	}
+
+	void VideoPipeline::PreprocessLoop()
+	{
+		const size_t image_bytes = mLoader.GetImageSize() * mLoader.GetElementSize();
+
+		std::unique_ptr<RawFrame> frame;
+		while (mpRawFrames->Pop(frame))
+		{
+			if (mIsStopping)
+				continue;
+
+			auto prepared = std::make_unique<PreparedFrame>();
+			prepared->mInfo = frame->mInfo;
+			prepared->mValues.resize(image_bytes);
+
+			const cv::Mat& image = frame->mImage;
+			if (!mLoader.LoadInto(image.ptr<uint8_t>(),
+								  static_cast<uint32_t>(image.cols),
+								  static_cast<uint32_t>(image.rows),
+								  static_cast<uint32_t>(image.channels()),
+								  image.step,
+								  prepared->mValues.data()))
+			{
+				++mFailedFrames;
+				continue;
+			}
+
+			prepared->mPreparedTime_s = GetElapsed();
+			mPreprocessCounters.Add(prepared->mPreparedTime_s - prepared->mInfo.mCaptureTime_s);
+
+			frame.reset();
+			mpPreparedFrames->Push(prepared);
+		}
+	}
+
+	void VideoPipeline::InferenceLoop()
+	{
+		const size_t image_size = mLoader.GetImageSize();
+		const size_t image_bytes = image_size * mLoader.GetElementSize();
+		const auto batch_timeout = std::chrono::microseconds(static_cast<int64_t>(mConfig.mBatchTimeout_ms) * 1000);
+
+		std::vector<std::unique_ptr<PreparedFrame>> batch;
+		while (true)
+		{
+			batch.clear();
+
+			std::unique_ptr<PreparedFrame> frame;
+			if (!mpPreparedFrames->Pop(frame))
+				break;
+			batch.push_back(std::move(frame));
+
+			// Fills the batch until it is full or the first frame waited long enough
+			const auto batch_start = std::chrono::steady_clock::now();
+			while (batch.size() < mConfig.mBatchSize)
+			{
+				const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - batch_start);
+				if (waited >= batch_timeout || !mpPreparedFrames->PopFor(frame, batch_timeout - waited))
+					break;
+
+				batch.push_back(std::move(frame));
+			}
+
+			if (mIsStopping)
+				continue;
+
+			// Parallel preprocessing may finish frames out of order
+			std::sort(batch.begin(), batch.end(), [](const auto& lhs, const auto& rhs)
+			{
+				return lhs->mInfo.mIndex < rhs->mInfo.mIndex;
+			});
+
+			const int64_t batch_size = static_cast<int64_t>(batch.size());
+
+			LabeledTensor inputs;
+			if (mLoader.GetDataType() == DataType::UInt8)
+			{
+				std::vector<uint8_t> values(batch.size() * image_size);
+				for (size_t i = 0; i < batch.size(); ++i)
+					std::memcpy(values.data() + i * image_size, batch[i]->mValues.data(), image_bytes);
+
+				inputs[mConfig.mInputName] = cppflow::tensor(values, mLoader.GetTensorShape(batch_size));
+			}
+			else
+			{
+				std::vector<float> values(batch.size() * image_size);
+				for (size_t i = 0; i < batch.size(); ++i)
+					std::memcpy(values.data() + i * image_size, batch[i]->mValues.data(), image_bytes);
+
+				inputs[mConfig.mInputName] = cppflow::tensor(values, mLoader.GetTensorShape(batch_size));
+			}
+
+			auto inferred = std::make_unique<InferredBatch>();
+			if (!mModel.Run(inputs, inferred->mResult.mOutputs))
+			{
+				std::cerr << "Video Pipeline Failed To Run Batch Of " << batch_size << " Frames." << std::endl;
+				mFailedFrames += batch.size();
+				continue;
+			}
+
+			inferred->mInferredTime_s = GetElapsed();
+			for (const auto& prepared : batch)
+			{
+				inferred->mResult.mFrames.push_back(prepared->mInfo);
+				mInferenceCounters.Add(inferred->mInferredTime_s - prepared->mPreparedTime_s);
+			}
+
+			mpResults->Push(inferred);
+		}
+	}
+
+	void VideoPipeline::PostprocessLoop()
+	{
+		std::unique_ptr<InferredBatch> inferred;
+		while (mpResults->Pop(inferred))
+		{
+			if (mIsStopping)
+				continue;
+
+			if (mOnResult)
+				mOnResult(inferred->mResult);
+
+			const double done_s = GetElapsed();
+			for (const VideoFrameInfo& info : inferred->mResult.mFrames)
+			{
+				mPostprocessCounters.Add(done_s - inferred->mInferredTime_s);
+				mEndToEndCounters.Add(done_s - info.mCaptureTime_s);
+			}
+		}
+	}
+}
@@ -3,9 +3,22 @@
 #include "Interfaces/IPluginManager.h"
 
 #include "TFModelLib.h"
+#include "Utils/ConsoleUtils.h"
+#include "Utils/DiskCache.h"
+#include "Utils/HashUtils.h"
+
+#include "OpenCVLib.h"
 
 #include "Kismet/KismetRenderingLibrary.h"
 
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <set>
+
 // Reference: https://minifloppy.it/posts/2024/automated-testing-specs-ue5/#writing-tests
 
 BEGIN_DEFINE_SPEC(FMLUnitTestsSpecs, 
@@ -370,5 +383,1769 @@ void FMLUnitTestsSpecs::Define()
 					return;
 			}
 		});
+
+		It("(7) Reload Cached Conversion", [this]()
+		{
+			FString modelPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Models/bird-classifier/BirdClassifier.onnx"));
+			FString tempOutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Models"));
+
+			std::filesystem::path converted_path;
+			{
+				TF::MLModel model("BirdClassifier");
+				bool loaded = model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+											 TCHAR_TO_UTF8(*tempOutputDir));
+				if (!TestTrue(TEXT("Failed To Load Model!"), loaded))
+					return;
+
+				converted_path = std::filesystem::path(model.mOutputDirectory) / model.mName / "Saved_0";
+			}
+
+			// The conversion stamps its output with the cache key, only a new conversion rewrites it
+			const std::filesystem::path stamp_path = converted_path / "forgeml_cache_key.txt";
+			const std::filesystem::path saved_model_path = converted_path / "saved_model.pb";
+			if (!TestTrue(TEXT("Conversion Not Stamped!"), std::filesystem::exists(stamp_path)))
+				return;
+
+			const auto stamp_time = std::filesystem::last_write_time(stamp_path);
+			const auto saved_model_time = std::filesystem::last_write_time(saved_model_path);
+
+			// Second load of the unchanged file must be served without re-running the conversion
+			const double start_s = FPlatformTime::Seconds();
+
+			TF::MLModel model("BirdClassifier");
+			bool reloaded = model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+										   TCHAR_TO_UTF8(*tempOutputDir));
+
+			const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+			if (!TestTrue(TEXT("Failed To Reload Model!"), reloaded))
+				return;
+
+			TestTrue(TEXT("Conversion Stamp Rewritten!"), std::filesystem::last_write_time(stamp_path) == stamp_time);
+			TestTrue(TEXT("Converted Model Rewritten!"), std::filesystem::last_write_time(saved_model_path) == saved_model_time);
+
+			UE_LOG(LogTemp, Log, TEXT("Cached Conversion Reload Took %.3fs"), elapsed_s);
+		});
+
+		It("(8) Reuse Cached Build", [this]()
+		{
+			const auto CreateAddModel = [](TF::MLModel& model)
+			{
+				model.AddInput("x", 
+							   TF::DataType::Float32,
+							   { -1 });
+
+				model.AddInput("y", 
+							   TF::DataType::Float32,
+							   { -1 });
+
+				model.AddOutput("add_result");
+
+				model.AddLayer(TF::LayerType::Add,
+				{
+					{ "input_names", { "x", "y" } },
+					{ "output_name", "add_result" }
+				});
+
+				return model.CreateModel();
+			};
+
+			TF::MLModel model("cached_add");
+			if (!TestTrue(TEXT("Failed To Create Model!"), CreateAddModel(model)))
+				return;
+
+			// Builds are cached under the layout hash and the build script
+			const std::string build_script_path = model.mScriptDirectory + "/build_model_from_json.py";
+			const std::string cache_key = "layout-" + HashUtils::ToHex(HashUtils::HashString(HashUtils::ToHex(model.mLayout.Hash()),
+			                                                                                 HashUtils::HashFile(build_script_path)));
+
+			const std::filesystem::path cache_entry = std::filesystem::path(TCHAR_TO_UTF8(*FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/ModelCache")))) / cache_key;
+			if (!TestTrue(TEXT("Build Not Cached Under The Layout Hash!"), std::filesystem::exists(cache_entry)))
+				return;
+
+			// Identical layout under another name must reuse the build without starting Python,
+			// a previous run's copy is removed so it cannot be served from its own stamp
+			TF::MLModel copy("cached_add_copy");
+			const std::filesystem::path copy_path = std::filesystem::path(copy.mOutputDirectory) / copy.mName / "Saved_0";
+			std::filesystem::remove_all(copy_path);
+
+			const double start_s = FPlatformTime::Seconds();
+			bool created = CreateAddModel(copy);
+			const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+			if (!TestTrue(TEXT("Failed To Create Model From Cache!"), created))
+				return;
+
+			// A build of its own would write new model files instead of the cached ones
+			const auto ReadFile = [](const std::filesystem::path& path)
+			{
+				std::ifstream in(path, std::ios::binary);
+				return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			};
+
+			TestEqual(TEXT("Copy Not Stamped With The Layout Key!"), ReadFile(copy_path / "forgeml_cache_key.txt"), cache_key);
+			TestTrue(TEXT("Copy Not Taken From The Cache Entry!"), ReadFile(copy_path / "saved_model.pb") == ReadFile(cache_entry / "saved_model.pb"));
+
+			// Starting Python and importing TensorFlow alone takes longer
+			TestTrue(TEXT("Build Script Re-Run!"), elapsed_s < 2.0);
+
+			UE_LOG(LogTemp, Log, TEXT("Cached Build Took %.3fs"), elapsed_s);
+		});
+
+		It("(9) Train Model Async", [this]()
+		{
+			TF::MLModel model("linear_async");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			model.AddSupervisedTrainingData("x", 
+											{ 5.1f, 3.5f, 1.4f, 0.2f }, 
+											"y", 
+											{ 1.0f, 0.0f });
+
+			model.AddSupervisedTrainingData("x", 
+											{ 0.2f, 6.8f, 9.1f, 1.2f }, 
+											"y", 
+											{ 0, 1.0f });
+
+			TF::TrainingConfig config;
+			config.epochs = 8;
+			config.early_stopping = false;
+
+			std::atomic<uint32_t> reported_epochs = 0;
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config, [&](const TF::TrainingMetrics& metrics)
+			{
+				++reported_epochs;
+			});
+
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Training Job Failed!"), job->Wait()))
+				return;
+
+			TestEqual(TEXT("Metrics Epoch Count Mismatch!"), reported_epochs.load(), config.epochs);
+			TestEqual(TEXT("Model Version Not Promoted!"), model.GetModelVersion(), 1u);
+		});
+
+		It("(10) Collect Data While Training", [this]()
+		{
+			TF::MLModel model("linear_collect");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			model.AddSupervisedTrainingData("x", 
+											{ 5.1f, 3.5f, 1.4f, 0.2f }, 
+											"y", 
+											{ 1.0f, 0.0f });
+
+			TF::TrainingConfig config;
+			config.epochs = 32;
+
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config);
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			// Samples added during the run must neither block nor be consumed by it
+			const double start_s = FPlatformTime::Seconds();
+			model.AddSupervisedTrainingData("x", 
+											{ 0.2f, 6.8f, 9.1f, 1.2f }, 
+											"y", 
+											{ 0, 1.0f });
+			const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+			TestTrue(TEXT("Adding Training Data Blocked On Training!"), elapsed_s < 0.5);
+
+			if (!TestTrue(TEXT("Training Job Failed!"), job->Wait()))
+				return;
+
+			TestEqual(TEXT("Samples Collected During Training Lost!"), model.GetSupervisedSampleCount(), uint64_t(1));
+		});
+
+		It("(11) Stream Training Data To Log", [this]()
+		{
+			TF::MLModel model("linear_log");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			// Small window and segments to exercise back pressure and segment sealing
+			static constexpr uint64_t InFlightBytes = 1024;
+			model.EnableTrainingLog(InFlightBytes, 4096);
+
+			for (uint32_t i = 0; i < 512; ++i)
+			{
+				const float value = static_cast<float>(i % 8);
+				if (!TestTrue(TEXT("Failed To Log Training Sample!"), model.AddSupervisedTrainingData("x", 
+																									   { value, 1.0f, 2.0f, 3.0f }, 
+																									   "y", 
+																									   { value < 4 ? 1.0f : 0.0f, value < 4 ? 0.0f : 1.0f })))
+					return;
+
+				if (!TestTrue(TEXT("In-Flight Window Exceeded!"), model.mpSupervisedTrainingLog->GetInFlightBytes() <= InFlightBytes))
+					return;
+			}
+
+			TestEqual(TEXT("Logged Samples Kept In Memory!"), model.GetSupervisedSampleCount(), uint64_t(0));
+
+			bool train_success = model.TrainModel(4);
+			if (!TestTrue(TEXT("Failed To Train Model From Log!"), train_success))
+				return;
+
+			TestFalse(TEXT("Consumed Log Segments Not Removed!"), model.mpSupervisedTrainingLog->HasData());
+			TestEqual(TEXT("Model Version Not Promoted!"), model.GetModelVersion(), 1u);
+		});
+
+		It("(12) Prioritized Replay Sampling", [this]()
+		{
+			TF::ReplayBuffer buffer(8, true);
+			buffer.Seed(7);
+
+			for (uint32_t i = 0; i < 20; ++i)
+			{
+				const std::vector<float> state = { static_cast<float>(i), 1.0f };
+				const std::vector<float> next_state = { static_cast<float>(i + 1), 1.0f };
+				const std::vector<float> action = { 0.0f };
+
+				if (!TestTrue(TEXT("Failed To Add Transition!"), buffer.Add(state, action, 1.0f, next_state, false)))
+					return;
+			}
+
+			TestEqual(TEXT("Replay Capacity Exceeded!"), buffer.GetSize(), 8u);
+
+			// A single transition with a large TD error must dominate the sampling
+			static constexpr uint32_t PriorityIndex = 5;
+
+			// All priorities are equal, so the stratified draws cover every slot
+			TF::ReplayBatch update_batch;
+			if (!TestTrue(TEXT("Failed To Sample Replay Buffer!"), buffer.Sample(64, update_batch)))
+				return;
+
+			std::vector<float> td_errors;
+			for (const uint32_t index : update_batch.mIndices)
+				td_errors.push_back(index == PriorityIndex ? 10.0f : 0.01f);
+
+			buffer.UpdatePriorities(update_batch, td_errors);
+
+			TF::ReplayBatch batch;
+			if (!TestTrue(TEXT("Failed To Sample Replay Buffer!"), buffer.Sample(1000, batch)))
+				return;
+
+			uint32_t priority_count = 0;
+			float priority_weight = 1.0f;
+			for (size_t i = 0; i < batch.mIndices.size(); ++i)
+			{
+				if (batch.mIndices[i] == PriorityIndex)
+				{
+					++priority_count;
+					priority_weight = batch.mWeights[i];
+				}
+			}
+
+			TestTrue(TEXT("High Priority Transition Not Preferred!"), priority_count > 500);
+			TestTrue(TEXT("Importance Weight Not Reduced!"), priority_weight < 1.0f);
+		});
+
+		It("(13) Train From Replay Buffer", [this]()
+		{
+			TF::MLModel model("replay_predictor");
+
+			model.AddInput("view_state", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("action");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "view_state" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 1 },
+				{ "output_name", "action" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			model.EnableReplayBuffer(64);
+
+			model.AddRewardData({ 0.1f, 0.5f, 0.3f, 0.0f },
+								{ 2.0f },
+								1.0f,
+								{ 0.0f, 0.0f, 0.8f, 0.1f });
+
+			model.AddRewardData({ 0.0f, 0.0f, 0.8f, 0.1f },
+								{ 1.0f },
+								-0.5f,
+								{ 0.9f, 0.4f, 0.1f, 0.7f });
+
+			model.AddRewardData({ 0.9f, 0.4f, 0.1f, 0.7f },
+								{ 3.0f },
+								0.2f,
+								nullptr,
+								true);
+
+			TF::TrainingConfig config;
+			config.epochs = 4;
+			config.batch_size = 8;
+			config.replay_batches = 4;
+
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config);
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Failed To Train From Replay Buffer!"), job->Wait()))
+				return;
+
+			TestEqual(TEXT("Replay Buffer Consumed By Training!"), model.mpReplayBuffer->GetSize(), 3u);
+		});
+
+		It("(14) Sharded Ingestion Throughput", [this]()
+		{
+			static constexpr uint32_t SamplesPerThread = 100000;
+
+			const std::vector<float> input = { 5.1f, 3.5f, 1.4f, 0.2f };
+			const std::vector<float> label = { 1.0f, 0.0f };
+
+			// Measures the samples per second ingested by the given number of producer threads
+			auto measure = [&](uint32_t thread_count)
+			{
+				TF::MLModel model("ingest_benchmark");
+
+				const double start_s = FPlatformTime::Seconds();
+
+				std::vector<std::thread> producers;
+				for (uint32_t t = 0; t < thread_count; ++t)
+				{
+					producers.emplace_back([&]()
+					{
+						for (uint32_t i = 0; i < SamplesPerThread; ++i)
+							model.AddSupervisedTrainingRow("x", input, "y", label);
+					});
+				}
+
+				for (std::thread& producer : producers)
+					producer.join();
+
+				const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+				TestEqual(TEXT("Ingested Samples Lost!"), model.GetSupervisedSampleCount(), uint64_t(thread_count) * SamplesPerThread);
+
+				return (thread_count * SamplesPerThread) / elapsed_s;
+			};
+
+			const uint32_t thread_count = FMath::Clamp(std::thread::hardware_concurrency(), 1u, 8u);
+
+			const double single_rate = measure(1);
+			const double multi_rate = measure(thread_count);
+
+			AddInfo(FString::Printf(TEXT("Ingestion: %.0f samples/s (1 thread), %.0f samples/s (%u threads), %.2fx speedup"), 
+									single_rate, 
+									multi_rate, 
+									thread_count, 
+									multi_rate / single_rate));
+
+			// Producers append to their own shard, so adding threads must not reduce the total throughput
+			if (thread_count > 1)
+				TestTrue(TEXT("Ingestion Does Not Scale With Producer Threads!"), multi_rate > single_rate);
+		});
+
+		It("(15) Shared Memory Transport", [this]()
+		{
+			TF::LabeledTrainingBatch batch;
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				const std::vector<float> input = { static_cast<float>(i), 1.0f, 2.0f, 3.0f };
+				const std::vector<float> label = { 1.0f, 0.0f };
+
+				batch.GetInput("x").AppendRow(std::span<const float>(input));
+				batch.GetLabel("y").AppendRow(std::span<const float>(label));
+			}
+
+			const FString directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/SharedMemory"));
+			const std::filesystem::path directory_path = TCHAR_TO_UTF8(*directory);
+
+			TF::SharedMemory memory;
+			batch.WriteToDirectory(directory_path, &memory);
+
+			if (!TestTrue(TEXT("Failed To Create Shared Memory!"), memory.IsValid()))
+				return;
+
+			// Only the descriptor is written to disk
+			std::ifstream ifs(directory_path / "manifest.json");
+			if (!TestTrue(TEXT("Failed To Open Manifest!"), ifs.is_open()))
+				return;
+
+			nlohmann::json manifest;
+			ifs >> manifest;
+
+			TestEqual(TEXT("Columns Not Placed In Shared Memory!"), manifest["format"].get<std::string>(), std::string("shm"));
+			TestEqual(TEXT("Segment Name Mismatch!"), manifest["segment"]["name"].get<std::string>(), memory.GetName());
+
+			const nlohmann::json& column = manifest["columns"]["inputs/x"];
+			const float* values = reinterpret_cast<const float*>(memory.GetData() + column["offset"].get<size_t>());
+
+			TestEqual(TEXT("Column Shape Mismatch!"), column["shape"], nlohmann::json({ 16, 4 }));
+			TestEqual(TEXT("Column Data Mismatch!"), values[15 * 4], 15.0f);
+		});
+
+		It("(16) Stream Image Training Data", [this]()
+		{
+			TF::MLModel model("image_stream");
+
+			model.AddInput("image", 
+						   TF::DataType::Float32, 
+						   { -1, 32, 32, 3 },
+						   TF::DomainType::Image);
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "image" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 3 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/test_bird_dataset/"));
+			std::string dataPath_str = TCHAR_TO_UTF8(*dataPath);
+
+			model.AddSupervisedTrainingData("image", dataPath_str + "/31/ANNAS HUMMINGBIRD.jpg", "y", { 1.0f, 0.0f, 0.0f });
+			model.AddSupervisedTrainingData("image", dataPath_str + "/158/COMMON HOUSE MARTIN.jpg", "y", { 0.0f, 1.0f, 0.0f });
+			model.AddSupervisedTrainingData("image", dataPath_str + "/306/IVORY GULL.jpg", "y", { 0.0f, 0.0f, 1.0f });
+
+			const FString cacheDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/ImageCache"));
+			const std::filesystem::path cache_path = TCHAR_TO_UTF8(*cacheDir);
+			std::filesystem::remove_all(cache_path);
+
+			TF::TrainingConfig config;
+			config.epochs = 2;
+			config.batch_size = 2;
+			config.data_parallel_calls = 2;
+			config.shuffle_buffer = 2;
+			config.data_cache = cache_path.string();
+
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config);
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Failed To Train From Streamed Images!"), job->Wait()))
+				return;
+
+			TestFalse(TEXT("Decoded Images Not Cached!"), std::filesystem::is_empty(cache_path));
+		});
+
+		It("(17) Early Stopping On Validation Loss", [this]()
+		{
+			TF::MLModel model("linear_early_stop");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			for (uint32_t i = 0; i < 8; ++i)
+			{
+				const float value = static_cast<float>(i);
+				model.AddSupervisedTrainingData("x", 
+												{ value, 3.5f, 1.4f, 0.2f }, 
+												"y", 
+												{ i % 2 ? 1.0f : 0.0f, i % 2 ? 0.0f : 1.0f });
+			}
+
+			TF::TrainingConfig config;
+			config.epochs = 50;
+			config.validation_split = 0.5f;
+			config.optimizer = "sgd";
+			config.learning_rate = 0.01f;
+			config.metrics = { "accuracy" };
+			config.lr_schedule = "reduce_on_plateau";
+
+			// No change of the validation loss counts as an improvement, so training stops after the patience
+			config.early_stopping = true;
+			config.early_stopping_patience = 2;
+			config.early_stopping_min_delta = 1000.0f;
+
+			std::atomic<uint32_t> reported_epochs = 0;
+			std::atomic<bool> has_validation_metrics = false;
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config, [&](const TF::TrainingMetrics& metrics)
+			{
+				++reported_epochs;
+				has_validation_metrics = metrics.mMetrics.contains("val_loss") && metrics.mMetrics.contains("val_accuracy");
+			});
+
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Training Job Failed!"), job->Wait()))
+				return;
+
+			TestEqual(TEXT("Training Not Stopped Early!"), reported_epochs.load(), config.early_stopping_patience + 1);
+			TestTrue(TEXT("Validation Metrics Not Reported!"), has_validation_metrics.load());
+		});
+
+		It("(18) Resume From Checkpoint", [this]()
+		{
+			TF::MLModel model("linear_resume");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			model.AddSupervisedTrainingData("x", 
+											{ 5.1f, 3.5f, 1.4f, 0.2f }, 
+											"y", 
+											{ 1.0f, 0.0f });
+
+			model.AddSupervisedTrainingData("x", 
+											{ 0.2f, 6.8f, 9.1f, 1.2f }, 
+											"y", 
+											{ 0, 1.0f });
+
+			TF::TrainingConfig config;
+			config.epochs = 10000;
+			config.early_stopping = false;
+
+			// Interrupts the run once a few epochs were checkpointed
+			std::shared_ptr<TF::TrainingJob> job;
+			std::atomic<uint32_t> completed_epochs = 0;
+			job = model.TrainModelAsync(config, [&](const TF::TrainingMetrics& metrics)
+			{
+				completed_epochs = metrics.mEpoch;
+			});
+
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			const double start_s = FPlatformTime::Seconds();
+			while (completed_epochs.load() < 3 && job->IsRunning() && FPlatformTime::Seconds() - start_s < TestTimeout_S.GetTotalSeconds())
+				FPlatformProcess::Sleep(0.01f);
+
+			job->Cancel();
+			TestFalse(TEXT("Cancelled Job Succeeded!"), job->Wait());
+
+			if (!TestTrue(TEXT("No Checkpoint Left To Resume!"), model.HasTrainingCheckpoint()))
+				return;
+
+			config.epochs = completed_epochs.load() + 2;
+			config.resume = true;
+
+			std::atomic<uint32_t> first_epoch = 0;
+			job = model.TrainModelAsync(config, [&](const TF::TrainingMetrics& metrics)
+			{
+				uint32_t expected = 0;
+				first_epoch.compare_exchange_strong(expected, metrics.mEpoch);
+			});
+
+			if (!TestNotNull(TEXT("Failed To Start Resumed Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Resumed Training Job Failed!"), job->Wait()))
+				return;
+
+			TestTrue(TEXT("Training Restarted From The First Epoch!"), first_epoch.load() > 1);
+			TestFalse(TEXT("Checkpoint Not Removed After Training!"), model.HasTrainingCheckpoint());
+			TestEqual(TEXT("Model Version Not Promoted!"), model.GetModelVersion(), 1u);
+		});
+
+		It("(19) Data Parallel Training", [this]()
+		{
+			TF::MLModel model("linear_parallel");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "x" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 2 },
+				{ "output_name", "y" },
+			});
+
+			bool created = model.CreateModel();
+			if (!TestTrue(TEXT("Failed To Create Model!"), created))
+				return;
+
+			for (uint32_t i = 0; i < 64; ++i)
+			{
+				const float value = static_cast<float>(i % 8);
+				model.AddSupervisedTrainingData("x", 
+												{ value, 1.0f, 2.0f, 3.0f }, 
+												"y", 
+												{ value < 4 ? 1.0f : 0.0f, value < 4 ? 0.0f : 1.0f });
+			}
+
+			TF::TrainingConfig config;
+			config.epochs = 4;
+			config.batch_size = 8;
+			config.distribution = "mirrored";
+			config.num_workers = 2;
+			config.threads_per_worker = 1;
+
+			std::atomic<uint32_t> reported_epochs = 0;
+			std::shared_ptr<TF::TrainingJob> job = model.TrainModelAsync(config, [&](const TF::TrainingMetrics& metrics)
+			{
+				++reported_epochs;
+			});
+
+			if (!TestNotNull(TEXT("Failed To Start Training Job!"), job.get()))
+				return;
+
+			if (!TestTrue(TEXT("Data Parallel Training Failed!"), job->Wait()))
+				return;
+
+			TestTrue(TEXT("No Epochs Reported!"), reported_epochs.load() > 0);
+			TestEqual(TEXT("Model Version Not Promoted!"), model.GetModelVersion(), 1u);
+		});
+
+		It("(20) Image Loader Shape Order Throughput", [this]()
+		{
+			static constexpr uint32_t Iterations = 50;
+
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/"));
+			std::string imgPath_str = std::string(TCHAR_TO_UTF8(*dataPath)) + "/test_bird_dataset/31/ANNAS HUMMINGBIRD.jpg";
+
+			const std::pair<TF::ShapeOrder, const TCHAR*> orders[] =
+			{
+				{ TF::ShapeOrder::HeightWidthChannels, TEXT("HWC") },
+				{ TF::ShapeOrder::WidthHeightChannels, TEXT("WHC") },
+				{ TF::ShapeOrder::ChannelsHeightWidth, TEXT("CHW") },
+				{ TF::ShapeOrder::ChannelsWidthHeight, TEXT("CWH") },
+			};
+
+			// The decode dominates, the difference to HWC (a plain copy) is the cost of repacking
+			for (const auto& [order, name] : orders)
+			{
+				TF::ImageTensorLoader image_loader(260,
+												   260,
+												   3,
+												   true,
+												   TF::ChannelOrder::RGB,
+												   order);
+
+				cppflow::tensor tensor;
+				const double start_s = FPlatformTime::Seconds();
+				for (uint32_t i = 0; i < Iterations; ++i)
+				{
+					if (!TestTrue(TEXT("Failed To Load Image!"), image_loader.Load(imgPath_str, tensor)))
+						return;
+				}
+				const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+				TestEqual(TEXT("Tensor Size Mismatch!"), tensor.get_data<float>().size(), size_t(260 * 260 * 3));
+
+				AddInfo(FString::Printf(TEXT("Image Load (%s): %.3f ms/image"), name, elapsed_s * 1000.0 / Iterations));
+			}
+		});
+
+		It("(21) Batched Image Loading", [this]()
+		{
+			TF::MLModel model("BirdClassifier");
+
+			FString modelPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Models/bird-classifier/BirdClassifier.onnx"));
+			FString tempOutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Models"));
+			model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+						   TCHAR_TO_UTF8(*tempOutputDir));
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/test_bird_dataset/"));
+			std::string dataPath_str = TCHAR_TO_UTF8(*dataPath);
+
+			const std::vector<std::string> image_paths =
+			{
+				dataPath_str + "/31/ANNAS HUMMINGBIRD.jpg",
+				dataPath_str + "/158/COMMON HOUSE MARTIN.jpg",
+				dataPath_str + "/306/IVORY GULL.jpg"
+			};
+
+			TF::LabeledTensor batch_inputs;
+			if (!TestTrue(TEXT("Failed To Load Image Batch!"), image_loader.LoadBatch(image_paths, batch_inputs["pixel_values"])))
+				return;
+
+			TestEqual(TEXT("Batch Dimension Mismatch!"), batch_inputs["pixel_values"].shape().get_data<int64_t>()[0], int64_t(image_paths.size()));
+
+			// A single run classifies the whole batch
+			TF::LabeledTensor batch_results;
+			if (!TestTrue(TEXT("Failed To Run Batch!"), model.Run(batch_inputs, batch_results)))
+				return;
+
+			const std::vector<float> batch_output = batch_results.begin()->second.get_data<float>();
+			const size_t classes = batch_output.size() / image_paths.size();
+
+			for (size_t i = 0; i < image_paths.size(); ++i)
+			{
+				TF::LabeledTensor inputs;
+				if (!TestTrue(TEXT("Failed To Load Image!"), image_loader.Load(image_paths[i], inputs["pixel_values"])))
+					return;
+
+				TF::LabeledTensor results;
+				if (!TestTrue(TEXT("Failed To Run Image!"), model.Run(inputs, results)))
+					return;
+
+				const std::vector<float> output = results.begin()->second.get_data<float>();
+				for (size_t c = 0; c < classes; ++c)
+				{
+					if (!TestEqual(TEXT("Batched Result Mismatch!"), batch_output[i * classes + c], output[c], 1e-4f))
+						return;
+				}
+			}
+		});
+
+		It("(22) In Memory Image Loading", [this]()
+		{
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/"));
+			FString imgPath = FPaths::Combine(dataPath, TEXT("test_bird_dataset/31/ANNAS HUMMINGBIRD.jpg"));
+
+			// Encoded bytes decode to the same tensor as the file
+			{
+				TF::ImageTensorLoader image_loader(260,
+												   260,
+												   3,
+												   true,
+												   TF::ChannelOrder::RGB,
+												   TF::ShapeOrder::ChannelsHeightWidth);
+
+				TArray<uint8> encoded;
+				if (!TestTrue(TEXT("Failed To Read Image File!"), FFileHelper::LoadFileToArray(encoded, *imgPath)))
+					return;
+
+				cppflow::tensor from_file;
+				cppflow::tensor from_bytes;
+				if (!TestTrue(TEXT("Failed To Load Image!"), image_loader.Load(TCHAR_TO_UTF8(*imgPath), from_file)))
+					return;
+				if (!TestTrue(TEXT("Failed To Decode Image!"), image_loader.Load(encoded.GetData(), encoded.Num(), from_bytes)))
+					return;
+
+				TestTrue(TEXT("Decoded Tensor Mismatch!"), from_file.get_data<float>() == from_bytes.get_data<float>());
+			}
+
+			// Raw FColor pixels (BGRA) pass through unchanged at their native size
+			{
+				static constexpr int32 Width = 64;
+				static constexpr int32 Height = 48;
+				static constexpr int32 Padding = 16;
+
+				TF::ImageTensorLoader image_loader(Width,
+												   Height,
+												   4,
+												   false,
+												   TF::ChannelOrder::BGRA,
+												   TF::ShapeOrder::HeightWidthChannels);
+
+				TArray<FColor> colors;
+				colors.SetNum(Width * Height);
+				for (int32 y = 0; y < Height; ++y)
+				{
+					for (int32 x = 0; x < Width; ++x)
+						colors[y * Width + x] = FColor(x * 4, y * 5, (x + y) % 256, 255 - x);
+				}
+
+				// The same pixels with padded rows, as in a locked texture mip
+				const int32 stride = Width * sizeof(FColor) + Padding;
+				TArray<uint8> padded;
+				padded.SetNumZeroed(stride * Height);
+				for (int32 y = 0; y < Height; ++y)
+					FMemory::Memcpy(padded.GetData() + y * stride, colors.GetData() + y * Width, Width * sizeof(FColor));
+
+				const uint8_t* pixels = reinterpret_cast<const uint8_t*>(colors.GetData());
+
+				cppflow::tensor packed_tensor;
+				cppflow::tensor padded_tensor;
+				if (!TestTrue(TEXT("Failed To Load Pixels!"), image_loader.Load(pixels, Width, Height, 4, 0, packed_tensor)))
+					return;
+				if (!TestTrue(TEXT("Failed To Load Padded Pixels!"), image_loader.Load(padded.GetData(), Width, Height, 4, stride, padded_tensor)))
+					return;
+
+				const std::vector<float> values = packed_tensor.get_data<float>();
+				if (!TestEqual(TEXT("Tensor Size Mismatch!"), values.size(), size_t(Width * Height * 4)))
+					return;
+
+				for (size_t i = 0; i < values.size(); ++i)
+				{
+					if (!TestEqual(TEXT("Pixel Value Mismatch!"), values[i], static_cast<float>(pixels[i])))
+						return;
+				}
+
+				TestTrue(TEXT("Padded Tensor Mismatch!"), values == padded_tensor.get_data<float>());
+				TestFalse(TEXT("Stride Smaller Than A Row Accepted!"), image_loader.Load(pixels, Width, Height, 4, Width, packed_tensor));
+			}
+		});
+
+		It("(23) Fused Image Normalization", [this]()
+		{
+			static constexpr uint32_t Iterations = 20;
+
+			// ImageNet statistics, as used by most pretrained vision models
+			const std::vector<float> mean = { 0.485f, 0.456f, 0.406f };
+			const std::vector<float> std_dev = { 0.229f, 0.224f, 0.225f };
+
+			// At the native size the values are the normalized source pixels
+			{
+				static constexpr int32 Width = 32;
+				static constexpr int32 Height = 16;
+
+				TF::ImageTensorLoader image_loader(Width,
+												   Height,
+												   3,
+												   true,
+												   TF::ChannelOrder::BGR,
+												   TF::ShapeOrder::ChannelsHeightWidth);
+				image_loader.SetNormalization(mean, std_dev);
+
+				std::vector<uint8_t> pixels(Width * Height * 3);
+				for (size_t i = 0; i < pixels.size(); ++i)
+					pixels[i] = static_cast<uint8_t>(i * 7);
+
+				cppflow::tensor tensor;
+				if (!TestTrue(TEXT("Failed To Load Pixels!"), image_loader.Load(pixels.data(), Width, Height, 3, 0, tensor)))
+					return;
+
+				const std::vector<float> values = tensor.get_data<float>();
+				for (int32 c = 0; c < 3; ++c)
+				{
+					for (int32 i = 0; i < Width * Height; ++i)
+					{
+						const float expected = (pixels[i * 3 + c] / 255.0f - mean[c]) / std_dev[c];
+						if (!TestEqual(TEXT("Normalized Value Mismatch!"), values[c * Width * Height + i], expected, 1e-5f))
+							return;
+					}
+				}
+			}
+
+			// A camera frame is read once and written straight into the tensor
+			{
+				static constexpr int32 FrameWidth = 1920;
+				static constexpr int32 FrameHeight = 1080;
+
+				TF::ImageTensorLoader image_loader(260,
+												   260,
+												   3,
+												   true,
+												   TF::ChannelOrder::RGB,
+												   TF::ShapeOrder::ChannelsHeightWidth);
+				image_loader.SetNormalization(mean, std_dev);
+
+				TArray<FColor> frame;
+				frame.Init(FColor(32, 64, 128, 255), FrameWidth * FrameHeight);
+
+				cppflow::tensor tensor;
+				const double start_s = FPlatformTime::Seconds();
+				for (uint32_t i = 0; i < Iterations; ++i)
+				{
+					if (!TestTrue(TEXT("Failed To Load Frame!"), image_loader.Load(reinterpret_cast<const uint8_t*>(frame.GetData()), FrameWidth, FrameHeight, 4, 0, tensor)))
+						return;
+				}
+				const double elapsed_s = FPlatformTime::Seconds() - start_s;
+
+				TestEqual(TEXT("Tensor Size Mismatch!"), tensor.get_data<float>().size(), size_t(260 * 260 * 3));
+
+				AddInfo(FString::Printf(TEXT("1080p Frame To 260x260 CHW: %.3f ms/frame"), elapsed_s * 1000.0 / Iterations));
+			}
+		});
+
+		It("(24) Reduced Resolution JPEG Decode", [this]()
+		{
+			static constexpr uint32_t Iterations = 10;
+			static constexpr int32 Size = 2080; /* 8x the tensor size */
+
+			// A smooth photo-like gradient, encoded as a large JPEG
+			TArray<FColor> colors;
+			colors.SetNum(Size * Size);
+			for (int32 y = 0; y < Size; ++y)
+			{
+				for (int32 x = 0; x < Size; ++x)
+					colors[y * Size + x] = FColor(x * 255 / Size, y * 255 / Size, (x + y) * 255 / (2 * Size), 255);
+			}
+
+			IImageWrapperModule& image_wrapper_module = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+			TSharedPtr<IImageWrapper> image_wrapper = image_wrapper_module.CreateImageWrapper(EImageFormat::JPEG);
+			if (!TestTrue(TEXT("Failed To Set Image Pixels!"), image_wrapper->SetRaw(colors.GetData(), colors.Num() * sizeof(FColor), Size, Size, ERGBFormat::BGRA, 8)))
+				return;
+
+			const TArray64<uint8> encoded = image_wrapper->GetCompressed(95);
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			const auto DecodeAll = [&](float oversampling, cppflow::tensor& tensor)
+			{
+				image_loader.SetDecodeOversampling(oversampling);
+
+				const double start_s = FPlatformTime::Seconds();
+				for (uint32_t i = 0; i < Iterations; ++i)
+				{
+					if (!image_loader.Load(encoded.GetData(), static_cast<size_t>(encoded.Num()), tensor))
+						return -1.0;
+				}
+				return (FPlatformTime::Seconds() - start_s) * 1000.0 / Iterations;
+			};
+
+			cppflow::tensor full_tensor;
+			cppflow::tensor reduced_tensor;
+			const double full_ms = DecodeAll(0.0f, full_tensor);
+			const double reduced_ms = DecodeAll(1.0f, reduced_tensor);
+			if (!TestTrue(TEXT("Failed To Decode Image!"), full_ms >= 0.0 && reduced_ms >= 0.0))
+				return;
+
+			const std::vector<float> full_values = full_tensor.get_data<float>();
+			const std::vector<float> reduced_values = reduced_tensor.get_data<float>();
+			if (!TestEqual(TEXT("Tensor Size Mismatch!"), reduced_values.size(), full_values.size()))
+				return;
+
+			double total_error = 0.0;
+			for (size_t i = 0; i < full_values.size(); ++i)
+				total_error += std::abs(full_values[i] - reduced_values[i]);
+
+			const double mean_error = total_error / full_values.size();
+			TestTrue(TEXT("Reduced Decode Outside Quality Tolerance!"), mean_error < 0.02);
+
+			AddInfo(FString::Printf(TEXT("JPEG %dx%d To 260x260: Full %.3f ms, Reduced %.3f ms, Mean Error %.4f"), Size, Size, full_ms, reduced_ms, mean_error));
+		});
+
+		It("(25) Preprocessed Image Cache", [this]()
+		{
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/test_bird_dataset/"));
+			std::string dataPath_str = TCHAR_TO_UTF8(*dataPath);
+
+			FString cachePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/ImageCacheTest"));
+			std::string cachePath_str = TCHAR_TO_UTF8(*cachePath);
+			std::filesystem::remove_all(cachePath_str);
+
+			const std::vector<std::string> image_paths =
+			{
+				dataPath_str + "/31/ANNAS HUMMINGBIRD.jpg",
+				dataPath_str + "/158/COMMON HOUSE MARTIN.jpg",
+				dataPath_str + "/306/IVORY GULL.jpg"
+			};
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			// Reference without a cache
+			cppflow::tensor uncached;
+			if (!TestTrue(TEXT("Failed To Load Image Batch!"), image_loader.LoadBatch(image_paths, uncached)))
+				return;
+
+			auto cache = std::make_shared<TF::DiskCache>(cachePath_str, 64ull * 1024 * 1024);
+			image_loader.SetCache(cache);
+
+			cppflow::tensor cold;
+			double start_s = FPlatformTime::Seconds();
+			if (!TestTrue(TEXT("Failed To Load Cold Batch!"), image_loader.LoadBatch(image_paths, cold)))
+				return;
+			const double cold_ms = (FPlatformTime::Seconds() - start_s) * 1000.0;
+
+			cppflow::tensor warm;
+			start_s = FPlatformTime::Seconds();
+			if (!TestTrue(TEXT("Failed To Load Warm Batch!"), image_loader.LoadBatch(image_paths, warm)))
+				return;
+			const double warm_ms = (FPlatformTime::Seconds() - start_s) * 1000.0;
+
+			TestTrue(TEXT("Cold Tensor Mismatch!"), cold.get_data<float>() == uncached.get_data<float>());
+			TestTrue(TEXT("Warm Tensor Mismatch!"), warm.get_data<float>() == uncached.get_data<float>());
+
+			size_t entry_count = 0;
+			for (const auto& entry : std::filesystem::directory_iterator(cachePath_str))
+				entry_count += entry.is_regular_file() ? 1 : 0;
+			TestEqual(TEXT("Cache Entry Count Mismatch!"), entry_count, image_paths.size());
+
+			// A different configuration must not reuse the entries
+			TF::ImageTensorLoader gray_loader(260,
+											  260,
+											  1,
+											  true,
+											  TF::ChannelOrder::GrayScale,
+											  TF::ShapeOrder::ChannelsHeightWidth);
+			gray_loader.SetCache(cache);
+
+			cppflow::tensor gray;
+			if (!TestTrue(TEXT("Failed To Load Gray Image!"), gray_loader.Load(image_paths[0], gray)))
+				return;
+			TestEqual(TEXT("Gray Tensor Size Mismatch!"), gray.get_data<float>().size(), size_t(260 * 260));
+
+			// The size cap evicts down to a single entry (~270 KB each for 260x260x3)
+			cache->SetSizeLimit(300 * 1024);
+
+			uint64_t cache_bytes = 0;
+			for (const auto& entry : std::filesystem::directory_iterator(cachePath_str))
+				cache_bytes += entry.is_regular_file() ? entry.file_size() : 0;
+			TestTrue(TEXT("Cache Exceeds Size Limit!"), cache_bytes <= 300 * 1024);
+
+			AddInfo(FString::Printf(TEXT("Batch Of %d: Cold %.3f ms, Warm %.3f ms"), static_cast<int32>(image_paths.size()), cold_ms, warm_ms));
+
+			std::filesystem::remove_all(cachePath_str);
+		});
+
+		It("(26) UInt8 Image Tensors", [this]()
+		{
+			static constexpr int32 Width = 64;
+			static constexpr int32 Height = 48;
+
+			TF::MLModel model("uint8_image");
+			model.AddInput("image", 
+						   TF::DataType::UInt8, 
+						   { -1, Height, Width, 4 }, 
+						   TF::DomainType::Image);
+
+			TF::DataType input_type = TF::DataType::Float32;
+			if (!TestTrue(TEXT("Input Type Not Found!"), model.GetInputType("image", input_type)))
+				return;
+
+			TF::ImageTensorLoader image_loader(Width,
+											   Height,
+											   4,
+											   false,
+											   TF::ChannelOrder::BGRA,
+											   TF::ShapeOrder::HeightWidthChannels);
+			image_loader.SetDataType(input_type);
+
+			TArray<FColor> colors;
+			colors.SetNum(Width * Height);
+			for (int32 i = 0; i < colors.Num(); ++i)
+				colors[i] = FColor(i % 256, (i / 3) % 256, (i / 7) % 256, 255);
+
+			const uint8_t* pixels = reinterpret_cast<const uint8_t*>(colors.GetData());
+
+			// At the tensor size the bytes pass through untouched
+			cppflow::tensor tensor;
+			if (!TestTrue(TEXT("Failed To Load Pixels!"), image_loader.Load(pixels, Width, Height, 4, 0, tensor)))
+				return;
+
+			TestEqual(TEXT("Tensor Type Mismatch!"), tensor.dtype(), TF_UINT8);
+
+			const std::vector<uint8_t> values = tensor.get_data<uint8_t>();
+			TestTrue(TEXT("Raw Pixel Mismatch!"), values.size() == size_t(colors.Num() * 4) && 
+												  std::memcmp(values.data(), pixels, values.size()) == 0);
+
+			// Resized bytes are the rounded values of the float path
+			TF::ImageTensorLoader float_loader(Width / 2,
+											   Height / 2,
+											   3,
+											   false,
+											   TF::ChannelOrder::BGR,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+			TF::ImageTensorLoader byte_loader = float_loader;
+			byte_loader.SetDataType(TF::DataType::UInt8);
+
+			cppflow::tensor float_tensor;
+			cppflow::tensor byte_tensor;
+			if (!TestTrue(TEXT("Failed To Load Float Pixels!"), float_loader.Load(pixels, Width, Height, 4, 0, float_tensor)) ||
+				!TestTrue(TEXT("Failed To Load Byte Pixels!"), byte_loader.Load(pixels, Width, Height, 4, 0, byte_tensor)))
+			{
+				return;
+			}
+
+			const std::vector<float> float_values = float_tensor.get_data<float>();
+			const std::vector<uint8_t> byte_values = byte_tensor.get_data<uint8_t>();
+			if (!TestEqual(TEXT("Tensor Size Mismatch!"), byte_values.size(), float_values.size()))
+				return;
+
+			for (size_t i = 0; i < byte_values.size(); ++i)
+			{
+				if (!TestEqual(TEXT("Resized Byte Mismatch!"), static_cast<int32>(byte_values[i]), static_cast<int32>(FMath::RoundToInt(float_values[i]))))
+					return;
+			}
+		});
+
+		It("(27) Streaming Video Pipeline", [this]()
+		{
+			static constexpr int32 FrameWidth = 640;
+			static constexpr int32 FrameHeight = 480;
+			static constexpr uint32_t FrameCount = 24;
+
+			TF::MLModel model("BirdClassifier");
+
+			FString modelPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Models/bird-classifier/BirdClassifier.onnx"));
+			FString tempOutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Models"));
+			model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+						   TCHAR_TO_UTF8(*tempOutputDir));
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			TF::VideoPipelineConfig config;
+			config.mInputName = "pixel_values";
+			config.mBatchSize = 4;
+			config.mDropPolicy = TF::FrameDropPolicy::Block;
+
+			std::mutex results_mutex;
+			std::vector<uint64_t> frame_indices;
+			bool rows_match = true;
+
+			TF::VideoPipeline pipeline(model, image_loader, config, [&](const TF::VideoBatchResult& result)
+			{
+				const std::scoped_lock lock(results_mutex);
+				for (const auto& [name, tensor] : result.mOutputs)
+				{
+					const std::vector<int64_t> shape = tensor.shape().get_data<int64_t>();
+					rows_match &= !shape.empty() && shape[0] == static_cast<int64_t>(result.mFrames.size());
+				}
+
+				for (const TF::VideoFrameInfo& frame : result.mFrames)
+					frame_indices.push_back(frame.mIndex);
+			});
+
+			if (!TestTrue(TEXT("Failed To Start Pipeline!"), pipeline.Start()))
+				return;
+
+			TArray<FColor> frame;
+			frame.SetNum(FrameWidth * FrameHeight);
+			for (uint32_t i = 0; i < FrameCount; ++i)
+			{
+				for (int32 p = 0; p < frame.Num(); ++p)
+					frame[p] = FColor((p + i * 8) % 256, (p / FrameWidth) % 256, i * 10 % 256, 255);
+
+				TestTrue(TEXT("Frame Not Queued!"), pipeline.PushFrame(reinterpret_cast<const uint8_t*>(frame.GetData()), FrameWidth, FrameHeight, 4));
+			}
+
+			pipeline.Finish();
+
+			const TF::VideoPipelineStats stats = pipeline.GetStats();
+			TestEqual(TEXT("Frames Lost!"), frame_indices.size(), size_t(FrameCount));
+			TestEqual(TEXT("Frames Dropped Under Backpressure!"), stats.mDroppedFrames, uint64_t(0));
+			TestEqual(TEXT("Frames Failed!"), stats.mFailedFrames, uint64_t(0));
+			TestTrue(TEXT("Output Rows Do Not Match The Batch!"), rows_match);
+
+			std::sort(frame_indices.begin(), frame_indices.end());
+			for (uint32_t i = 0; i < frame_indices.size(); ++i)
+			{
+				if (!TestEqual(TEXT("Frame Index Mismatch!"), frame_indices[i], uint64_t(i)))
+					return;
+			}
+
+			const auto Report = [this](const TCHAR* stage, const TF::VideoStageStats& stage_stats)
+			{
+				AddInfo(FString::Printf(TEXT("%s: %.1f frames/s, %.3f ms avg, %.3f ms max"), 
+										stage, stage_stats.mThroughput, stage_stats.mAverageLatency_ms, stage_stats.mMaxLatency_ms));
+			};
+
+			Report(TEXT("Source"), stats.mSource);
+			Report(TEXT("Preprocess"), stats.mPreprocess);
+			Report(TEXT("Inference"), stats.mInference);
+			Report(TEXT("Postprocess"), stats.mPostprocess);
+			Report(TEXT("End To End"), stats.mEndToEnd);
+		});
+
+		It("(28) Tiled Inference", [this]()
+		{
+			static constexpr int32 ImageWidth = 640;
+			static constexpr int32 ImageHeight = 480;
+
+			TF::MLModel model("BirdClassifier");
+
+			FString modelPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Models/bird-classifier/BirdClassifier.onnx"));
+			FString tempOutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Models"));
+			model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+						   TCHAR_TO_UTF8(*tempOutputDir));
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			TF::TiledInferenceConfig config;
+			config.mInputName = "pixel_values";
+			config.mTileWidth = 260;
+			config.mTileHeight = 260;
+			config.mStrideX = 190;
+			config.mStrideY = 190;
+			config.mCacheCapacity = 64;
+
+			TF::TiledInference tiler(model, image_loader, config);
+
+			TArray<FColor> image;
+			image.SetNum(ImageWidth * ImageHeight);
+			for (int32 p = 0; p < image.Num(); ++p)
+				image[p] = FColor(p % 256, (p / ImageWidth) % 256, (p * 7) % 256, 255);
+
+			const uint8_t* pixels = reinterpret_cast<const uint8_t*>(image.GetData());
+
+			// Columns at 0, 190 and the edge aligned 380, rows at 0, 190 and the edge aligned 220
+			TF::TiledInferenceResult result;
+			if (!TestTrue(TEXT("Tiled Inference Failed!"), tiler.Run(pixels, ImageWidth, ImageHeight, 4, 0, result)))
+				return;
+
+			TestEqual(TEXT("Tile Count Mismatch!"), result.mTiles.size(), size_t(9));
+			TestEqual(TEXT("Tiles Cached On First Run!"), result.mCachedTiles, uint32_t(0));
+
+			const TF::ImageTile& last_tile = result.mTiles.back();
+			TestEqual(TEXT("Last Column Not Aligned To The Edge!"), last_tile.mX + last_tile.mWidth, uint32_t(ImageWidth));
+			TestEqual(TEXT("Last Row Not Aligned To The Edge!"), last_tile.mY + last_tile.mHeight, uint32_t(ImageHeight));
+
+			// Every tile of the batch matches the tile run on its own
+			for (const TF::ImageTile& tile : result.mTiles)
+			{
+				cppflow::tensor tile_tensor;
+				const uint8_t* tile_pixels = pixels + (static_cast<size_t>(tile.mY) * ImageWidth + tile.mX) * 4;
+				if (!TestTrue(TEXT("Failed To Load Tile!"), image_loader.Load(tile_pixels, tile.mWidth, tile.mHeight, 4, ImageWidth * 4, tile_tensor)))
+					return;
+
+				TF::LabeledTensor inputs;
+				inputs["pixel_values"] = tile_tensor;
+
+				TF::LabeledTensor outputs;
+				if (!TestTrue(TEXT("Failed To Run Tile!"), model.Run(inputs, outputs)))
+					return;
+
+				for (const auto& [name, tensor] : outputs)
+				{
+					const std::vector<float> expected = tensor.get_data<float>();
+					const std::vector<float>& actual = tile.mOutputs.at(name);
+					if (!TestEqual(TEXT("Tile Output Size Mismatch!"), actual.size(), expected.size()))
+						return;
+
+					for (size_t i = 0; i < expected.size(); ++i)
+					{
+						if (!TestEqual(TEXT("Tile Output Mismatch!"), actual[i], expected[i], 1e-3f))
+							return;
+					}
+				}
+			}
+
+			// Unchanged tiles are not run again
+			TF::TiledInferenceResult cached_result;
+			TestTrue(TEXT("Cached Tiled Inference Failed!"), tiler.Run(pixels, ImageWidth, ImageHeight, 4, 0, cached_result));
+			TestEqual(TEXT("Unchanged Tiles Not Cached!"), cached_result.mCachedTiles, uint32_t(result.mTiles.size()));
+
+			// Only the tiles covering a changed pixel are run
+			image[0] = FColor::Black;
+
+			TF::TiledInferenceResult changed_result;
+			TestTrue(TEXT("Changed Tiled Inference Failed!"), tiler.Run(pixels, ImageWidth, ImageHeight, 4, 0, changed_result));
+			TestEqual(TEXT("Changed Tile Not Run!"), changed_result.mCachedTiles, uint32_t(result.mTiles.size() - 1));
+			TestFalse(TEXT("Changed Tile Taken From Cache!"), changed_result.mTiles.front().mFromCache);
+		});
+
+		It("(29) Image Folder Dataset", [this]()
+		{
+			FString dataPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Data/"));
+			const std::filesystem::path data_path = TCHAR_TO_UTF8(*dataPath);
+			const std::filesystem::path dataset_root = data_path / "test_bird_dataset";
+			const std::filesystem::path label_map_path = data_path / "bird_label_map.json";
+
+			const FString indexDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/DatasetIndex"));
+			const std::filesystem::path index_path = std::filesystem::path(TCHAR_TO_UTF8(*indexDir)) / "birds.index";
+			std::filesystem::remove_all(index_path.parent_path());
+
+			TF::ImageFolderDataset dataset;
+			if (!TestTrue(TEXT("Failed To Open Dataset!"), dataset.Open(dataset_root, index_path, label_map_path)))
+				return;
+
+			TestTrue(TEXT("Index Not Written!"), std::filesystem::exists(index_path));
+			TestEqual(TEXT("Sample Count Mismatch!"), dataset.GetSize(), size_t(3));
+			TestEqual(TEXT("Class Count Mismatch!"), dataset.GetClassCount(), uint32_t(525));
+
+			// Class folders are named by label
+			for (size_t i = 0; i < dataset.GetSize(); ++i)
+			{
+				const std::filesystem::path path = dataset.GetPath(i);
+				TestTrue(TEXT("Image Path Does Not Exist!"), std::filesystem::exists(path));
+				TestEqual(TEXT("Label Mismatch!"), std::to_string(dataset.GetLabel(i)), path.parent_path().filename().string());
+			}
+			TestEqual(TEXT("Class Name Mismatch!"), dataset.GetClassNames()[31], std::string("ANNAS HUMMINGBIRD"));
+
+			// An unchanged dataset is read from the index
+			const auto index_time = std::filesystem::last_write_time(index_path);
+
+			TF::ImageFolderDataset indexed;
+			TestTrue(TEXT("Failed To Reopen Dataset!"), indexed.Open(dataset_root, index_path, label_map_path));
+			TestTrue(TEXT("Index Rewritten!"), std::filesystem::last_write_time(index_path) == index_time);
+			TestEqual(TEXT("Indexed Sample Count Mismatch!"), indexed.GetSize(), dataset.GetSize());
+
+			// Shuffling only depends on the seed
+			TF::ImageFolderDataset shuffled = indexed;
+			TF::ImageFolderDataset reshuffled = indexed;
+			shuffled.Shuffle(42);
+			reshuffled.Shuffle(42);
+			for (size_t i = 0; i < shuffled.GetSize(); ++i)
+				TestEqual(TEXT("Shuffle Not Deterministic!"), std::string(shuffled.GetRelativePath(i)), std::string(reshuffled.GetRelativePath(i)));
+
+			// The shards partition the dataset
+			std::set<std::string> sharded_paths;
+			for (uint32_t shard_index = 0; shard_index < 2; ++shard_index)
+			{
+				const TF::ImageFolderDataset shard = shuffled.GetShard(shard_index, 2);
+				for (size_t i = 0; i < shard.GetSize(); ++i)
+					sharded_paths.insert(std::string(shard.GetRelativePath(i)));
+			}
+			TestEqual(TEXT("Shards Do Not Partition The Dataset!"), sharded_paths.size(), dataset.GetSize());
+
+			// Training reads the index instead of a path per sample
+			TF::MLModel model("image_dataset");
+
+			model.AddInput("image", 
+						   TF::DataType::Float32, 
+						   { -1, 32, 32, 3 },
+						   TF::DomainType::Image);
+
+			model.AddOutput("y");
+
+			model.AddLayer(TF::LayerType::Flatten,
+			{
+				{ "input_name", "image" },
+				{ "output_name", "flat_input" }
+			});
+
+			model.AddLayer(TF::LayerType::Dense,
+			{
+				{ "input_name", "flat_input" },
+				{ "units", 525 },
+				{ "output_name", "y" },
+			});
+
+			if (!TestTrue(TEXT("Failed To Create Model!"), model.CreateModel()))
+				return;
+
+			TestFalse(TEXT("Dataset For Unknown Label Accepted!"), model.AddImageDataset("image", shuffled, "flat_input"));
+
+			if (!TestTrue(TEXT("Failed To Add Dataset!"), model.AddImageDataset("image", shuffled, "y")))
+				return;
+
+			TestEqual(TEXT("Dataset Samples Not Counted!"), model.GetSupervisedSampleCount(), uint64_t(dataset.GetSize()));
+
+			TF::TrainingConfig config;
+			config.epochs = 1;
+			config.batch_size = 2;
+
+			TestTrue(TEXT("Failed To Train From Dataset!"), model.TrainModel(config));
+			TestEqual(TEXT("Dataset Not Consumed!"), model.GetSupervisedSampleCount(), uint64_t(0));
+		});
+
+		It("(30) Replay Priorities Of Overwritten Transitions", [this]()
+		{
+			TF::ReplayBuffer buffer(4, true);
+			buffer.Seed(11);
+
+			const std::vector<float> action = { 0.0f };
+			const std::vector<float> next_state = { 0.0f };
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				const std::vector<float> state = { static_cast<float>(i) };
+				if (!TestTrue(TEXT("Failed To Add Transition!"), buffer.Add(state, action, 1.0f, next_state, false)))
+					return;
+			}
+
+			TF::ReplayBatch batch;
+			if (!TestTrue(TEXT("Failed To Sample Replay Buffer!"), buffer.Sample(4, batch)))
+				return;
+
+			// A new transition overwrites the oldest slot while the batch is being trained on
+			static constexpr float NewState = 100.0f;
+			const std::vector<float> new_state = { NewState };
+			if (!TestTrue(TEXT("Failed To Add Transition!"), buffer.Add(new_state, action, 1.0f, next_state, false)))
+				return;
+
+			// Near zero errors for the drawn transitions must not lower the priority of the new one
+			buffer.UpdatePriorities(batch, std::vector<float>(batch.mIndices.size(), 0.0f));
+
+			TF::ReplayBatch prioritized_batch;
+			if (!TestTrue(TEXT("Failed To Sample Replay Buffer!"), buffer.Sample(1000, prioritized_batch)))
+				return;
+
+			uint32_t new_count = 0;
+			for (size_t i = 0; i < prioritized_batch.mIndices.size(); ++i)
+			{
+				if (prioritized_batch.mStates[i] == NewState)
+					++new_count;
+			}
+
+			TestTrue(TEXT("Overwritten Transition Lost Its Priority!"), new_count > 900);
+		});
+
+		It("(31) Video File Pipeline", [this]()
+		{
+			static constexpr int32 FrameWidth = 320;
+			static constexpr int32 FrameHeight = 240;
+			static constexpr uint32_t FrameCount = 12;
+
+			// Motion JPEG is encoded by OpenCV itself, no codec backend is required
+			const FString videoDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Video"));
+			const std::filesystem::path video_path = std::filesystem::path(TCHAR_TO_UTF8(*videoDir)) / "frames.avi";
+			std::filesystem::create_directories(video_path.parent_path());
+			{
+				cv::VideoWriter writer(video_path.string(), cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 10.0, cv::Size(FrameWidth, FrameHeight));
+				if (!TestTrue(TEXT("Failed To Write Test Video!"), writer.isOpened()))
+					return;
+
+				for (uint32_t i = 0; i < FrameCount; ++i)
+					writer.write(cv::Mat(FrameHeight, FrameWidth, CV_8UC3, cv::Scalar(i * 20, 128, 255 - i * 20)));
+			}
+
+			TF::MLModel model("BirdClassifier");
+
+			FString modelPath = FPaths::Combine(ModuleDirectory, TEXT("UnitTest/Models/bird-classifier/BirdClassifier.onnx"));
+			FString tempOutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/Models"));
+			model.LoadFrom(TCHAR_TO_UTF8(*modelPath),
+						   TCHAR_TO_UTF8(*tempOutputDir));
+
+			TF::ImageTensorLoader image_loader(260,
+											   260,
+											   3,
+											   true,
+											   TF::ChannelOrder::RGB,
+											   TF::ShapeOrder::ChannelsHeightWidth);
+
+			TF::VideoPipelineConfig config;
+			config.mInputName = "pixel_values";
+			config.mBatchSize = 4;
+			config.mDropPolicy = TF::FrameDropPolicy::Block;
+
+			std::mutex results_mutex;
+			size_t frame_count = 0;
+
+			TF::VideoPipeline pipeline(model, image_loader, config, [&](const TF::VideoBatchResult& result)
+			{
+				const std::scoped_lock lock(results_mutex);
+				frame_count += result.mFrames.size();
+			});
+
+			TestFalse(TEXT("Missing Video Started!"), pipeline.StartVideo((video_path.parent_path() / "missing.avi").string()));
+			TestFalse(TEXT("Pipeline Running Without A Video!"), pipeline.IsRunning());
+
+			if (!TestTrue(TEXT("Failed To Start Video!"), pipeline.StartVideo(video_path.string())))
+				return;
+
+			pipeline.Finish();
+
+			const TF::VideoPipelineStats stats = pipeline.GetStats();
+			TestEqual(TEXT("Video Frames Lost!"), frame_count, size_t(FrameCount));
+			TestEqual(TEXT("Frames Failed!"), stats.mFailedFrames, uint64_t(0));
+		});
+
+		It("(32) Typed Training Rows", [this]()
+		{
+			TF::MLModel model("typed_rows");
+
+			model.AddInput("x", 
+						   TF::DataType::Float32, 
+						   { -1, 4, 1 });
+
+			model.AddOutput("y");
+
+			const std::vector<float> input = { 5.1f, 3.5f, 1.4f, 0.2f };
+			const std::vector<float> label = { 1.0f, 0.0f };
+			if (!TestTrue(TEXT("Failed To Add Typed Row!"), model.AddSupervisedTrainingRow("x", input, "y", label)))
+				return;
+
+			// Rows of another width are rejected by the layout or the previous rows
+			const std::vector<float> short_input = { 5.1f, 3.5f, 1.4f };
+			const std::vector<float> wide_label = { 1.0f, 0.0f, 0.0f };
+			TestFalse(TEXT("Short Input Row Accepted!"), model.AddSupervisedTrainingRow("x", short_input, "y", label));
+			TestFalse(TEXT("Wide Label Row Accepted!"), model.AddSupervisedTrainingRow("x", input, "y", wide_label));
+
+			// JSON samples are stored in the same typed columns
+			if (!TestTrue(TEXT("Failed To Add JSON Sample!"), model.AddSupervisedTrainingData("x", 
+																							   { 4.9f, 3.0f, 1.4f, 0.2f }, 
+																							   "y", 
+																							   { 0.0f, 1.0f })))
+				return;
+
+			TestEqual(TEXT("Sample Count Mismatch!"), model.GetSupervisedSampleCount(), uint64_t(2));
+
+			model.mTrainingShards.ForLocalShard([&](TF::LabeledTrainingBatch& supervised_batch, TF::RewardTrainingBatch&)
+			{
+				const TF::TrainingColumn& input_column = supervised_batch.GetInput("x");
+				const TF::TrainingColumn& label_column = supervised_batch.GetLabel("y");
+
+				TestEqual(TEXT("Input Width Mismatch!"), input_column.mWidth, uint32_t(4));
+				TestEqual(TEXT("Label Width Mismatch!"), label_column.mWidth, uint32_t(2));
+				TestTrue(TEXT("Input Values Mismatch!"), input_column.mValues == std::vector<float>({ 5.1f, 3.5f, 1.4f, 0.2f, 4.9f, 3.0f, 1.4f, 0.2f }));
+				TestTrue(TEXT("Label Values Mismatch!"), label_column.mValues == std::vector<float>({ 1.0f, 0.0f, 0.0f, 1.0f }));
+			});
+		});
+
+		It("(33) Mismatched Batches Are Not Merged", [this]()
+		{
+			const std::vector<float> input = { 5.1f, 3.5f, 1.4f, 0.2f };
+			const std::vector<float> short_input = { 5.1f, 3.5f, 1.4f };
+			const std::vector<float> label = { 1.0f, 0.0f };
+
+			TF::LabeledTrainingBatch batch;
+			batch.GetInput("x").AppendRow(std::span<const float>(input));
+			batch.GetLabel("y").AppendRow(std::span<const float>(label));
+
+			TF::LabeledTrainingBatch other;
+			other.GetInput("x").AppendRow(std::span<const float>(short_input));
+			other.GetLabel("y").AppendRow(std::span<const float>(label));
+
+			// The compatible label column must not be appended without its input
+			TestFalse(TEXT("Mismatched Batch Appended!"), batch.Append(std::move(other)));
+			TestEqual(TEXT("Target Batch Modified!"), batch.GetRowCount(), uint64_t(1));
+			TestEqual(TEXT("Rejected Rows Dropped!"), other.GetRowCount(), uint64_t(1));
+			TestEqual(TEXT("Rejected Input Dropped!"), other.GetInput("x").mRows, uint64_t(1));
+
+			TF::LabeledTrainingBatch compatible;
+			compatible.GetInput("x").AppendRow(std::span<const float>(input));
+			compatible.GetLabel("y").AppendRow(std::span<const float>(label));
+
+			TestTrue(TEXT("Compatible Batch Rejected!"), batch.Append(std::move(compatible)));
+			TestEqual(TEXT("Row Count Mismatch!"), batch.GetRowCount(), uint64_t(2));
+			TestFalse(TEXT("Appended Batch Not Cleared!"), static_cast<bool>(compatible));
+		});
+
+		It("(34) Streamed Process Output", [this]()
+		{
+			std::mutex lines_mutex;
+			std::vector<std::string> out_lines;
+			std::vector<std::string> err_lines;
+
+			// The last line has no trailing newline and must still be delivered once the process exits
+			std::shared_ptr<ConsoleUtils::ProcessHandle> process = ConsoleUtils::ExecuteAsync(
+			{
+				"python", "-c",
+				"import sys; print('first'); print('second'); sys.stderr.write('warning\\n'); sys.stdout.write('last'); sys.exit(3)"
+			},
+			[&](const std::string& line, bool is_error)
+			{
+				const std::scoped_lock lock(lines_mutex);
+				(is_error ? err_lines : out_lines).push_back(line);
+			});
+
+			const ConsoleUtils::ProcessResult result = process->Wait();
+
+			TestFalse(TEXT("Process Still Running!"), process->IsRunning());
+			TestEqual(TEXT("Exit Code Mismatch!"), result.mExitCode, 3);
+			TestFalse(TEXT("Process Reported As Timed Out!"), result.mTimedOut);
+			TestFalse(TEXT("Process Reported As Cancelled!"), result.mCancelled);
+
+			const std::scoped_lock lock(lines_mutex);
+			TestTrue(TEXT("Stdout Lines Mismatch!"), out_lines == std::vector<std::string>({ "first", "second", "last" }));
+			TestTrue(TEXT("Stderr Lines Mismatch!"), err_lines == std::vector<std::string>({ "warning" }));
+		});
+
+		It("(35) Process Timeout", [this]()
+		{
+			const auto start = std::chrono::steady_clock::now();
+
+			std::shared_ptr<ConsoleUtils::ProcessHandle> process = ConsoleUtils::ExecuteAsync({ "python", "-c", "import time; time.sleep(30)" },
+																							  nullptr,
+																							  std::chrono::milliseconds(500));
+
+			const ConsoleUtils::ProcessResult result = process->Wait();
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+
+			TestTrue(TEXT("Process Not Reported As Timed Out!"), result.mTimedOut);
+			TestFalse(TEXT("Process Reported As Cancelled!"), result.mCancelled);
+			TestNotEqual(TEXT("Terminated Process Reported Success!"), result.mExitCode, 0);
+			TestTrue(TEXT("Process Not Terminated In Time!"), elapsed < std::chrono::seconds(10));
+		});
+
+		It("(36) Process Cancellation", [this]()
+		{
+			std::promise<void> started;
+			std::future<void> started_future = started.get_future();
+
+			std::shared_ptr<ConsoleUtils::ProcessHandle> process = ConsoleUtils::ExecuteAsync(
+			{
+				"python", "-u", "-c", "import time; print('sleeping'); time.sleep(30)"
+			},
+			[&started](const std::string& line, bool is_error)
+			{
+				if (!is_error && line == "sleeping")
+					started.set_value();
+			});
+
+			// Cancels only once the child is known to be asleep
+			if (!TestTrue(TEXT("Process Did Not Start!"), started_future.wait_for(std::chrono::seconds(10)) == std::future_status::ready))
+			{
+				process->Cancel();
+				process->Wait();
+				return;
+			}
+
+			TestTrue(TEXT("Process Not Running!"), process->IsRunning());
+
+			const auto start = std::chrono::steady_clock::now();
+			process->Cancel();
+
+			const ConsoleUtils::ProcessResult result = process->Wait();
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+
+			TestTrue(TEXT("Process Not Reported As Cancelled!"), result.mCancelled);
+			TestFalse(TEXT("Process Reported As Timed Out!"), result.mTimedOut);
+			TestFalse(TEXT("Process Still Running!"), process->IsRunning());
+			TestTrue(TEXT("Process Not Killed In Time!"), elapsed < std::chrono::seconds(10));
+		});
+
+		It("(37) Cached Directories Stay Unchanged", [this]()
+		{
+			FString tempPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Temp/DirectoryCacheTest"));
+			const std::filesystem::path temp_path = TCHAR_TO_UTF8(*tempPath);
+			std::filesystem::remove_all(temp_path);
+
+			const std::filesystem::path source_path = temp_path / "model";
+			std::filesystem::create_directories(source_path / "variables");
+			std::ofstream(source_path / "saved_model.pb") << "graph";
+			std::ofstream(source_path / "variables" / "variables.index") << "index";
+
+			const auto ListFiles = [](const std::filesystem::path& directory)
+			{
+				std::set<std::string> files;
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+					files.insert(std::filesystem::relative(entry.path(), directory).generic_string());
+				return files;
+			};
+
+			TF::DiskCache cache(temp_path / "cache", 64ull * 1024 * 1024);
+			if (!TestTrue(TEXT("Failed To Insert Directory!"), cache.Insert("model_key", source_path)))
+				return;
+
+			std::filesystem::path entry;
+			if (!TestTrue(TEXT("Directory Entry Not Found!"), cache.Lookup("model_key", entry)))
+				return;
+
+			// The last use is tracked next to the entry, a copy of the entry must match the source exactly
+			TestTrue(TEXT("Cached Directory Differs From Source!"), ListFiles(entry) == ListFiles(source_path));
+			TestTrue(TEXT("Last Use Not Tracked!"), std::filesystem::exists(temp_path / "cache" / "model_key.last_use"));
+
+			cache.Remove("model_key");
+			TestTrue(TEXT("Cache Not Empty After Remove!"), std::filesystem::is_empty(temp_path / "cache"));
+
+			std::filesystem::remove_all(temp_path);
+		});
 	});
 }
\ No newline at end of file
@@ -5,6 +5,98 @@
 #include <cstdlib>
 #include <string>
 #include <filesystem>
+#include <thread>
+#include <mutex>
+
+namespace
+{
+    // Interval at which running processes are checked for cancellation and timeouts
+    constexpr std::chrono::milliseconds PollInterval(50);
+
+    // Time given to a process to exit after a termination request before it is killed
+    constexpr std::chrono::milliseconds TerminateGracePeriod(3000);
+
+    /// <summary>
+    /// Splits a byte stream into lines, holding back incomplete trailing lines.
+    /// </summary>
+    struct LineSplitter
+    {
+    public:
+        void Feed(const char* data, size_t size, const ConsoleUtils::LineCallback& on_line, bool is_error)
+        {
+            mPending.append(data, size);
+
+            size_t start = 0;
+            size_t end = 0;
+            while ((end = mPending.find('\n', start)) != std::string::npos)
+            {
+                Emit(mPending.substr(start, end - start), on_line, is_error);
+                start = end + 1;
+            }
+            mPending.erase(0, start);
+        }
+
+        void Flush(const ConsoleUtils::LineCallback& on_line, bool is_error)
+        {
+            if (!mPending.empty())
+                Emit(mPending, on_line, is_error);
+            mPending.clear();
+        }
+    private:
+        static void Emit(std::string line, const ConsoleUtils::LineCallback& on_line, bool is_error)
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (on_line)
+                on_line(line, is_error);
+        }
+    private:
+        std::string mPending;
+    };
+}
+
+void ConsoleUtils::ProcessHandle::Cancel()
+{
+    mCancelRequested = true;
+}
+
+bool ConsoleUtils::ProcessHandle::IsRunning() const
+{
+    return mRunning.load();
+}
+
+ConsoleUtils::ProcessResult ConsoleUtils::ProcessHandle::Wait() const
+{
+    return mFuture.get();
+}
+
+int ConsoleUtils::Execute(const std::vector<std::string>& args, std::string* output)
+{
+    LineCallback collect = nullptr;
+    if (output)
+    {
+        output->clear();
+
+        // Lines arrive from a single stream at a time on posix but from two reader threads on windows
+        auto output_mutex = std::make_shared<std::mutex>();
+        collect = [output, output_mutex](const std::string& line, bool)
+        {
+            const std::scoped_lock lock(*output_mutex);
+            *output += line;
+            *output += '\n';
+        };
+    }
+
+    return Spawn(args, false, collect, std::chrono::milliseconds::zero())->Wait().mExitCode;
+}
+
+std::shared_ptr<ConsoleUtils::ProcessHandle> ConsoleUtils::ExecuteAsync(const std::vector<std::string>& args,
+                                                                        LineCallback on_line,
+                                                                        std::chrono::milliseconds timeout)
+{
+    return Spawn(args, false, std::move(on_line), timeout);
+}
 
 #ifdef _WIN32
 #include <windows.h>
@@ -13,25 +105,117 @@
 
 #include <windows.h>
 
+namespace
+{
+    /// <summary>
+    /// Quotes an argument following the rules of CommandLineToArgvW.
+    /// </summary>
+    std::string QuoteArgument(const std::string& arg)
+    {
+        if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos)
+            return arg;
+
+        std::string quoted = "\"";
+        size_t backslashes = 0;
+        for (char c : arg)
+        {
+            if (c == '\\')
+            {
+                ++backslashes;
+                continue;
+            }
+
+            if (c == '"')
+                quoted.append(backslashes * 2 + 1, '\\');
+            else
+                quoted.append(backslashes, '\\');
+
+            backslashes = 0;
+            quoted += c;
+        }
+        quoted.append(backslashes * 2, '\\');
+        quoted += '"';
+        return quoted;
+    }
+
+    void ReadPipe(HANDLE pipe, const ConsoleUtils::LineCallback& on_line, bool is_error)
+    {
+        LineSplitter splitter;
+
+        char buffer[4096];
+        DWORD bytesRead;
+        while (ReadFile(pipe, buffer, sizeof(buffer), &bytesRead, nullptr) && bytesRead)
+            splitter.Feed(buffer, bytesRead, on_line, is_error);
+
+        splitter.Flush(on_line, is_error);
+    }
+}
 
 int ConsoleUtils::Execute(const char* cmd, std::string* output)
 {
+    std::string collected;
+    const int exitCode = Spawn({ cmd }, true, [&collected](const std::string& line, bool)
+    {
+        collected += line;
+        collected += '\n';
+    }, std::chrono::milliseconds::zero())->Wait().mExitCode;
+
+    if (output)
+        *output = std::move(collected);
+
+    return exitCode;
+}
+
+std::shared_ptr<ConsoleUtils::ProcessHandle> ConsoleUtils::Spawn(const std::vector<std::string>& args,
+                                                                 bool is_command_line,
+                                                                 LineCallback on_line,
+                                                                 std::chrono::milliseconds timeout)
+{
+    if (args.empty())
+        throw std::invalid_argument("No program given to execute");
+
+    std::string commandLine;
+    if (is_command_line)
+    {
+        commandLine = args.front();
+    }
+    else
+    {
+        for (const std::string& arg : args)
+        {
+            if (!commandLine.empty())
+                commandLine += ' ';
+            commandLine += QuoteArgument(arg);
+        }
+    }
+
     SECURITY_ATTRIBUTES sa{ sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
-    HANDLE hRead, hWrite;
-    if (!CreatePipe(&hRead, &hWrite, &sa, 0))
+    HANDLE hOutRead, hOutWrite, hErrRead, hErrWrite;
+    if (!CreatePipe(&hOutRead, &hOutWrite, &sa, 0))
         throw std::runtime_error("Failed to create pipe");
 
+    if (!CreatePipe(&hErrRead, &hErrWrite, &sa, 0))
+    {
+        CloseHandle(hOutRead); CloseHandle(hOutWrite);
+        throw std::runtime_error("Failed to create pipe");
+    }
+
+    // Only the write ends belong to the child
+    SetHandleInformation(hOutRead, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(hErrRead, HANDLE_FLAG_INHERIT, 0);
+
     STARTUPINFOA si{};
     si.cb = sizeof(si);
     si.dwFlags = STARTF_USESTDHANDLES | STARTF_USESHOWWINDOW;
-    si.hStdOutput = hWrite;
-    si.hStdError = hWrite;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = hOutWrite;
+    si.hStdError = hErrWrite;
     si.wShowWindow = SW_HIDE; // hide window
 
     PROCESS_INFORMATION pi{};
 
     if (!CreateProcessA(nullptr,
-                        (LPSTR)cmd,
+                        commandLine.data(),
                         nullptr,
                         nullptr,
                         TRUE,
@@ -39,72 +223,265 @@ int ConsoleUtils::Execute(const char* cmd, std::string* output)
                         nullptr,
                         nullptr,
                         &si,
-                        &pi)) 
+                        &pi))
     {
-        CloseHandle(hRead); CloseHandle(hWrite);
+        CloseHandle(hOutRead); CloseHandle(hOutWrite);
+        CloseHandle(hErrRead); CloseHandle(hErrWrite);
         throw std::runtime_error("Failed to start process");
     }
 
-    CloseHandle(hWrite); // child has it now
+    // child has them now
+    CloseHandle(hOutWrite);
+    CloseHandle(hErrWrite);
+    CloseHandle(pi.hThread);
 
-    if (output)
+    auto handle = std::make_shared<ProcessHandle>();
+
+    std::thread([handle, hProcess = pi.hProcess, hOutRead, hErrRead, on_line = std::move(on_line), timeout]()
     {
-        output->clear();
+        // Callbacks are serialized so the caller never observes two lines at once
+        std::mutex callbackMutex;
+        const LineCallback serialized = [&](const std::string& line, bool is_error)
+        {
+            const std::scoped_lock lock(callbackMutex);
+            if (on_line)
+                on_line(line, is_error);
+        };
 
-        char buffer[128];
-        DWORD bytesRead;
-        while (ReadFile(hRead, buffer, sizeof(buffer) - 1, &bytesRead, nullptr) && bytesRead) 
+        std::thread errReader(ReadPipe, hErrRead, std::cref(serialized), true);
+        std::thread outReader(ReadPipe, hOutRead, std::cref(serialized), false);
+
+        ProcessResult result;
+        const auto start = std::chrono::steady_clock::now();
+        while (WaitForSingleObject(hProcess, static_cast<DWORD>(PollInterval.count())) == WAIT_TIMEOUT)
         {
-            buffer[bytesRead] = '\0';
-            *output += buffer;
+            if (handle->mCancelRequested)
+            {
+                result.mCancelled = true;
+                TerminateProcess(hProcess, 1);
+                break;
+            }
+
+            if (timeout.count() > 0 && std::chrono::steady_clock::now() - start > timeout)
+            {
+                result.mTimedOut = true;
+                TerminateProcess(hProcess, 1);
+                break;
+            }
         }
-    }
-    CloseHandle(hRead);
+        WaitForSingleObject(hProcess, INFINITE);
 
-    WaitForSingleObject(pi.hProcess, INFINITE);
+        outReader.join();
+        errReader.join();
 
-    DWORD exitCode;
-    GetExitCodeProcess(pi.hProcess, &exitCode);
+        CloseHandle(hOutRead);
+        CloseHandle(hErrRead);
 
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
+        DWORD exitCode;
+        GetExitCodeProcess(hProcess, &exitCode);
+        CloseHandle(hProcess);
+
+        result.mExitCode = static_cast<int>(exitCode);
+
+        handle->mRunning = false;
+        handle->mPromise.set_value(result);
+    }).detach();
 
-	return exitCode;
+    return handle;
 }
 
 #include "Windows/HideWindowsPlatformTypes.h"
 
 #else  // Linux / macOS
 
-#include <cstdio>
-#include <memory>
-#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
 #include <sys/wait.h>
 
-int ConsoleUtils::Execute(const char* cmd, std::string* output)
+extern char** environ;
+
+namespace
 {
-    std::array<char, 256> buffer;
-    std::string output;
+    void CreatePipe(int fds[2])
+    {
+        if (pipe(fds) != 0)
+            throw std::runtime_error("Failed to create pipe");
+
+        // Keep the pipes out of other concurrently spawned children, dup2 clears the flag for the child's ends
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    }
 
-    // redirect stderr -> stdout with "2>&1"
-    std::string fullCmd = cmd + " 2>&1";
+    int DecodeExitStatus(int status)
+    {
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+}
 
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(fullCmd.c_str(), "r"), pclose);
-    if (!pipe)
-        throw std::runtime_error("popen failed!");
+int ConsoleUtils::Execute(const char* cmd, std::string* output)
+{
+    // Raw command lines keep their shell semantics (quoting, redirections)
+    std::string collected;
+    const int exitCode = Spawn({ cmd }, true, [&collected](const std::string& line, bool)
+    {
+        collected += line;
+        collected += '\n';
+    }, std::chrono::milliseconds::zero())->Wait().mExitCode;
 
     if (output)
+        *output = std::move(collected);
+
+    return exitCode;
+}
+
+std::shared_ptr<ConsoleUtils::ProcessHandle> ConsoleUtils::Spawn(const std::vector<std::string>& args,
+                                                                 bool is_command_line,
+                                                                 LineCallback on_line,
+                                                                 std::chrono::milliseconds timeout)
+{
+    if (args.empty())
+        throw std::invalid_argument("No program given to execute");
+
+    const std::vector<std::string> spawnArgs = is_command_line ? std::vector<std::string>{ "/bin/sh", "-c", args.front() } : args;
+
+    std::vector<char*> argv;
+    argv.reserve(spawnArgs.size() + 1);
+    for (const std::string& arg : spawnArgs)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    int outPipe[2];
+    int errPipe[2];
+    CreatePipe(outPipe);
+    try
     {
-        output->clear();
+        CreatePipe(errPipe);
+    }
+    catch (...)
+    {
+        close(outPipe[0]); close(outPipe[1]);
+        throw;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+
+    pid_t pid = 0;
+    const int spawnError = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    // child has them now
+    close(outPipe[1]);
+    close(errPipe[1]);
 
-        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-            *output += buffer.data();
+    if (spawnError != 0)
+    {
+        close(outPipe[0]);
+        close(errPipe[0]);
+        throw std::runtime_error("Failed to start process: " + std::string(strerror(spawnError)));
     }
 
-    int status = pclose(pipe.release());
-    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    auto handle = std::make_shared<ProcessHandle>();
+
+    std::thread([handle, pid, outFd = outPipe[0], errFd = errPipe[0], on_line = std::move(on_line), timeout]()
+    {
+        LineSplitter outSplitter;
+        LineSplitter errSplitter;
+
+        pollfd fds[2] =
+        {
+            { outFd, POLLIN, 0 },
+            { errFd, POLLIN, 0 }
+        };
+        int openStreams = 2;
+
+        ProcessResult result;
+        bool exited = false;
+        int status = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto terminateTime = std::chrono::steady_clock::time_point::max();
+
+        char buffer[4096];
+        while (openStreams > 0)
+        {
+            const int ready = poll(fds, 2, static_cast<int>(PollInterval.count()));
+            if (ready < 0 && errno != EINTR)
+                break;
+
+            for (int i = 0; i < 2 && ready > 0; ++i)
+            {
+                if (fds[i].fd < 0 || fds[i].revents == 0)
+                    continue;
+
+                const ssize_t bytesRead = read(fds[i].fd, buffer, sizeof(buffer));
+                if (bytesRead > 0)
+                {
+                    (i == 0 ? outSplitter : errSplitter).Feed(buffer, static_cast<size_t>(bytesRead), on_line, i == 1);
+                }
+                else if (bytesRead == 0 || errno != EINTR)
+                {
+                    close(fds[i].fd);
+                    fds[i].fd = -1;
+                    --openStreams;
+                }
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (terminateTime == std::chrono::steady_clock::time_point::max())
+            {
+                if (handle->mCancelRequested)
+                    result.mCancelled = true;
+                else if (timeout.count() > 0 && now - start > timeout)
+                    result.mTimedOut = true;
+
+                if (result.mCancelled || result.mTimedOut)
+                {
+                    kill(pid, SIGTERM);
+                    terminateTime = now;
+                }
+            }
+            else if (now - terminateTime > TerminateGracePeriod)
+            {
+                kill(pid, SIGKILL);
+            }
+
+            // Descendants may keep the pipes open after the process itself exited
+            if (ready == 0 && !exited && waitpid(pid, &status, WNOHANG) == pid)
+                exited = true;
+            if (ready == 0 && exited)
+                break;
+        }
+
+        for (int i = 0; i < 2; ++i)
+        {
+            if (fds[i].fd >= 0)
+                close(fds[i].fd);
+        }
+
+        outSplitter.Flush(on_line, false);
+        errSplitter.Flush(on_line, true);
+
+        if (!exited)
+        {
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+                continue;
+        }
+
+        result.mExitCode = DecodeExitStatus(status);
+
+        handle->mRunning = false;
+        handle->mPromise.set_value(result);
+    }).detach();
 
-	return exitCode;
+    return handle;
 }
 
-#endif
\ No newline at end of file
+#endif
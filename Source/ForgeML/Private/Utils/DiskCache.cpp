@@ -0,0 +1,305 @@
+#include "Utils/DiskCache.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+namespace TF
+{
+	// Suffix of the marker file touched next to directory entries to record their last use,
+	// kept outside the entry so cached directories stay identical to their source
+	static constexpr const char* LastUseSuffix = ".last_use";
+
+	/// <summary>
+	/// Retrieves the path of the last use marker of an entry.
+	/// </summary>
+	static std::filesystem::path GetLastUseMarker(const std::filesystem::path& entry)
+	{
+		std::filesystem::path marker = entry;
+		marker += LastUseSuffix;
+		return marker;
+	}
+
+	/// <summary>
+	/// Retrieves the entry a path within the cache root marks, if the path is a last use marker.
+	/// </summary>
+	static bool GetMarkedEntry(const std::filesystem::path& path, std::filesystem::path& entry)
+	{
+		const std::string name = path.filename().string();
+		const size_t suffix_length = std::char_traits<char>::length(LastUseSuffix);
+		if (name.size() <= suffix_length || name.compare(name.size() - suffix_length, suffix_length, LastUseSuffix) != 0)
+			return false;
+
+		entry = path.parent_path() / name.substr(0, name.size() - suffix_length);
+		return true;
+	}
+
+	DiskCache::DiskCache(const std::filesystem::path& root,
+						 uint64_t max_bytes)
+		: mRoot(root),
+		mMaxBytes(max_bytes)
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(mRoot, ec);
+		if (ec)
+			std::cerr << "Failed to Create Cache Directory: " << mRoot << " (" << ec.message() << ")" << std::endl;
+	}
+
+	void DiskCache::SetSizeLimit(uint64_t max_bytes)
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+			mMaxBytes = max_bytes;
+		}
+		Trim();
+	}
+
+	bool DiskCache::Lookup(const std::string& key,
+						   std::filesystem::path& entry)
+	{
+		const std::scoped_lock lock(mMutex);
+
+		const std::filesystem::path path = GetEntryPath(key);
+
+		std::error_code ec;
+		if (!std::filesystem::exists(path, ec))
+			return false;
+
+		Touch(path);
+
+		entry = path;
+		return true;
+	}
+
+	bool DiskCache::Insert(const std::string& key,
+						   const std::filesystem::path& source)
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+
+			const std::filesystem::path path = GetEntryPath(key);
+			const std::filesystem::path partial = GetEntryPath(key + ".partial");
+
+			std::error_code ec;
+			std::filesystem::remove_all(partial, ec);
+
+			// Copy aside first so a reader never observes a half written entry
+			std::filesystem::copy(source,
+								  partial,
+								  std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing,
+								  ec);
+			if (ec)
+			{
+				std::cerr << "Failed to Copy Into Cache: " << source << " (" << ec.message() << ")" << std::endl;
+				std::filesystem::remove_all(partial, ec);
+				return false;
+			}
+
+			if (!CommitEntry(partial, path))
+				return false;
+		}
+
+		Trim(key);
+		return true;
+	}
+
+	bool DiskCache::Write(const std::string& key,
+						  const void* data,
+						  size_t size)
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+
+			const std::filesystem::path path = GetEntryPath(key);
+			const std::filesystem::path partial = GetEntryPath(key + ".partial");
+
+			// Written aside first so a reader never observes a half written entry
+			{
+				std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+				out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+				if (!out)
+				{
+					std::cerr << "Failed to Write Cache Entry: " << partial << std::endl;
+					out.close();
+
+					std::error_code ec;
+					std::filesystem::remove(partial, ec);
+					return false;
+				}
+			}
+
+			if (!CommitEntry(partial, path))
+				return false;
+		}
+
+		Trim(key);
+		return true;
+	}
+
+	void DiskCache::Remove(const std::string& key)
+	{
+		const std::scoped_lock lock(mMutex);
+
+		const std::filesystem::path path = GetEntryPath(key);
+		const uint64_t size = GetEntrySize(path);
+
+		std::error_code ec;
+		std::filesystem::remove_all(path, ec);
+		if (!ec && mIsTracked)
+			mTrackedBytes -= std::min(size, mTrackedBytes);
+
+		std::filesystem::remove(GetLastUseMarker(path), ec);
+	}
+
+	void DiskCache::Trim(const std::string& keep)
+	{
+		const std::scoped_lock lock(mMutex);
+
+		if (mIsTracked && mTrackedBytes <= mMaxBytes)
+			return;
+
+		struct Entry
+		{
+			std::filesystem::path mPath;
+			std::filesystem::file_time_type mLastUse;
+			uint64_t mSize = 0;
+		};
+
+		std::vector<Entry> entries;
+		uint64_t total_size = 0;
+
+		std::error_code ec;
+		for (const auto& dir_entry : std::filesystem::directory_iterator(mRoot, ec))
+		{
+			const std::filesystem::path& path = dir_entry.path();
+
+			// Markers are not entries themselves, those left behind by removed entries are dropped
+			std::filesystem::path marked_entry;
+			if (GetMarkedEntry(path, marked_entry))
+			{
+				std::error_code marker_ec;
+				if (!std::filesystem::exists(marked_entry, marker_ec))
+					std::filesystem::remove(path, marker_ec);
+				continue;
+			}
+
+			Entry entry;
+			entry.mPath = path;
+			entry.mLastUse = GetLastUse(path);
+			entry.mSize = GetEntrySize(path);
+
+			total_size += entry.mSize;
+			entries.push_back(std::move(entry));
+		}
+
+		mTrackedBytes = total_size;
+		mIsTracked = true;
+
+		if (total_size <= mMaxBytes)
+			return;
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs)
+		{
+			return lhs.mLastUse < rhs.mLastUse;
+		});
+
+		const std::filesystem::path keep_path = keep.empty() ? std::filesystem::path() : GetEntryPath(keep);
+		for (const Entry& entry : entries)
+		{
+			if (total_size <= mMaxBytes)
+				break;
+
+			if (entry.mPath == keep_path)
+				continue;
+
+			std::filesystem::remove_all(entry.mPath, ec);
+			if (!ec)
+				total_size -= entry.mSize;
+
+			std::filesystem::remove(GetLastUseMarker(entry.mPath), ec);
+		}
+
+		mTrackedBytes = total_size;
+	}
+
+	bool DiskCache::CommitEntry(const std::filesystem::path& partial,
+								const std::filesystem::path& path)
+	{
+		const uint64_t replaced_size = GetEntrySize(path);
+		const uint64_t size = GetEntrySize(partial);
+
+		std::error_code ec;
+		std::filesystem::remove_all(path, ec);
+		std::filesystem::rename(partial, path, ec);
+		if (ec)
+		{
+			std::cerr << "Failed to Commit Cache Entry: " << path << " (" << ec.message() << ")" << std::endl;
+			std::filesystem::remove_all(partial, ec);
+
+			if (mIsTracked)
+				mTrackedBytes -= std::min(replaced_size, mTrackedBytes);
+			return false;
+		}
+
+		Touch(path);
+
+		if (mIsTracked)
+			mTrackedBytes = mTrackedBytes - std::min(replaced_size, mTrackedBytes) + size;
+		return true;
+	}
+
+	std::filesystem::path DiskCache::GetEntryPath(const std::string& key) const
+	{
+		return mRoot / key;
+	}
+
+	void DiskCache::Touch(const std::filesystem::path& entry)
+	{
+		std::error_code ec;
+		if (std::filesystem::is_directory(entry, ec))
+		{
+			// Directory timestamps are not reliably writable on all platforms, use a marker file next to it instead
+			std::ofstream marker(GetLastUseMarker(entry), std::ios::trunc);
+			return;
+		}
+
+		std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+	}
+
+	std::filesystem::file_time_type DiskCache::GetLastUse(const std::filesystem::path& entry)
+	{
+		std::error_code ec;
+		if (std::filesystem::is_directory(entry, ec))
+		{
+			const std::filesystem::file_time_type marker_time = std::filesystem::last_write_time(GetLastUseMarker(entry), ec);
+			if (!ec)
+				return marker_time;
+		}
+
+		const std::filesystem::file_time_type entry_time = std::filesystem::last_write_time(entry, ec);
+		return ec ? std::filesystem::file_time_type::min() : entry_time;
+	}
+
+	uint64_t DiskCache::GetEntrySize(const std::filesystem::path& entry)
+	{
+		std::error_code ec;
+		if (!std::filesystem::is_directory(entry, ec))
+		{
+			const uint64_t size = std::filesystem::file_size(entry, ec);
+			return ec ? 0 : size;
+		}
+
+		uint64_t size = 0;
+		for (const auto& file : std::filesystem::recursive_directory_iterator(entry, ec))
+		{
+			if (file.is_regular_file(ec))
+			{
+				const uint64_t file_size = file.file_size(ec);
+				if (!ec)
+					size += file_size;
+			}
+		}
+		return size;
+	}
+}
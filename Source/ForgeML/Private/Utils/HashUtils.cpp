@@ -0,0 +1,58 @@
+#include "Utils/HashUtils.h"
+
+#include <fstream>
+#include <vector>
+#include <stdexcept>
+
+namespace
+{
+	constexpr uint64_t FNVPrime = 1099511628211ull;
+}
+
+uint64_t HashUtils::Hash(const void* data, size_t size, uint64_t seed)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= FNVPrime;
+	}
+	return hash;
+}
+
+uint64_t HashUtils::HashString(const std::string& str, uint64_t seed)
+{
+	return Hash(str.data(), str.size(), seed);
+}
+
+uint64_t HashUtils::HashFile(const std::filesystem::path& filepath, uint64_t seed)
+{
+	std::ifstream ifs(filepath, std::ios::binary);
+	if (!ifs)
+		throw std::runtime_error("Failed to open file for hashing: " + filepath.string());
+
+	std::vector<char> buffer(1 << 16);
+
+	uint64_t hash = seed;
+	while (ifs)
+	{
+		ifs.read(buffer.data(), buffer.size());
+		hash = Hash(buffer.data(), static_cast<size_t>(ifs.gcount()), hash);
+	}
+	return hash;
+}
+
+std::string HashUtils::ToHex(uint64_t hash)
+{
+	static constexpr char Digits[] = "0123456789abcdef";
+
+	std::string result(16, '0');
+	for (int i = 15; i >= 0; --i)
+	{
+		result[i] = Digits[hash & 0xF];
+		hash >>= 4;
+	}
+	return result;
+}
@@ -0,0 +1,181 @@
+#include "Utils/SharedMemory.h"
+
+#include <iostream>
+#include <atomic>
+
+#ifdef _WIN32
+#include "Windows/AllowWindowsPlatformTypes.h"
+
+#include <windows.h>
+#else  // Linux / macOS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace TF
+{
+	// Number of names tried before giving up, names may be taken by segments of crashed processes
+	static constexpr uint32_t MaxCreateAttempts = 16;
+
+	/// <summary>
+	/// Creates a segment name unique within this process, short enough for macOS (31 characters).
+	/// </summary>
+	/// <returns>The segment name</returns>
+	static std::string CreateSegmentName()
+	{
+		static std::atomic<uint32_t> next_id = 0;
+
+#ifdef _WIN32
+		const unsigned long pid = GetCurrentProcessId();
+#else
+		const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+		return "fml_" + std::to_string(pid) + "_" + std::to_string(next_id++);
+	}
+
+	SharedMemory::~SharedMemory()
+	{
+		Release();
+	}
+
+#ifdef _WIN32
+	bool SharedMemory::Create(size_t bytes)
+	{
+		Release();
+
+		// Zero sized mappings are not allowed
+		bytes = bytes > 0 ? bytes : 1;
+
+		for (uint32_t attempt = 0; attempt < MaxCreateAttempts; ++attempt)
+		{
+			const std::string name = CreateSegmentName();
+
+			HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE,
+											   nullptr,
+											   PAGE_READWRITE,
+											   static_cast<DWORD>(static_cast<uint64_t>(bytes) >> 32),
+											   static_cast<DWORD>(bytes & 0xFFFFFFFF),
+											   name.c_str());
+			if (!handle)
+			{
+				std::cerr << "Failed To Create Shared Memory: " << GetLastError() << std::endl;
+				return false;
+			}
+
+			if (GetLastError() == ERROR_ALREADY_EXISTS)
+			{
+				CloseHandle(handle);
+				continue;
+			}
+
+			void* data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+			if (!data)
+			{
+				std::cerr << "Failed To Map Shared Memory: " << GetLastError() << std::endl;
+				CloseHandle(handle);
+				return false;
+			}
+
+			mName = name;
+			mpHandle = handle;
+			mpData = data;
+			mBytes = bytes;
+			return true;
+		}
+
+		std::cerr << "Failed To Find A Free Shared Memory Name." << std::endl;
+		return false;
+	}
+
+	void SharedMemory::Release()
+	{
+		if (mpData)
+			UnmapViewOfFile(mpData);
+		if (mpHandle)
+			CloseHandle(static_cast<HANDLE>(mpHandle));
+
+		mName.clear();
+		mpHandle = nullptr;
+		mpData = nullptr;
+		mBytes = 0;
+	}
+#else
+	bool SharedMemory::Create(size_t bytes)
+	{
+		Release();
+
+		// Zero sized mappings are not allowed
+		bytes = bytes > 0 ? bytes : 1;
+
+		for (uint32_t attempt = 0; attempt < MaxCreateAttempts; ++attempt)
+		{
+			const std::string name = CreateSegmentName();
+
+			const int fd = shm_open(("/" + name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd < 0)
+			{
+				if (errno == EEXIST)
+					continue;
+
+				std::cerr << "Failed To Create Shared Memory: " << std::strerror(errno) << std::endl;
+				return false;
+			}
+
+			int error = 0;
+			if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+				error = errno;
+#ifdef __linux__
+			// ftruncate leaves the segment sparse, on a full /dev/shm the first write to a page would raise SIGBUS
+			else
+				error = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+#endif
+
+			void* data = MAP_FAILED;
+			if (error == 0)
+			{
+				data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if (data == MAP_FAILED)
+					error = errno;
+			}
+
+			// The mapping stays valid after closing the descriptor
+			close(fd);
+
+			if (data == MAP_FAILED)
+			{
+				std::cerr << "Failed To Map Shared Memory: " << std::strerror(error) << std::endl;
+				shm_unlink(("/" + name).c_str());
+				return false;
+			}
+
+			mName = name;
+			mpData = data;
+			mBytes = bytes;
+			return true;
+		}
+
+		std::cerr << "Failed To Find A Free Shared Memory Name." << std::endl;
+		return false;
+	}
+
+	void SharedMemory::Release()
+	{
+		if (mpData)
+		{
+			munmap(mpData, mBytes);
+			shm_unlink(("/" + mName).c_str());
+		}
+
+		mName.clear();
+		mpData = nullptr;
+		mBytes = 0;
+	}
+#endif
+}
+
+#ifdef _WIN32
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
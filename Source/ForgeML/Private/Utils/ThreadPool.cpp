@@ -0,0 +1,126 @@
+#include "Utils/ThreadPool.h"
+
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <exception>
+
+namespace TF
+{
+	ThreadPool::ThreadPool(uint32_t thread_count)
+	{
+		if (thread_count == 0)
+			thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+		mWorkers.reserve(thread_count);
+		for (uint32_t i = 0; i < thread_count; ++i)
+			mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+			mStopping = true;
+		}
+		mCondition.notify_all();
+
+		for (std::thread& worker : mWorkers)
+			worker.join();
+	}
+
+	ThreadPool& ThreadPool::GetShared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::Submit(std::function<void()> task)
+	{
+		{
+			const std::scoped_lock lock(mMutex);
+			mTasks.push_back(std::move(task));
+		}
+		mCondition.notify_one();
+	}
+
+	void ThreadPool::ParallelFor(size_t count,
+								 const std::function<void(size_t)>& func)
+	{
+		if (count == 0)
+			return;
+
+		// Outlives the call, helpers that start after all indices are taken only touch the counters
+		struct State
+		{
+			std::atomic<size_t> mNext = 0;
+			std::atomic<size_t> mDone = 0;
+			const std::function<void(size_t)>* mpFunc = nullptr;
+			size_t mCount = 0;
+
+			std::mutex mMutex;
+			std::condition_variable mFinished;
+			std::exception_ptr mException;
+		};
+
+		auto state = std::make_shared<State>();
+		state->mpFunc = &func;
+		state->mCount = count;
+
+		const auto RunIndices = [](const std::shared_ptr<State>& state)
+		{
+			for (size_t i = state->mNext++; i < state->mCount; i = state->mNext++)
+			{
+				try
+				{
+					(*state->mpFunc)(i);
+				}
+				catch (...)
+				{
+					const std::scoped_lock lock(state->mMutex);
+					if (!state->mException)
+						state->mException = std::current_exception();
+				}
+
+				if (++state->mDone == state->mCount)
+				{
+					const std::scoped_lock lock(state->mMutex);
+					state->mFinished.notify_all();
+				}
+			}
+		};
+
+		// The calling thread works as well, so waiting never depends on a free worker
+		const size_t helpers = std::min<size_t>(count - 1, mWorkers.size());
+		for (size_t i = 0; i < helpers; ++i)
+			Submit([state, RunIndices]() { RunIndices(state); });
+
+		RunIndices(state);
+
+		std::unique_lock lock(state->mMutex);
+		state->mFinished.wait(lock, [&]() { return state->mDone.load() == count; });
+
+		if (state->mException)
+			std::rethrow_exception(state->mException);
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mMutex);
+				mCondition.wait(lock, [&]() { return mStopping || !mTasks.empty(); });
+
+				if (mTasks.empty())
+					return;
+
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+
+			task();
+		}
+	}
+}
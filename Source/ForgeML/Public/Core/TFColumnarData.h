@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Core/TFModelLayout.h"
+
+#include "Utils/SharedMemory.h"
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+namespace TF
+{
+	/// <summary>
+	/// Struct representing a view onto a contiguous, row major column of samples.
+	/// </summary>
+	struct ColumnView
+	{
+	public:
+		// Column name (e.g., "inputs/x", "labels/y", "state")
+		std::string mName;
+
+		DataType mType = DataType::Float32;
+
+		// Shape of the column, the first dimension is the number of rows
+		std::vector<int64_t> mShape;
+
+		// Pointer to the column data, owned by the caller
+		const void* mpData = nullptr;
+
+		// Size of the column data in bytes
+		size_t mBytes = 0;
+	};
+
+	/// <summary>
+	/// Struct representing a column of string samples (e.g., image paths).
+	/// </summary>
+	struct StringColumnView
+	{
+	public:
+		// Column name (e.g., "inputs/image")
+		std::string mName;
+
+		// One entry per row, owned by the caller
+		const std::vector<std::string>* mpValues = nullptr;
+	};
+
+	/// <summary>
+	/// Struct representing a set of columns written in a binary, NumPy readable format.
+	///
+	/// Numeric columns are written as .npy files which the trainer maps without copying, or placed
+	/// in a shared memory segment that the trainer wraps in place. String columns are written as JSON lists.
+	/// A manifest.json maps column names to files or segment offsets.
+	/// </summary>
+	struct FORGEML_API ColumnarData
+	{
+	public:
+		/// <summary>
+		/// Adds a numeric column.
+		/// </summary>
+		/// <param name="column">The column view</param>
+		inline void AddColumn(const ColumnView& column) { mColumns.push_back(column); }
+
+		/// <summary>
+		/// Adds a string column.
+		/// </summary>
+		/// <param name="column">The column view</param>
+		inline void AddStringColumn(const StringColumnView& column) { mStringColumns.push_back(column); }
+
+		/// <summary>
+		/// Checks whether no columns have been added.
+		/// </summary>
+		/// <returns>True if there are no columns</returns>
+		inline bool IsEmpty() const { return mColumns.empty() && mStringColumns.empty(); }
+
+		/// <summary>
+		/// Writes all columns and the manifest into a directory, replacing previous content.
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		void WriteToDirectory(const std::filesystem::path& directory) const;
+
+		/// <summary>
+		/// Places all numeric columns in a new shared memory segment and writes the string columns
+		/// and the manifest into a directory, replacing previous content.
+		/// 
+		/// Falls back to .npy files if the segment cannot be created.
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		/// <param name="memory">The shared memory receiving the segment, must outlive the trainer</param>
+		/// <returns>True if the columns were placed in shared memory</returns>
+		bool WriteToSharedMemory(const std::filesystem::path& directory,
+								 SharedMemory& memory) const;
+	private:
+		/// <summary>
+		/// Writes the string columns into a directory and adds them to the manifest.
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		/// <param name="manifest">The manifest</param>
+		void WriteStringColumns(const std::filesystem::path& directory,
+								nlohmann::json& manifest) const;
+	public:
+		/// <summary>
+		/// Creates the .npy header describing a column.
+		/// </summary>
+		/// <param name="type">The data type of the column</param>
+		/// <param name="shape">The shape of the column</param>
+		/// <returns>The header bytes, padded so the data that follows is 64 byte aligned</returns>
+		static std::string CreateNpyHeader(DataType type,
+										   const std::vector<int64_t>& shape);
+
+		/// <summary>
+		/// Writes a column to a .npy file.
+		/// </summary>
+		/// <param name="filepath">The file path</param>
+		/// <param name="column">The column view</param>
+		static void WriteNpyFile(const std::filesystem::path& filepath,
+								 const ColumnView& column);
+
+		/// <summary>
+		/// Reads a little endian float32 .npy file written in C order (e.g., by numpy.save).
+		/// </summary>
+		/// <param name="filepath">The file path</param>
+		/// <param name="values">The flat values</param>
+		/// <returns>True if the file was read</returns>
+		static bool ReadNpyFile(const std::filesystem::path& filepath,
+								std::vector<float>& values);
+	public:
+		std::vector<ColumnView> mColumns;
+		std::vector<StringColumnView> mStringColumns;
+	};
+}
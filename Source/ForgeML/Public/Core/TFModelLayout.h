@@ -106,6 +106,14 @@ namespace TF
 		/// </summary>
 		/// <param name="filepath">The file path</param>
 		void WriteToFile(const std::filesystem::path& filepath) const;
+
+		/// <summary>
+		/// Computes a canonical hash of the layout covering inputs (dtypes, shapes, domains), 
+		/// outputs and layers with their parameters in sorted order.
+		/// The model name is excluded so identically structured models share the same hash.
+		/// </summary>
+		/// <returns>The layout hash</returns>
+		uint64_t Hash() const;
 	private:
 		/// <summary>
 		/// Convert the model layout to a JSON object.
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <span>
+#include <random>
+#include <mutex>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a binary tree whose inner nodes hold the sum of their children,
+	/// allowing proportional sampling and priority updates in O(log n).
+	/// </summary>
+	class FORGEML_API SumTree
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a SumTree with all priorities at zero.
+		/// </summary>
+		/// <param name="capacity">The number of leaves</param>
+		SumTree(uint32_t capacity = 0);
+	public:
+		/// <summary>
+		/// Sets the priority of a leaf.
+		/// </summary>
+		/// <param name="index">The leaf index</param>
+		/// <param name="priority">The non-negative priority</param>
+		void Set(uint32_t index,
+				 double priority);
+
+		/// <summary>
+		/// Retrieves the priority of a leaf.
+		/// </summary>
+		/// <param name="index">The leaf index</param>
+		/// <returns>The priority</returns>
+		inline double Get(uint32_t index) const { return mNodes[mLeaves + index]; }
+
+		/// <summary>
+		/// Retrieves the sum of all priorities.
+		/// </summary>
+		/// <returns>The total priority</returns>
+		inline double Total() const { return mNodes.size() > 1 ? mNodes[1] : 0.0; }
+
+		/// <summary>
+		/// Finds the leaf whose cumulative priority range contains the given value.
+		/// </summary>
+		/// <param name="prefix_sum">The value in [0, Total())</param>
+		/// <returns>The leaf index</returns>
+		uint32_t Find(double prefix_sum) const;
+	private:
+		uint32_t mLeaves = 1;
+		std::vector<double> mNodes;
+	};
+
+	/// <summary>
+	/// Struct representing a minibatch set drawn from a ReplayBuffer.
+	/// </summary>
+	struct FORGEML_API ReplayBatch
+	{
+	public:
+		inline operator bool() const
+		{
+			return !mIndices.empty();
+		}
+	public:
+		/// <summary>
+		/// Write the batch to a directory of binary NumPy columns
+		/// (state, action, reward, next_state, done, weight).
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		void WriteToDirectory(const std::filesystem::path& directory) const;
+	public:
+		uint32_t mStateWidth = 0;
+		uint32_t mActionWidth = 0;
+
+		// Buffer slots the rows were drawn from, used to update their priorities
+		std::vector<uint32_t> mIndices;
+
+		// Insertion number of the transition in each slot when drawn, slots overwritten since are not updated
+		std::vector<uint64_t> mInsertions;
+
+		// Importance sampling weights, normalized to a maximum of 1
+		std::vector<float> mWeights;
+
+		std::vector<float> mStates;
+		std::vector<float> mActions;
+		std::vector<float> mRewards;
+		std::vector<float> mNextStates;
+		std::vector<float> mDones;
+	};
+
+	/// <summary>
+	/// Class representing a fixed capacity replay buffer of transitions for reward based training.
+	///
+	/// Transitions are stored in contiguous typed columns forming a ring, once full the oldest
+	/// transition is overwritten. Sampling is either uniform or prioritized by TD error
+	/// (proportional variant, Schaul et al. 2016) using a SumTree.
+	/// </summary>
+	class FORGEML_API ReplayBuffer
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a ReplayBuffer.
+		/// </summary>
+		/// <param name="capacity">The maximum number of transitions</param>
+		/// <param name="prioritized">Whether to sample proportionally to the priorities</param>
+		/// <param name="alpha">How strongly priorities skew the sampling (0 is uniform)</param>
+		/// <param name="beta">How strongly the importance sampling weights correct the skew (1 is fully)</param>
+		ReplayBuffer(uint32_t capacity,
+					 bool prioritized = false,
+					 float alpha = 0.6f,
+					 float beta = 0.4f);
+	public:
+		/// <summary>
+		/// Retrieves the maximum number of transitions.
+		/// </summary>
+		/// <returns>The capacity</returns>
+		inline uint32_t GetCapacity() const { return mCapacity; }
+
+		/// <summary>
+		/// Checks whether sampling is prioritized.
+		/// </summary>
+		/// <returns>True if prioritized</returns>
+		inline bool IsPrioritized() const { return mPrioritized; }
+
+		/// <summary>
+		/// Retrieves the number of stored transitions.
+		/// </summary>
+		/// <returns>The number of transitions</returns>
+		uint32_t GetSize() const;
+
+		/// <summary>
+		/// Sets the importance sampling exponent, typically annealed towards 1 over the training.
+		/// </summary>
+		/// <param name="beta">The exponent</param>
+		void SetBeta(float beta);
+
+		/// <summary>
+		/// Seeds the random generator used for sampling.
+		/// </summary>
+		/// <param name="seed">The seed</param>
+		void Seed(uint32_t seed);
+
+		/// <summary>
+		/// Adds a transition, overwriting the oldest one once the buffer is full.
+		/// New transitions receive the highest priority seen so far.
+		/// </summary>
+		/// <param name="state">The observed state</param>
+		/// <param name="action">The action taken</param>
+		/// <param name="reward">The reward received</param>
+		/// <param name="next_state">The state observed after the action</param>
+		/// <param name="done">Whether the episode ended with this transition</param>
+		/// <returns>True if the widths matched the previous transitions</returns>
+		bool Add(std::span<const float> state,
+				 std::span<const float> action,
+				 float reward,
+				 std::span<const float> next_state,
+				 bool done);
+
+		/// <summary>
+		/// Draws transitions with replacement.
+		/// </summary>
+		/// <param name="count">The number of transitions</param>
+		/// <param name="batch">The sampled transitions</param>
+		/// <returns>True if the buffer held any transitions</returns>
+		bool Sample(uint32_t count,
+					ReplayBatch& batch);
+
+		/// <summary>
+		/// Updates the priorities of sampled transitions from their TD errors.
+		/// Transitions overwritten by Add since the batch was sampled keep their priority.
+		/// </summary>
+		/// <param name="batch">The batch the transitions were sampled in</param>
+		/// <param name="td_errors">The TD errors of the batch rows</param>
+		void UpdatePriorities(const ReplayBatch& batch,
+							  std::span<const float> td_errors);
+
+		/// <summary>
+		/// Removes all transitions.
+		/// </summary>
+		void Clear();
+	private:
+		uint32_t mCapacity = 0;
+		bool mPrioritized = false;
+		float mAlpha = 0.6f;
+		float mBeta = 0.4f;
+
+		mutable std::mutex mMutex = {};
+		std::mt19937 mRandom;
+
+		uint32_t mStateWidth = 0;
+		uint32_t mActionWidth = 0;
+		uint32_t mHead = 0;
+		uint32_t mSize = 0;
+
+		std::vector<float> mStates;
+		std::vector<float> mActions;
+		std::vector<float> mRewards;
+		std::vector<float> mNextStates;
+		std::vector<float> mDones;
+
+		// Insertion number of the transition in each slot, never reused
+		std::vector<uint64_t> mInsertions;
+		uint64_t mInsertCount = 0;
+
+		SumTree mPriorities;
+		double mMaxPriority = 1.0;
+	};
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Core/TFTrainingBatch.h"
+
+#include <memory>
+#include <mutex>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing training sample buffers split into shards, so concurrent producers do not share a lock.
+	///
+	/// Each thread is assigned a shard on first use (round robin), with at least as many shards as producer threads
+	/// every shard lock is uncontended. The shards are only merged when the samples are taken for training.
+	/// </summary>
+	class FORGEML_API ShardedTrainingData
+	{
+	public:
+		// Default number of shards
+		static constexpr uint32_t DefaultShardCount = 64;
+	public:
+		/// <summary>
+		/// Constructor initializing a ShardedTrainingData.
+		/// </summary>
+		/// <param name="shard_count">The number of shards</param>
+		ShardedTrainingData(uint32_t shard_count = DefaultShardCount);
+	public:
+		/// <summary>
+		/// Retrieves the number of shards.
+		/// </summary>
+		/// <returns>The number of shards</returns>
+		inline uint32_t GetShardCount() const { return mShardCount; }
+
+		/// <summary>
+		/// Runs a function on the calling thread's shard while holding its lock.
+		/// </summary>
+		/// <param name="func">The function, receiving the shard's supervised and reward batches</param>
+		/// <returns>The result of the function</returns>
+		template<typename Func>
+		auto ForLocalShard(Func&& func)
+		{
+			Shard& shard = mShards[GetLocalShardIndex()];
+
+			const std::scoped_lock lock(shard.mMutex);
+			return func(shard.mSupervisedBatch, shard.mRewardBatch);
+		}
+
+		/// <summary>
+		/// Moves the samples of all shards to the end of the given batches. A shard whose supervised
+		/// columns do not match the batch keeps its supervised samples.
+		/// </summary>
+		/// <param name="supervised_batch">The supervised batch to append to</param>
+		/// <param name="reward_batch">The reward batch to append to</param>
+		void TakeAll(LabeledTrainingBatch& supervised_batch,
+					 RewardTrainingBatch& reward_batch);
+
+		/// <summary>
+		/// Copies the samples of all shards to the end of the given batches.
+		/// </summary>
+		/// <param name="supervised_batch">The supervised batch to append to</param>
+		/// <param name="reward_batch">The reward batch to append to</param>
+		void CopyAll(LabeledTrainingBatch& supervised_batch,
+					 RewardTrainingBatch& reward_batch) const;
+
+		/// <summary>
+		/// Retrieves the number of supervised samples over all shards.
+		/// </summary>
+		/// <returns>The number of supervised samples</returns>
+		uint64_t GetSupervisedCount() const;
+
+		/// <summary>
+		/// Retrieves the number of reward samples over all shards.
+		/// </summary>
+		/// <returns>The number of reward samples</returns>
+		uint64_t GetRewardCount() const;
+	private:
+		/// <summary>
+		/// Struct representing a single shard, aligned to a cache line to avoid false sharing.
+		/// </summary>
+		struct alignas(64) Shard
+		{
+			mutable std::mutex mMutex = {};
+			LabeledTrainingBatch mSupervisedBatch;
+			RewardTrainingBatch mRewardBatch;
+		};
+	private:
+		/// <summary>
+		/// Retrieves the shard index assigned to the calling thread.
+		/// </summary>
+		/// <returns>The shard index</returns>
+		uint32_t GetLocalShardIndex() const;
+	private:
+		uint32_t mShardCount = DefaultShardCount;
+		std::unique_ptr<Shard[]> mShards;
+	};
+}
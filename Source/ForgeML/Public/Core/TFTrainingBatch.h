@@ -1,36 +1,89 @@
 #pragma once
 
+#include "Utils/SharedMemory.h"
+
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <filesystem>
+#include <span>
 
 #include <nlohmann/json.hpp>
 
 namespace TF
 {
 	/// <summary>
-	/// Struct representing a training input.
+	/// Struct representing a contiguous column of training rows sharing one name.
+	///
+	/// Numeric rows are stored back to back in a single typed buffer, 
+	/// string rows (e.g., image paths) are stored in their own buffer.
 	/// </summary>
-	struct NamedInput
+	struct FORGEML_API TrainingColumn
 	{
-		// Must match ModelLayout.input.name
-		std::string mName;
+	public:
+		/// <summary>
+		/// Checks whether the column holds string rows.
+		/// </summary>
+		/// <returns>True if the column holds strings</returns>
+		inline bool IsString() const { return !mStrings.empty(); }
 
-		// Outer vector = batch, inner = flat feature array
-		std::vector<nlohmann::json> mData;
-	};
+		/// <summary>
+		/// Appends a numeric row. All rows of a column must have the same width.
+		/// </summary>
+		/// <param name="values">The row values</param>
+		/// <returns>True if the row was appended</returns>
+		bool AppendRow(std::span<const float> values);
 
-	/// <summary>
-	/// Struct representing a training label.
-	/// </summary>
-	struct NamedLabel
-	{
-		// Must match ModelLayout.output.name
+		/// <summary>
+		/// Appends a string row.
+		/// </summary>
+		/// <param name="value">The row value</param>
+		/// <returns>True if the row was appended</returns>
+		bool AppendRow(const std::string& value);
+
+		/// <summary>
+		/// Appends a row given as JSON, either (nested) numbers or a string.
+		/// </summary>
+		/// <param name="value">The row value</param>
+		/// <returns>True if the row was appended</returns>
+		bool AppendRow(const nlohmann::json& value);
+
+		/// <summary>
+		/// Checks whether the rows of another column can be appended, i.e., either column is empty
+		/// or both hold strings or numeric rows of the same width.
+		/// </summary>
+		/// <param name="other">The column to append</param>
+		/// <returns>True if the columns are compatible</returns>
+		bool CanAppend(const TrainingColumn& other) const;
+
+		/// <summary>
+		/// Appends all rows of another column with the same name.
+		/// </summary>
+		/// <param name="other">The column to append, left unchanged if incompatible</param>
+		/// <returns>True if the columns were compatible</returns>
+		bool Append(TrainingColumn&& other);
+
+		/// <summary>
+		/// Converts a row to JSON.
+		/// </summary>
+		/// <param name="row">The row index</param>
+		/// <returns>The row as a JSON array</returns>
+		nlohmann::json RowToJson(size_t row) const;
+	public:
+		// Must match ModelLayout.input.name or ModelLayout.output.name
 		std::string mName;
 
-		// e.g., one-hot vectors
-		std::vector<nlohmann::json> mData;
+		// Number of values per numeric row
+		uint32_t mWidth = 0;
+
+		// Number of rows
+		uint64_t mRows = 0;
+
+		// Numeric rows, row major [mRows, mWidth]
+		std::vector<float> mValues;
+
+		// String rows
+		std::vector<std::string> mStrings;
 	};
 
 	/// <summary>
@@ -46,12 +99,18 @@ namespace TF
 		
 		// The reward value from this step
 		float mReward = 0.0f;
+
+		// The state observed after the action, null if unknown
+		nlohmann::json mNextState;
+
+		// Whether the episode ended with this step
+		bool mDone = false;
 	};
 
 	/// <summary>
 	/// Struct representing a training batch that is labeled for supervised training.
 	/// </summary>
-	struct LabeledTrainingBatch
+	struct FORGEML_API LabeledTrainingBatch
 	{
 	public:
 		inline operator bool() const
@@ -68,6 +127,40 @@ namespace TF
 			mLabels.clear();
 		}
 
+		/// <summary>
+		/// Retrieves the input column of the given name, creating it if needed.
+		/// </summary>
+		/// <param name="name">The input name</param>
+		/// <returns>The input column</returns>
+		TrainingColumn& GetInput(const std::string& name);
+
+		/// <summary>
+		/// Retrieves the label column of the given name, creating it if needed.
+		/// </summary>
+		/// <param name="name">The label name</param>
+		/// <returns>The label column</returns>
+		TrainingColumn& GetLabel(const std::string& name);
+
+		/// <summary>
+		/// Retrieves the number of samples in the batch.
+		/// </summary>
+		/// <returns>The number of rows of the first label column</returns>
+		uint64_t GetRowCount() const;
+
+		/// <summary>
+		/// Checks whether all columns hold the same number of rows.
+		/// </summary>
+		/// <returns>True if the row counts match</returns>
+		bool HasConsistentRows() const;
+
+		/// <summary>
+		/// Appends the inputs and labels of another training batch. Nothing is appended if any column
+		/// does not match, the other batch then keeps all of its rows.
+		/// </summary>
+		/// <param name="other">The batch to append</param>
+		/// <returns>True if the batch was appended</returns>
+		bool Append(LabeledTrainingBatch&& other);
+
 		/// <summary>
 		/// Read the training batch from a JSON file.
 		/// </summary>
@@ -79,6 +172,14 @@ namespace TF
 		/// </summary>
 		/// <param name="filepath">The file path</param>
 		void WriteToFile(const std::filesystem::path& filepath) const;
+
+		/// <summary>
+		/// Write the training batch to a directory of binary NumPy columns.
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		/// <param name="shared_memory">The shared memory to place the numeric columns in, nullptr to write files</param>
+		void WriteToDirectory(const std::filesystem::path& directory,
+							  SharedMemory* shared_memory = nullptr) const;
 	private:
 		/// <summary>
 		/// Convert the training batch to a JSON object.
@@ -93,15 +194,15 @@ namespace TF
 		/// <returns>The created training batch</returns>
 		static LabeledTrainingBatch from_json(const nlohmann::json& inputJson);
 	public:
-		std::vector<NamedInput> mInputs;
-		std::vector<NamedLabel> mLabels;
+		std::vector<TrainingColumn> mInputs;
+		std::vector<TrainingColumn> mLabels;
 	};
 
 	/// <summary>
 	/// Struct representing a training batch that has data corresponding to a 
 	/// reward value for supervised training.
 	/// </summary>
-	struct RewardTrainingBatch
+	struct FORGEML_API RewardTrainingBatch
 	{
 	public:
 		inline operator bool() const
@@ -117,6 +218,16 @@ namespace TF
 			mSamples.clear();
 		}
 
+		/// <summary>
+		/// Appends the samples of another training batch.
+		/// </summary>
+		/// <param name="other">The batch to append</param>
+		inline void Append(RewardTrainingBatch&& other)
+		{
+			mSamples.insert(mSamples.end(), std::make_move_iterator(other.mSamples.begin()), std::make_move_iterator(other.mSamples.end()));
+			other.Clear();
+		}
+
 		/// <summary>
 		/// Read the training batch from a JSON file.
 		/// </summary>
@@ -128,6 +239,14 @@ namespace TF
 		/// </summary>
 		/// <param name="filepath">The file path</param>
 		void WriteToFile(const std::filesystem::path& filepath) const;
+
+		/// <summary>
+		/// Write the training batch to a directory of binary NumPy columns.
+		/// </summary>
+		/// <param name="directory">The output directory</param>
+		/// <param name="shared_memory">The shared memory to place the numeric columns in, nullptr to write files</param>
+		void WriteToDirectory(const std::filesystem::path& directory,
+							  SharedMemory* shared_memory = nullptr) const;
 	private:
 		/// <summary>
 		/// Convert the training batch to a JSON object.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <filesystem>
 
 #include <nlohmann/json.hpp>
@@ -56,14 +57,72 @@ namespace TF
 		// Fraction of data to reserve for validation
 		float validation_split = 0.0f;
 
+		// Format of the training data handed to the trainer, "binary" (NumPy columns) or "json" (for debugging)
+		std::string data_format = "binary";
+
+		// Transport of binary training data, "shared_memory" (only a descriptor is written to disk) or "file"
+		std::string data_transport = "shared_memory";
+
+		// Number of minibatches (of batch_size) drawn from the replay buffer per training run
+		uint32_t replay_batches = 64;
+
+		// Number of images decoded in parallel by the streaming image pipeline, 0 lets tf.data tune it
+		uint32_t data_parallel_calls = 0;
+
+		// Number of samples held by the shuffle buffer of the streaming image pipeline
+		uint32_t shuffle_buffer = 1024;
+
+		// Directory caching decoded images between epochs and runs (relative to the model's train directory), empty to disable
+		std::string data_cache = "";
+
+		// Optimizer to use ("adam", "adamw", "sgd" or "rmsprop")
+		std::string optimizer = "adam";
+
+		// Loss function to use (e.g., "mse", "categorical_crossentropy"), empty for the default of the training mode
+		std::string loss_function = "";
+
+		// List of metrics to evaluate during training (e.g., "accuracy")
+		std::vector<std::string> metrics;
+
+		// Stop training once the validation loss (or the training loss without validation data) stops improving
+		bool early_stopping = false;
+
+		// Number of epochs with no improvement before stopping
+		uint32_t early_stopping_patience = 5;
+
+		// Minimum change of the monitored loss that counts as an improvement
+		float early_stopping_min_delta = 0.0f;
+
+		// Learning rate schedule, "constant", "reduce_on_plateau" or "cosine"
+		std::string lr_schedule = "constant";
+
+		// Factor the learning rate is multiplied with on a plateau ("reduce_on_plateau")
+		float lr_decay_factor = 0.5f;
+
+		// Number of epochs with no improvement before reducing the learning rate ("reduce_on_plateau")
+		uint32_t lr_patience = 2;
+
+		// Lower bound of the learning rate ("reduce_on_plateau" and "cosine")
+		float min_learning_rate = 1e-6f;
+
+		// Number of epochs between checkpoints of the weights and optimizer state, 0 to disable
+		uint32_t checkpoint_every = 1;
+
+		// Continue from the latest checkpoint of an interrupted run of the same model version
+		bool resume = false;
+
+		// Training distribution, "none" (single replica) or "mirrored" (data parallel over local CPU workers)
+		std::string distribution = "none";
+
+		// Number of data parallel workers ("mirrored"), batch_size is per worker. 0 fills the host
+		uint32_t num_workers = 0;
+
+		// Number of threads per worker, 0 splits the host cores evenly (or uses the TensorFlow default for "none")
+		uint32_t threads_per_worker = 0;
+
 
 		// TODO:: Implement these options
-		//std::string optimizer = "adam";     // Optimizer to use (e.g., "adam", "sgd")
-		//std::string loss_function = "mse";  // Loss function to use (e.g., "mse", "categorical_crossentropy")
-		//std::vector<std::string> metrics;   // List of metrics to evaluate during training
 		//std::string model_save_path;        // Path to save the trained model
 		//std::string log_dir;                // Directory for logging training progress
-		//bool early_stopping = false;        // Enable early stopping based on validation loss
-		//float early_stopping_patience = 5;  // Number of epochs with no improvement before stopping
 	};
 }
\ No newline at end of file
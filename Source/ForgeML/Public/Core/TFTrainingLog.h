@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Core/TFTrainingBatch.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing an append-only, on-disk log of numeric training samples.
+	///
+	/// Records are queued by the producers and written by a background thread, which commits
+	/// all queued records as a group. Producers block once the queued (in-flight) bytes exceed
+	/// the configured window, so memory stays bounded no matter how long samples are collected.
+	///
+	/// The log is split into segment directories, each holding one raw float32 file per column.
+	/// Sealed segments carry a manifest.json and are consumed by the trainer directly.
+	/// </summary>
+	class FORGEML_API TrainingLog
+	{
+	public:
+		// Default in-flight window (64 MB)
+		static constexpr uint64_t DefaultInFlightBytes = 64ull * 1024 * 1024;
+
+		// Default size at which the active segment is sealed (256 MB)
+		static constexpr uint64_t DefaultSegmentBytes = 256ull * 1024 * 1024;
+	public:
+		/// <summary>
+		/// Constructor initializing a TrainingLog, recovering the segments of previous sessions.
+		/// </summary>
+		/// <param name="directory">The log directory</param>
+		/// <param name="max_in_flight_bytes">The maximum size of the records waiting to be written</param>
+		/// <param name="segment_bytes">The size at which the active segment is sealed</param>
+		TrainingLog(const std::filesystem::path& directory,
+					uint64_t max_in_flight_bytes = DefaultInFlightBytes,
+					uint64_t segment_bytes = DefaultSegmentBytes);
+
+		/// <summary>
+		/// Destructor writing all queued records and sealing the active segment.
+		/// </summary>
+		~TrainingLog();
+	public:
+		/// <summary>
+		/// Retrieves the log directory.
+		/// </summary>
+		/// <returns>The log directory</returns>
+		inline const std::filesystem::path& GetDirectory() const { return mDirectory; }
+
+		/// <summary>
+		/// Queues a record for writing, blocking while the in-flight window is full.
+		///
+		/// All columns of a record must hold the same number of numeric rows.
+		/// </summary>
+		/// <param name="record">The columns of the record</param>
+		/// <returns>True if the record was queued</returns>
+		bool Append(std::vector<TrainingColumn>&& record);
+
+		/// <summary>
+		/// Blocks until the records queued before the call are written, later records are not waited for.
+		/// </summary>
+		/// <returns>True if the records were written successfully</returns>
+		bool Flush();
+
+		/// <summary>
+		/// Writes all queued records and seals the active segment.
+		/// </summary>
+		/// <returns>All sealed segments, oldest first</returns>
+		std::vector<std::filesystem::path> Seal();
+
+		/// <summary>
+		/// Removes consumed segments.
+		/// </summary>
+		/// <param name="segments">The sealed segments to remove</param>
+		void Remove(const std::vector<std::filesystem::path>& segments);
+
+		/// <summary>
+		/// Checks whether the log holds any rows, written or queued.
+		/// </summary>
+		/// <returns>True if the log holds rows</returns>
+		bool HasData() const;
+
+		/// <summary>
+		/// Retrieves the size of the records waiting to be written.
+		/// </summary>
+		/// <returns>The in-flight size in bytes</returns>
+		uint64_t GetInFlightBytes() const;
+	private:
+		/// <summary>
+		/// Struct representing a column file of the active segment.
+		/// </summary>
+		struct SegmentColumn
+		{
+			std::string mFilename;
+			uint32_t mWidth = 0;
+			uint64_t mRows = 0;
+			std::ofstream mStream;
+		};
+	private:
+		/// <summary>
+		/// Background loop committing queued records in groups.
+		/// </summary>
+		void WriterLoop();
+
+		/// <summary>
+		/// Writes a group of records to the active segment, opening a new one if needed.
+		/// </summary>
+		/// <param name="records">The records to write</param>
+		/// <returns>True if the records were written</returns>
+		bool WriteRecords(const std::vector<std::vector<TrainingColumn>>& records);
+
+		/// <summary>
+		/// Seals the active segment by writing its manifest.
+		/// </summary>
+		void SealActiveSegment();
+
+		/// <summary>
+		/// Seals segments left unsealed by a previous session and finds the next segment index.
+		/// </summary>
+		void RecoverSegments();
+
+		/// <summary>
+		/// Writes the schema (column files and widths) of the active segment.
+		/// </summary>
+		void WriteSchema() const;
+
+		/// <summary>
+		/// Writes the manifest of a segment, sealing it.
+		/// </summary>
+		/// <param name="segment">The segment directory</param>
+		/// <param name="columns">The columns as name to (file, width)</param>
+		/// <param name="rows">The number of complete rows</param>
+		static void WriteManifest(const std::filesystem::path& segment,
+								  const nlohmann::json& columns,
+								  uint64_t rows);
+	private:
+		std::filesystem::path mDirectory;
+		uint64_t mMaxInFlightBytes = DefaultInFlightBytes;
+		uint64_t mSegmentBytes = DefaultSegmentBytes;
+
+		// Queue shared with the producers
+		mutable std::mutex mQueueMutex = {};
+		std::condition_variable mQueueCondition;
+		std::condition_variable mSpaceCondition;
+		std::vector<std::vector<TrainingColumn>> mQueue;
+		std::unordered_map<std::string, uint32_t> mWidths;
+		uint64_t mInFlightBytes = 0;
+		uint64_t mQueuedRows = 0;
+
+		// Sequence numbers of the last queued and the last written record
+		uint64_t mQueuedRecords = 0;
+		uint64_t mWrittenRecords = 0;
+
+		bool mFlushRequested = false;
+		bool mStop = false;
+		bool mFailed = false;
+
+		// Active segment, owned by the writer while a group is committed
+		mutable std::mutex mSegmentMutex = {};
+		uint32_t mNextSegment = 0;
+		std::filesystem::path mActiveSegment;
+		std::unordered_map<std::string, SegmentColumn> mActiveColumns;
+		uint64_t mActiveBytes = 0;
+		uint64_t mActiveRows = 0;
+		uint64_t mSealedRows = 0;
+
+		std::thread mWriter;
+	};
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <filesystem>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a dataset of images stored in one folder per class (root/<class>/<image>).
+	///
+	/// The class folders are scanned in parallel into a compact list of (path, label) samples, all paths
+	/// share a single buffer. The samples can be saved to a binary index file, which is reused while the
+	/// class folders are unchanged, and handed to training with MLModel::AddImageDataset.
+	/// </summary>
+	class FORGEML_API ImageFolderDataset
+	{
+	public:
+		/// <summary>
+		/// Struct representing a sample of the dataset, laid out as stored in the index file.
+		/// </summary>
+		struct Sample
+		{
+		public:
+			// Offset and length of the path relative to the root in the path buffer
+			uint64_t mOffset = 0;
+			uint32_t mLength = 0;
+
+			uint32_t mLabel = 0;
+		};
+	public:
+		/// <summary>
+		/// Scans the class folders of a dataset.
+		///
+		/// Without a label map, numeric folder names (e.g., "31") are used as labels, other folder names
+		/// are labeled in sorted order. With a label map ({ "<label>": "<class name>" }) folder names may be
+		/// either labels or class names of the map.
+		/// </summary>
+		/// <param name="root">The dataset root holding the class folders</param>
+		/// <param name="label_map_path">The JSON label map, empty to derive the labels from the folder names</param>
+		/// <returns>True if the dataset was scanned</returns>
+		bool Scan(const std::filesystem::path& root,
+				  const std::filesystem::path& label_map_path = "");
+
+		/// <summary>
+		/// Reads the samples from an index file if it matches the current class folders, otherwise scans
+		/// the dataset and writes a new index file.
+		/// </summary>
+		/// <param name="root">The dataset root holding the class folders</param>
+		/// <param name="index_path">The index file path</param>
+		/// <param name="label_map_path">The JSON label map, empty to derive the labels from the folder names</param>
+		/// <returns>True if the dataset was loaded</returns>
+		bool Open(const std::filesystem::path& root,
+				  const std::filesystem::path& index_path,
+				  const std::filesystem::path& label_map_path = "");
+
+		/// <summary>
+		/// Writes the samples, in their current order, to a binary index file.
+		/// </summary>
+		/// <param name="index_path">The index file path</param>
+		/// <returns>True if the index file was written</returns>
+		bool WriteIndex(const std::filesystem::path& index_path) const;
+
+		/// <summary>
+		/// Reads the samples from a binary index file.
+		/// </summary>
+		/// <param name="root">The dataset root the indexed paths are relative to</param>
+		/// <param name="index_path">The index file path</param>
+		/// <returns>True if a valid index file was read</returns>
+		bool ReadIndex(const std::filesystem::path& root,
+					   const std::filesystem::path& index_path);
+
+		/// <summary>
+		/// Shuffles the samples, the same seed always gives the same order.
+		/// </summary>
+		/// <param name="seed">The shuffle seed, e.g., the epoch</param>
+		void Shuffle(uint64_t seed);
+
+		/// <summary>
+		/// Retrieves every count-th sample starting at the shard index, e.g., for one of several workers.
+		/// The shards of all indices partition the dataset. The paths are shared, not copied.
+		/// </summary>
+		/// <param name="index">The shard index</param>
+		/// <param name="count">The number of shards</param>
+		/// <returns>The shard</returns>
+		ImageFolderDataset GetShard(uint32_t index,
+									uint32_t count) const;
+	public:
+		/// <summary>
+		/// Retrieves the dataset root.
+		/// </summary>
+		/// <returns>The root directory</returns>
+		inline const std::filesystem::path& GetRoot() const { return mRoot; }
+
+		/// <summary>
+		/// Retrieves the number of samples.
+		/// </summary>
+		/// <returns>The sample count</returns>
+		inline size_t GetSize() const { return mSamples.size(); }
+
+		/// <summary>
+		/// Retrieves the samples in their current order.
+		/// </summary>
+		/// <returns>The samples</returns>
+		inline const std::vector<Sample>& GetSamples() const { return mSamples; }
+
+		/// <summary>
+		/// Retrieves the path of a sample relative to the root.
+		/// </summary>
+		/// <param name="index">The sample index</param>
+		/// <returns>The relative path, valid while the dataset or a shard of it exists</returns>
+		std::string_view GetRelativePath(size_t index) const;
+
+		/// <summary>
+		/// Retrieves the full path of a sample.
+		/// </summary>
+		/// <param name="index">The sample index</param>
+		/// <returns>The image path</returns>
+		std::filesystem::path GetPath(size_t index) const;
+
+		/// <summary>
+		/// Retrieves the label of a sample.
+		/// </summary>
+		/// <param name="index">The sample index</param>
+		/// <returns>The label</returns>
+		inline uint32_t GetLabel(size_t index) const { return mSamples[index].mLabel; }
+
+		/// <summary>
+		/// Retrieves the number of classes, one more than the largest label.
+		/// </summary>
+		/// <returns>The class count</returns>
+		inline uint32_t GetClassCount() const { return static_cast<uint32_t>(mClassNames.size()); }
+
+		/// <summary>
+		/// Retrieves the class names by label, empty for labels without a folder or label map entry.
+		/// </summary>
+		/// <returns>The class names</returns>
+		inline const std::vector<std::string>& GetClassNames() const { return mClassNames; }
+	private:
+		/// <summary>
+		/// Computes the fingerprint of the class folders and the label map, an index is reused while it matches.
+		/// </summary>
+		/// <param name="root">The dataset root holding the class folders</param>
+		/// <param name="label_map_path">The JSON label map, may be empty</param>
+		/// <returns>The fingerprint, 0 if the root or the label map cannot be read</returns>
+		static uint64_t ComputeFingerprint(const std::filesystem::path& root,
+										   const std::filesystem::path& label_map_path);
+	private:
+		std::filesystem::path mRoot;
+
+		// Relative paths of all samples back to back, shared with shards
+		std::shared_ptr<const std::string> mpPaths;
+		std::vector<Sample> mSamples;
+
+		std::vector<std::string> mClassNames;
+		uint64_t mFingerprint = 0;
+	};
+}
@@ -2,14 +2,25 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <memory>
+
+#include "Core/TFModelLayout.h"
 
 namespace cppflow
 {
 	class tensor;
 }
 
+namespace cv
+{
+	class Mat;
+}
+
 namespace TF
 {
+	class DiskCache;
+
 	/// <summary>
 	/// Enum representing the order of channels in an image tensor.
 	/// </summary>
@@ -56,6 +67,48 @@ namespace TF
 						  ChannelOrder order = ChannelOrder::RGBA,
 						  ShapeOrder shape = ShapeOrder::WidthHeightChannels);
 
+		/// <summary>
+		/// Sets the per-channel normalization applied after the optional [0, 1] scaling,
+		/// value = (pixel - mean) / std_dev. Empty vectors disable it.
+		/// </summary>
+		/// <param name="mean">The mean per output channel, or a single mean for all channels</param>
+		/// <param name="std_dev">The standard deviation per output channel, or a single one for all channels</param>
+		void SetNormalization(const std::vector<float>& mean,
+							  const std::vector<float>& std_dev);
+
+		/// <summary>
+		/// Sets how far JPEGs may be downscaled while decoding (DCT-domain scaling by 2, 4 or 8),
+		/// which cuts decode time and memory for images much larger than the tensor.
+		/// 
+		/// The largest reduction is chosen that still decodes at least oversampling times the tensor
+		/// size in both dimensions. 0 always decodes at full resolution.
+		/// </summary>
+		/// <param name="oversampling">The minimum ratio of the decoded to the tensor size (default 1)</param>
+		inline void SetDecodeOversampling(float oversampling) { mDecodeOversampling = oversampling; }
+
+		/// <summary>
+		/// Sets the data type of the output tensors, matching the model input (Float32 or UInt8).
+		/// 
+		/// UInt8 tensors hold the raw [0, 255] pixel values, so normalization must be disabled.
+		/// </summary>
+		/// <param name="type">The output data type</param>
+		void SetDataType(DataType type);
+
+		/// <summary>
+		/// Retrieves the data type of the output tensors.
+		/// </summary>
+		/// <returns>The output data type</returns>
+		inline DataType GetDataType() const { return mDataType; }
+
+		/// <summary>
+		/// Sets the cache storing the converted tensors of images loaded by path, nullptr disables caching.
+		/// 
+		/// Entries are keyed by the file path, modification time, size and the loader configuration,
+		/// so warm loads skip decoding entirely. A cache may be shared between loaders.
+		/// </summary>
+		/// <param name="cache">The cache</param>
+		inline void SetCache(const std::shared_ptr<DiskCache>& cache) { mpCache = cache; }
+
 		/// <summary>
 		/// Loads an image from the specified path and converts it to a tensor.
 		/// </summary>
@@ -64,6 +117,135 @@ namespace TF
 		/// <returns>True whether the conversion is successful</returns>
 		bool Load(const std::string& image_path, 
 				  cppflow::tensor& output);
+
+		/// <summary>
+		/// Converts 8-bit interleaved pixels in memory to a tensor, wrapping the buffer without copying it.
+		/// 
+		/// Channels are expected in OpenCV's BGR(A) order, matching images loaded from disk and
+		/// Unreal's FColor (e.g., reinterpret_cast&lt;const uint8_t*&gt;(colors.GetData()) with 4 channels).
+		/// </summary>
+		/// <param name="pixels">The first pixel of the image</param>
+		/// <param name="width">The width of the image in pixels</param>
+		/// <param name="height">The height of the image in pixels</param>
+		/// <param name="channels">The number of channels per pixel (1, 3 or 4)</param>
+		/// <param name="stride">The number of bytes between rows, 0 for tightly packed rows</param>
+		/// <param name="output">The output tensor</param>
+		/// <returns>True whether the conversion is successful</returns>
+		bool Load(const uint8_t* pixels,
+				  uint32_t width,
+				  uint32_t height,
+				  uint32_t channels,
+				  size_t stride,
+				  cppflow::tensor& output);
+
+		/// <summary>
+		/// Decodes an encoded image (e.g., PNG or JPEG bytes) from memory and converts it to a tensor.
+		/// </summary>
+		/// <param name="encoded">The encoded image bytes</param>
+		/// <param name="size">The number of encoded bytes</param>
+		/// <param name="output">The output tensor</param>
+		/// <returns>True whether the conversion is successful</returns>
+		bool Load(const uint8_t* encoded,
+				  size_t size,
+				  cppflow::tensor& output);
+
+		/// <summary>
+		/// Loads images from the specified paths in parallel into a single batched tensor [N, ...].
+		/// </summary>
+		/// <param name="image_paths">The file paths of the images</param>
+		/// <param name="output">The output tensor</param>
+		/// <returns>True whether all images were converted successfully</returns>
+		bool LoadBatch(const std::vector<std::string>& image_paths, 
+					   cppflow::tensor& output);
+
+		/// <summary>
+		/// Converts 8-bit interleaved pixels in memory into a caller owned buffer, e.g., a slot of a batch.
+		/// </summary>
+		/// <param name="pixels">The first pixel of the image</param>
+		/// <param name="width">The width of the image in pixels</param>
+		/// <param name="height">The height of the image in pixels</param>
+		/// <param name="channels">The number of channels per pixel (1, 3 or 4)</param>
+		/// <param name="stride">The number of bytes between rows, 0 for tightly packed rows</param>
+		/// <param name="output">The output buffer, holding GetImageSize() values of the data type</param>
+		/// <returns>True whether the conversion is successful</returns>
+		bool LoadInto(const uint8_t* pixels,
+					  uint32_t width,
+					  uint32_t height,
+					  uint32_t channels,
+					  size_t stride,
+					  void* output) const;
+	public:
+		/// <summary>
+		/// Retrieves the number of values of a single image.
+		/// </summary>
+		/// <returns>The number of values</returns>
+		inline size_t GetImageSize() const { return static_cast<size_t>(mWidth) * mHeight * mChannels; }
+
+		/// <summary>
+		/// Retrieves the size of a single output value.
+		/// </summary>
+		/// <returns>The size in bytes</returns>
+		inline size_t GetElementSize() const { return mDataType == DataType::UInt8 ? sizeof(uint8_t) : sizeof(float); }
+
+		/// <summary>
+		/// Retrieves the tensor shape of a batch of images in the shape order.
+		/// </summary>
+		/// <param name="batch_size">The number of images</param>
+		/// <returns>The tensor shape</returns>
+		std::vector<int64_t> GetTensorShape(int64_t batch_size) const;
+	private:
+
+		/// <summary>
+		/// Selects the decode flags of an encoded image, reducing JPEGs much larger than the tensor.
+		/// </summary>
+		/// <param name="header">The start of the encoded image</param>
+		/// <param name="size">The number of available bytes</param>
+		/// <returns>The cv::imread/cv::imdecode flags</returns>
+		int SelectDecodeFlags(const uint8_t* header, 
+							  size_t size) const;
+
+		/// <summary>
+		/// Computes the cache key of an image file under the current configuration.
+		/// </summary>
+		/// <param name="image_path">The file path of the image</param>
+		/// <returns>The cache key, empty if the file could not be inspected</returns>
+		std::string GetCacheKey(const std::string& image_path) const;
+
+		/// <summary>
+		/// Reads the cached values of an image into the given buffer.
+		/// </summary>
+		/// <param name="cache_key">The cache key of the image</param>
+		/// <param name="output">The output buffer, holding GetImageSize() values of the data type</param>
+		/// <returns>True if a valid entry was found</returns>
+		bool ReadCached(const std::string& cache_key, 
+						void* output) const;
+
+		/// <summary>
+		/// Stores the converted values of an image in the cache.
+		/// </summary>
+		/// <param name="cache_key">The cache key of the image</param>
+		/// <param name="values">The converted values, holding GetImageSize() values of the data type</param>
+		void WriteCached(const std::string& cache_key, 
+						 const void* values) const;
+
+		/// <summary>
+		/// Loads an image and writes the converted values into the given buffer.
+		/// </summary>
+		/// <param name="image_path">The file path of the image</param>
+		/// <param name="output">The output buffer, holding GetImageSize() values of the data type</param>
+		/// <returns>True whether the conversion is successful</returns>
+		bool LoadInto(const std::string& image_path, 
+					  void* output) const;
+
+		/// <summary>
+		/// Resizes and converts a decoded image, writing the values into the given buffer.
+		/// The image is only read, so it may wrap memory owned by the caller.
+		/// </summary>
+		/// <param name="image">The decoded 8-bit image</param>
+		/// <param name="output">The output buffer, holding GetImageSize() values of the data type</param>
+		/// <returns>True whether the conversion is successful</returns>
+		bool ConvertInto(const cv::Mat& image, 
+						 void* output) const;
 	private:
 		uint32_t mWidth = 0;
 		uint32_t mHeight = 0;
@@ -71,5 +253,12 @@ namespace TF
 		bool mNormalize = true;
 		ChannelOrder mChannelOrder = ChannelOrder::RGBA;
 		ShapeOrder mShapeOrder = ShapeOrder::WidthHeightChannels;
+		float mDecodeOversampling = 1.0f;
+		DataType mDataType = DataType::Float32;
+
+		std::vector<float> mMean;
+		std::vector<float> mStdDev;
+
+		std::shared_ptr<DiskCache> mpCache;
 	};
 }
\ No newline at end of file
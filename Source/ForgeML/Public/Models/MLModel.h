@@ -5,10 +5,18 @@
 #include "Core/TFModelLayout.h"
 #include "Core/TFTrainingBatch.h"
 #include "Core/TFTrainingConfig.h"
+#include "Core/TFTrainingLog.h"
+#include "Core/TFReplayBuffer.h"
+#include "Core/TFShardedTrainingData.h"
+
+#include "Data/ImageFolderDataset.h"
+
+#include "Models/TrainingJob.h"
 
 #include <vector>
 #include <filesystem>
 #include <string>
+#include <span>
 #include <unordered_map>
 #include <mutex>
 
@@ -29,7 +37,7 @@ namespace TF
 				const std::filesystem::path& output = "");
 
 		/// <summary>
-		/// Default destructor.
+		/// Destructor cancelling and waiting for any running training job.
 		/// </summary>
 		~MLModel();
 	public:
@@ -84,6 +92,15 @@ namespace TF
 					  std::vector<int> shape, 
 					  DomainType domain = DomainType::Data);
 
+		/// <summary>
+		/// Retrieves the data type of an input declared in the layout, e.g., to match an ImageTensorLoader to it.
+		/// </summary>
+		/// <param name="name">The name of the input</param>
+		/// <param name="dtype">The output data type of the input</param>
+		/// <returns>True if the input is declared in the layout</returns>
+		bool GetInputType(const std::string& name,
+						  DataType& dtype) const;
+
 		/// <summary>
 		/// Adds an output to the model.
 		/// </summary>
@@ -102,23 +119,100 @@ namespace TF
 		/// Adds supervised training data to the model.
 		/// </summary>
 		/// <param name="input_name">The input name of the training batch</param>
-		/// <param name="input_values">The input values</param>
+		/// <param name="input_values">The input values, or the image path for image inputs</param>
 		/// <param name="label_name">The label name of the training batch</param>
 		/// <param name="label_outputs">The label outputs</param>
-		void AddSupervisedTrainingData(const std::string& input_name, 
+		/// <returns>True if the sample matched the model layout and was added</returns>
+		bool AddSupervisedTrainingData(const std::string& input_name, 
 									   const nlohmann::json& input_values,
 									   const std::string& label_name,
 									   const nlohmann::json& label_outputs);
 
+		/// <summary>
+		/// Adds a supervised training row of flat float values to the model without intermediate conversions.
+		/// </summary>
+		/// <param name="input_name">The input name of the training batch</param>
+		/// <param name="input_values">The flat input values</param>
+		/// <param name="label_name">The label name of the training batch</param>
+		/// <param name="label_outputs">The flat label outputs</param>
+		/// <returns>True if the row matched the model layout and the previous rows and was added</returns>
+		bool AddSupervisedTrainingRow(const std::string& input_name, 
+									  std::span<const float> input_values,
+									  const std::string& label_name,
+									  std::span<const float> label_outputs);
+
+		/// <summary>
+		/// Adds every image of a dataset as supervised training data, labeled one-hot by its class.
+		/// 
+		/// Only the dataset index is handed to the trainer, the paths are not added as separate samples.
+		/// The dataset is consumed by the next training run like other samples. Its images come after the
+		/// other samples in the dataset order, shuffle it first when training with a validation split.
+		/// </summary>
+		/// <param name="input_name">The image input name of the training batch</param>
+		/// <param name="dataset">The dataset, e.g., a shuffled shard</param>
+		/// <param name="label_name">The label name of the training batch</param>
+		/// <returns>True if the dataset matched the model layout and was added</returns>
+		bool AddImageDataset(const std::string& input_name,
+							 const ImageFolderDataset& dataset,
+							 const std::string& label_name);
+
 		/// <summary>
 		/// Adds reward training data to the model.
+		/// 
+		/// Transitions go into the replay buffer if one is enabled.
 		/// </summary>
 		/// <param name="state_values">The state value</param>
 		/// <param name="action_values">The action value</param>
 		/// <param name="reward">The reward value</param>
+		/// <param name="next_state_values">The state observed after the action, null if unknown</param>
+		/// <param name="done">Whether the episode ended with this transition</param>
 		void AddRewardData(const nlohmann::json& state_values,
 						   const nlohmann::json& action_values,
-						   float reward);
+						   float reward,
+						   const nlohmann::json& next_state_values = nullptr,
+						   bool done = false);
+
+		/// <summary>
+		/// Retrieves the number of supervised samples held in memory for the next training run,
+		/// including the images of added datasets.
+		/// </summary>
+		/// <returns>The number of supervised samples</returns>
+		uint64_t GetSupervisedSampleCount() const;
+
+		/// <summary>
+		/// Retrieves the number of reward samples held in memory for the next training run.
+		/// </summary>
+		/// <returns>The number of reward samples</returns>
+		uint64_t GetRewardSampleCount() const;
+
+		/// <summary>
+		/// Collects all further reward transitions in a fixed capacity replay buffer. 
+		/// 
+		/// Each training run draws TrainingConfig::replay_batches minibatches from the buffer
+		/// instead of consuming all samples, and the buffer is kept across runs.
+		/// With prioritized sampling the TD errors reported by the trainer update the priorities.
+		/// Must be called before samples are collected.
+		/// </summary>
+		/// <param name="capacity">The maximum number of transitions</param>
+		/// <param name="prioritized">Whether to sample proportionally to the TD errors</param>
+		/// <param name="alpha">How strongly priorities skew the sampling</param>
+		/// <param name="beta">How strongly the importance sampling weights correct the skew</param>
+		void EnableReplayBuffer(uint32_t capacity,
+								bool prioritized = true,
+								float alpha = 0.6f,
+								float beta = 0.4f);
+
+		/// <summary>
+		/// Streams all further training samples into append-only logs under the model's train directory
+		/// instead of keeping them in memory. Samples of previous sessions still on disk are picked up.
+		/// 
+		/// Only numeric samples can be logged, image path inputs must be collected without the log.
+		/// Must be called before samples are collected.
+		/// </summary>
+		/// <param name="max_in_flight_bytes">The maximum size of the samples waiting to be written, adding samples blocks beyond it</param>
+		/// <param name="segment_bytes">The size at which a log segment is sealed</param>
+		void EnableTrainingLog(uint64_t max_in_flight_bytes = TrainingLog::DefaultInFlightBytes,
+							   uint64_t segment_bytes = TrainingLog::DefaultSegmentBytes);
 
 		/// <summary>
 		/// Save the model layout to a JSON file.
@@ -157,6 +251,37 @@ namespace TF
 						float validation_split = 0.0f,
 						bool clean_data = true);
 
+		/// <summary>
+		/// Launches the training of the model.
+		/// </summary>
+		/// <param name="config">The training configuration</param>
+		/// <param name="clean_data">Whether to clear the training data after this training session</param>
+		/// <returns>True if the training was successful</returns>
+		bool TrainModel(const TrainingConfig& config,
+						bool clean_data = true);
+
+		/// <summary>
+		/// Checks whether an interrupted training run of the current model version left a checkpoint to resume from.
+		/// 
+		/// Set TrainingConfig::resume to continue from it.
+		/// </summary>
+		/// <returns>True if a checkpoint exists</returns>
+		bool HasTrainingCheckpoint() const;
+
+		/// <summary>
+		/// Launches the training of the model in the background.
+		/// 
+		/// The trained version is promoted automatically once the job completes successfully.
+		/// Only one training job can run at a time.
+		/// </summary>
+		/// <param name="config">The training configuration</param>
+		/// <param name="on_metrics">The callback receiving the metrics of each completed epoch</param>
+		/// <param name="clean_data">Whether to clear the training data after this training session</param>
+		/// <returns>The training job or nullptr if the training could not be started</returns>
+		std::shared_ptr<TrainingJob> TrainModelAsync(const TrainingConfig& config,
+													 TrainingJob::MetricsCallback on_metrics = nullptr,
+													 bool clean_data = true);
+
 		/// <summary>
 		/// Runs the model with the given input tensors and returns the output.
 		/// </summary>
@@ -166,11 +291,49 @@ namespace TF
 		bool Run(const LabeledTensor& input_tensors,
 				 LabeledTensor& output);
 
+		/// <summary>
+		/// Sets the maximum size of the shared cache holding converted and built models.
+		/// Least recently used entries are evicted once the limit is exceeded.
+		/// </summary>
+		/// <param name="max_bytes">The maximum size in bytes</param>
+		static void SetModelCacheLimit(uint64_t max_bytes);
+
 		/// <summary>
 		/// Exports all of the model's components to the specified directory.
 		/// </summary>
 		/// <param name="directory">The output directory</param>
 		void ExportAll(const std::filesystem::path& directory) const;
+	private:
+		/// <summary>
+		/// Struct representing an image dataset added as supervised training data.
+		/// </summary>
+		struct ImageDatasetSource
+		{
+			std::string mInputName;
+			std::string mLabelName;
+			ImageFolderDataset mDataset;
+
+			// Width of the one-hot labels, at least the class count of the dataset
+			uint32_t mLabelWidth = 0;
+		};
+
+		/// <summary>
+		/// Struct representing the training data frozen for a single training run.
+		/// </summary>
+		struct TrainingSnapshot
+		{
+			LabeledTrainingBatch mSupervisedBatch;
+			RewardTrainingBatch mRewardBatch;
+
+			// Sealed training log segments consumed by the run
+			std::vector<std::filesystem::path> mSupervisedSegments;
+			std::vector<std::filesystem::path> mRewardSegments;
+
+			// Minibatches drawn from the replay buffer
+			ReplayBatch mReplayBatch;
+
+			std::vector<ImageDatasetSource> mImageDatasets;
+		};
 	private:
 		/// <summary>
 		/// Converts the model to a SavedModel format if it is not already in that format.
@@ -181,6 +344,64 @@ namespace TF
 		bool ConvertModelToSavedModel(const std::filesystem::path& filepath,
 									  const std::filesystem::path& outputpath);
 
+		/// <summary>
+		/// Extracts the input/output tensor names of a SavedModel into its cppflow_io_names.json.
+		/// </summary>
+		/// <param name="model_path">The SavedModel path</param>
+		/// <returns>True if extraction was successful</returns>
+		bool ExtractModelInfo(const std::filesystem::path& model_path);
+
+		/// <summary>
+		/// Copies the in-memory training data of all producer threads.
+		/// </summary>
+		/// <param name="supervised_batch">The supervised batch to append to</param>
+		/// <param name="reward_batch">The reward batch to append to</param>
+		void CopyTrainingData(LabeledTrainingBatch& supervised_batch,
+							  RewardTrainingBatch& reward_batch) const;
+
+		/// <summary>
+		/// Checks a training sample against the model layout.
+		/// </summary>
+		/// <param name="input_name">The input name of the sample</param>
+		/// <param name="input_width">The number of input values, ignored for image inputs</param>
+		/// <param name="is_path">Whether the input is given as a path</param>
+		/// <returns>True if the sample matches the layout</returns>
+		bool ValidateTrainingInput(const std::string& input_name,
+								   size_t input_width,
+								   bool is_path) const;
+
+		/// <summary>
+		/// Resolves the number of values of a model output from the layer producing it.
+		/// </summary>
+		/// <param name="output_name">The output name</param>
+		/// <param name="width">The output width, 0 if the model has no layout</param>
+		/// <returns>True if the output was found and its width resolved</returns>
+		bool ResolveOutputWidth(const std::string& output_name,
+								uint32_t& width) const;
+
+		/// <summary>
+		/// Executes a training run on a frozen snapshot of the collected samples
+		/// and promotes the trained version on success.
+		/// </summary>
+		/// <param name="job">The job tracking the run</param>
+		/// <param name="config">The training configuration</param>
+		/// <param name="clean_data">Whether to clear the training data after this training session</param>
+		/// <returns>The final state of the run</returns>
+		TrainingJobState RunTraining(TrainingJob& job,
+									 const TrainingConfig& config,
+									 bool clean_data);
+
+		/// <summary>
+		/// Writes the frozen training data, runs the trainer and loads the trained version.
+		/// </summary>
+		/// <param name="job">The job tracking the run</param>
+		/// <param name="config">The training configuration</param>
+		/// <param name="snapshot">The frozen training data</param>
+		/// <returns>The final state of the run</returns>
+		TrainingJobState ExecuteTraining(TrainingJob& job,
+										 const TrainingConfig& config,
+										 const TrainingSnapshot& snapshot);
+
 		/// <summary>
 		/// Retrieves the root directory for the model based on the output directory and model name.
 		/// </summary>
@@ -200,7 +421,10 @@ namespace TF
 
 		std::unique_ptr<cppflow::model> mpModel = nullptr;
 		std::mutex mModelMutex = {};
-		std::mutex mTrainingMutex = {};
+		mutable std::mutex mTrainingMutex = {};
+
+		std::mutex mTrainingJobMutex = {};
+		std::shared_ptr<TrainingJob> mpTrainingJob = nullptr;
 
 		std::string mScriptDirectory;
 		std::string mOutputDirectory;
@@ -212,7 +436,19 @@ namespace TF
 		std::unordered_map<std::string, std::string> mOutputIONamesMap;
 		std::vector<std::string> mOutputIONames;
 
+		// Samples handed back by unsuccessful or non-consuming training runs
 		LabeledTrainingBatch mSupervisedTrainingBatch;
 		RewardTrainingBatch mRewardTrainingBatch;
+
+		// Samples added since the last training run, one shard per producer thread
+		ShardedTrainingData mTrainingShards;
+
+		std::unique_ptr<TrainingLog> mpSupervisedTrainingLog = nullptr;
+		std::unique_ptr<TrainingLog> mpRewardTrainingLog = nullptr;
+
+		std::unique_ptr<ReplayBuffer> mpReplayBuffer = nullptr;
+
+		// Image datasets added since the last training run
+		std::vector<ImageDatasetSource> mImageDatasets;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Data/TFImageLoader.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace TF
+{
+	class MLModel;
+
+	/// <summary>
+	/// Struct representing the configuration of tiled inference.
+	/// </summary>
+	struct FORGEML_API TiledInferenceConfig
+	{
+	public:
+		// Model input receiving the batched tiles
+		std::string mInputName;
+
+		// Size of a tile in source pixels, tiles are resized to the loader's size
+		uint32_t mTileWidth = 260;
+		uint32_t mTileHeight = 260;
+
+		// Distance between neighbouring tiles, 0 for the tile size (no overlap)
+		uint32_t mStrideX = 0;
+		uint32_t mStrideY = 0;
+
+		// Maximum number of tiles per model run, 0 to run all tiles at once
+		uint32_t mMaxBatchSize = 0;
+
+		// Number of tile outputs kept for tiles with unchanged pixels, 0 disables the cache
+		uint32_t mCacheCapacity = 0;
+
+		// Layout of spatial outputs (e.g., segmentation maps) used to stitch them
+		ShapeOrder mOutputOrder = ShapeOrder::HeightWidthChannels;
+	};
+
+	/// <summary>
+	/// Struct representing a tile of an image and its model outputs.
+	/// </summary>
+	struct FORGEML_API ImageTile
+	{
+	public:
+		// Region of the tile in source pixels
+		uint32_t mX = 0;
+		uint32_t mY = 0;
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+
+		// Whether the outputs were reused from an earlier tile with the same pixels
+		bool mFromCache = false;
+
+		// Output values of the tile by output name
+		std::unordered_map<std::string, std::vector<float>> mOutputs;
+	};
+
+	/// <summary>
+	/// Struct representing a spatial output stitched over the whole image.
+	/// </summary>
+	struct FORGEML_API StitchedOutput
+	{
+	public:
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+		uint32_t mChannels = 0;
+
+		// Values in height x width x channels order, overlapping tiles are averaged
+		std::vector<float> mValues;
+	};
+
+	/// <summary>
+	/// Struct representing the results of tiled inference over an image.
+	/// </summary>
+	struct FORGEML_API TiledInferenceResult
+	{
+	public:
+		std::vector<ImageTile> mTiles;
+
+		// Shape of each output of a single tile (without the batch dimension)
+		std::unordered_map<std::string, std::vector<int64_t>> mOutputShapes;
+
+		// Outputs with spatial dimensions, stitched back together
+		std::unordered_map<std::string, StitchedOutput> mStitched;
+
+		// Number of tiles that were not run
+		uint32_t mCachedTiles = 0;
+	};
+
+	/// <summary>
+	/// Class representing sliding window inference over images larger than the model input.
+	///
+	/// The image is cut into overlapping tiles, all tiles are converted in parallel into one batched
+	/// tensor and run at once, and the per-tile outputs are stitched back together.
+	/// </summary>
+	class FORGEML_API TiledInference
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a TiledInference.
+		/// </summary>
+		/// <param name="model">The model to run, must outlive the tiler</param>
+		/// <param name="loader">The loader converting tiles to the model input</param>
+		/// <param name="config">The tiling configuration</param>
+		TiledInference(MLModel& model,
+					   const ImageTensorLoader& loader,
+					   const TiledInferenceConfig& config);
+	public:
+		/// <summary>
+		/// Runs the model over the tiles of 8-bit interleaved BGR(A) pixels in memory.
+		/// </summary>
+		/// <param name="pixels">The first pixel of the image</param>
+		/// <param name="width">The width of the image in pixels</param>
+		/// <param name="height">The height of the image in pixels</param>
+		/// <param name="channels">The number of channels per pixel (1, 3 or 4)</param>
+		/// <param name="stride">The number of bytes between rows, 0 for tightly packed rows</param>
+		/// <param name="result">The output tiles and stitched outputs</param>
+		/// <returns>True if every tile was run</returns>
+		bool Run(const uint8_t* pixels,
+				 uint32_t width,
+				 uint32_t height,
+				 uint32_t channels,
+				 size_t stride,
+				 TiledInferenceResult& result);
+
+		/// <summary>
+		/// Runs the model over the tiles of an image file.
+		/// </summary>
+		/// <param name="image_path">The file path of the image</param>
+		/// <param name="result">The output tiles and stitched outputs</param>
+		/// <returns>True if every tile was run</returns>
+		bool Run(const std::string& image_path,
+				 TiledInferenceResult& result);
+
+		/// <summary>
+		/// Computes the tile regions covering an image, the last tile of a row or column is aligned to the edge.
+		/// </summary>
+		/// <param name="width">The width of the image in pixels</param>
+		/// <param name="height">The height of the image in pixels</param>
+		/// <returns>The tiles, without outputs</returns>
+		std::vector<ImageTile> ComputeTiles(uint32_t width,
+											uint32_t height) const;
+
+		/// <summary>
+		/// Removes all cached tile outputs.
+		/// </summary>
+		void ClearCache();
+	private:
+		/// <summary>
+		/// Struct representing the cached outputs of a tile.
+		/// </summary>
+		struct CachedTile
+		{
+		public:
+			std::unordered_map<std::string, std::vector<float>> mOutputs;
+			std::unordered_map<std::string, std::vector<int64_t>> mShapes;
+		};
+
+		/// <summary>
+		/// Looks up the outputs of a tile and marks them as recently used.
+		/// </summary>
+		/// <param name="key">The tile key</param>
+		/// <param name="tile">The output cached tile</param>
+		/// <returns>True if the tile was cached</returns>
+		bool LookupTile(uint64_t key,
+						CachedTile& tile);
+
+		/// <summary>
+		/// Stores the outputs of a tile, evicting the least recently used tiles beyond the capacity.
+		/// </summary>
+		/// <param name="key">The tile key</param>
+		/// <param name="tile">The tile outputs</param>
+		void StoreTile(uint64_t key,
+					   const CachedTile& tile);
+
+		/// <summary>
+		/// Stitches the spatial outputs of all tiles over the whole image.
+		/// </summary>
+		/// <param name="width">The width of the image in pixels</param>
+		/// <param name="height">The height of the image in pixels</param>
+		/// <param name="result">The result receiving the stitched outputs</param>
+		void StitchOutputs(uint32_t width,
+						   uint32_t height,
+						   TiledInferenceResult& result) const;
+	private:
+		MLModel& mModel;
+		ImageTensorLoader mLoader;
+		TiledInferenceConfig mConfig;
+
+		// Least recently used tiles at the back
+		std::list<uint64_t> mCacheOrder;
+		std::unordered_map<uint64_t, std::pair<CachedTile, std::list<uint64_t>::iterator>> mCache;
+		uint32_t mCacheModelVersion = 0;
+		std::mutex mCacheMutex;
+	};
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Utils/ConsoleUtils.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace TF
+{
+	/// <summary>
+	/// Struct representing the metrics reported by the trainer at the end of an epoch.
+	/// </summary>
+	struct TrainingMetrics
+	{
+	public:
+		// The completed epoch, starting at 1
+		uint32_t mEpoch = 0;
+
+		// The total number of epochs requested
+		uint32_t mEpochs = 0;
+
+		// The training loss of the epoch, NaN if the loss diverged
+		float mLoss = 0.0f;
+
+		// Wall time of the epoch in seconds
+		float mEpochSeconds = 0.0f;
+
+		// Training throughput of the epoch
+		float mSamplesPerSecond = 0.0f;
+
+		// All metrics logged by Keras for the epoch (e.g., "loss", "val_loss", "accuracy"), NaN for non-finite values
+		std::unordered_map<std::string, float> mMetrics;
+	};
+
+	/// <summary>
+	/// Enum representing the state of a training job.
+	/// </summary>
+	enum class TrainingJobState
+	{
+		Running,
+		Succeeded,
+		Failed,
+		Cancelled
+	};
+
+	/// <summary>
+	/// Class representing a handle to a training run executing in the background.
+	/// </summary>
+	class FORGEML_API TrainingJob
+	{
+	public:
+		/// <summary>
+		/// Callback receiving the metrics of each completed epoch, invoked from a background thread.
+		/// </summary>
+		using MetricsCallback = std::function<void(const TrainingMetrics& metrics)>;
+	public:
+		/// <summary>
+		/// Constructor initializing a TrainingJob.
+		/// </summary>
+		/// <param name="on_metrics">The per-epoch metrics callback</param>
+		TrainingJob(MetricsCallback on_metrics = nullptr);
+	public:
+		/// <summary>
+		/// Requests the cancellation of the job, terminating the trainer process.
+		/// </summary>
+		void Cancel();
+
+		/// <summary>
+		/// Checks whether cancellation of the job has been requested.
+		/// </summary>
+		/// <returns>True if cancellation was requested</returns>
+		inline bool IsCancelRequested() const { return mCancelRequested.load(); }
+
+		/// <summary>
+		/// Retrieves the current state of the job.
+		/// </summary>
+		/// <returns>The job state</returns>
+		inline TrainingJobState GetState() const { return mState.load(); }
+
+		/// <summary>
+		/// Checks whether the job is still running.
+		/// </summary>
+		/// <returns>True if the job is running</returns>
+		inline bool IsRunning() const { return GetState() == TrainingJobState::Running; }
+
+		/// <summary>
+		/// Blocks until the job completes.
+		/// </summary>
+		/// <returns>True if the training succeeded and the new version was promoted</returns>
+		bool Wait() const;
+
+		/// <summary>
+		/// Retrieves the metrics of all epochs completed so far.
+		/// </summary>
+		/// <returns>The metrics history</returns>
+		std::vector<TrainingMetrics> GetMetricsHistory() const;
+
+		/// <summary>
+		/// Retrieves the full trainer output received so far.
+		/// </summary>
+		/// <returns>The trainer output</returns>
+		std::string GetOutput() const;
+	private:
+		friend class MLModel;
+
+		/// <summary>
+		/// Attaches the running trainer process to the job.
+		/// </summary>
+		/// <param name="process">The trainer process</param>
+		void AttachProcess(std::shared_ptr<ConsoleUtils::ProcessHandle> process);
+
+		/// <summary>
+		/// Handles a line of trainer output, extracting any reported metrics.
+		/// </summary>
+		/// <param name="line">The output line</param>
+		/// <param name="is_error">Whether the line was written to stderr</param>
+		void OnOutputLine(const std::string& line,
+						  bool is_error);
+
+		/// <summary>
+		/// Marks the job as complete.
+		/// </summary>
+		/// <param name="state">The final state</param>
+		void Complete(TrainingJobState state);
+
+		/// <summary>
+		/// Parses a metrics report line written by the trainer.
+		/// </summary>
+		/// <param name="line">The output line</param>
+		/// <param name="metrics">The parsed metrics</param>
+		/// <returns>True if the line was a metrics report</returns>
+		static bool ParseMetrics(const std::string& line,
+								 TrainingMetrics& metrics);
+	private:
+		MetricsCallback mOnMetrics;
+
+		std::atomic<bool> mCancelRequested = false;
+		std::atomic<TrainingJobState> mState = TrainingJobState::Running;
+
+		std::promise<bool> mPromise;
+		std::shared_future<bool> mFuture = mPromise.get_future().share();
+
+		mutable std::mutex mMutex = {};
+		std::shared_ptr<ConsoleUtils::ProcessHandle> mpProcess = nullptr;
+		std::vector<TrainingMetrics> mHistory;
+		std::string mOutput;
+	};
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "Core/TFModelDefines.h"
+#include "Data/TFImageLoader.h"
+#include "Utils/BoundedQueue.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace cv
+{
+	class VideoCapture;
+}
+
+namespace TF
+{
+	class MLModel;
+
+	/// <summary>
+	/// Enum representing how a pipeline handles new frames while its input queue is full.
+	/// </summary>
+	enum class FrameDropPolicy
+	{
+		// The source waits for space (backpressure), no frame is lost
+		Block,
+
+		// The oldest queued frame is dropped, keeping the latency low
+		DropOldest,
+
+		// The new frame is dropped
+		DropNewest,
+	};
+
+	/// <summary>
+	/// Struct representing the configuration of a video pipeline.
+	/// </summary>
+	struct FORGEML_API VideoPipelineConfig
+	{
+	public:
+		// Model input receiving the batched images
+		std::string mInputName;
+
+		// Maximum number of frames per model run
+		uint32_t mBatchSize = 4;
+
+		// Maximum time to wait for a batch to fill once its first frame is ready
+		uint32_t mBatchTimeout_ms = 10;
+
+		// Number of preprocessing threads, 0 for one per hardware thread
+		uint32_t mPreprocessWorkers = 0;
+
+		// Capacity of each queue between the stages
+		uint32_t mQueueCapacity = 8;
+
+		FrameDropPolicy mDropPolicy = FrameDropPolicy::DropOldest;
+	};
+
+	/// <summary>
+	/// Struct representing a frame passing through a video pipeline.
+	/// </summary>
+	struct FORGEML_API VideoFrameInfo
+	{
+	public:
+		// Position of the frame in the source, counting dropped frames
+		uint64_t mIndex = 0;
+
+		// Seconds since the pipeline started when the frame was captured
+		double mCaptureTime_s = 0.0;
+	};
+
+	/// <summary>
+	/// Struct representing the model outputs of a batch of frames.
+	/// </summary>
+	struct FORGEML_API VideoBatchResult
+	{
+	public:
+		// Frames of the batch in capture order, row i of every output belongs to frame i
+		std::vector<VideoFrameInfo> mFrames;
+
+		LabeledTensor mOutputs;
+	};
+
+	/// <summary>
+	/// Struct representing the throughput and latency of a pipeline stage.
+	/// </summary>
+	struct FORGEML_API VideoStageStats
+	{
+	public:
+		// Frames completed by the stage
+		uint64_t mFrames = 0;
+
+		// Frames completed per second since the pipeline started
+		double mThroughput = 0.0;
+
+		// Time from the completion of the previous stage, including queueing
+		double mAverageLatency_ms = 0.0;
+		double mMaxLatency_ms = 0.0;
+	};
+
+	/// <summary>
+	/// Struct representing the statistics of a video pipeline.
+	/// </summary>
+	struct FORGEML_API VideoPipelineStats
+	{
+	public:
+		VideoStageStats mSource;
+		VideoStageStats mPreprocess;
+		VideoStageStats mInference;
+		VideoStageStats mPostprocess;
+
+		// From capture to the completion of the postprocessing
+		VideoStageStats mEndToEnd;
+
+		// Frames dropped under overload
+		uint64_t mDroppedFrames = 0;
+
+		// Frames that failed to preprocess or to run
+		uint64_t mFailedFrames = 0;
+	};
+
+	/// <summary>
+	/// Class representing a streaming inference pipeline over video frames.
+	///
+	/// Frames from a video file or pushed from memory are preprocessed in parallel, run through the
+	/// model in batches and handed to a postprocessing callback. The stages run on their own threads,
+	/// connected by bounded queues.
+	/// </summary>
+	class FORGEML_API VideoPipeline
+	{
+	public:
+		/// <summary>
+		/// Callback receiving the outputs of every batch, invoked in order from the postprocessing thread.
+		/// </summary>
+		using ResultCallback = std::function<void(const VideoBatchResult& result)>;
+	public:
+		/// <summary>
+		/// Constructor initializing a VideoPipeline.
+		/// </summary>
+		/// <param name="model">The model to run, must outlive the pipeline</param>
+		/// <param name="loader">The loader converting frames to the model input</param>
+		/// <param name="config">The pipeline configuration</param>
+		/// <param name="on_result">The postprocessing callback</param>
+		VideoPipeline(MLModel& model,
+					  const ImageTensorLoader& loader,
+					  const VideoPipelineConfig& config,
+					  ResultCallback on_result);
+
+		/// <summary>
+		/// Destructor stopping the pipeline.
+		/// </summary>
+		~VideoPipeline();
+
+		VideoPipeline(const VideoPipeline&) = delete;
+		VideoPipeline& operator=(const VideoPipeline&) = delete;
+	public:
+		/// <summary>
+		/// Starts the pipeline reading frames from a video file (cv::VideoCapture).
+		/// </summary>
+		/// <param name="video_path">The path of the video file</param>
+		/// <returns>True if the video was opened and the pipeline started</returns>
+		bool StartVideo(const std::string& video_path);
+
+		/// <summary>
+		/// Starts the pipeline for frames pushed from memory with PushFrame.
+		/// </summary>
+		/// <returns>True if the pipeline started</returns>
+		bool Start();
+
+		/// <summary>
+		/// Pushes a frame of 8-bit interleaved BGR(A) pixels, the pixels are copied.
+		/// </summary>
+		/// <param name="pixels">The first pixel of the frame</param>
+		/// <param name="width">The width of the frame in pixels</param>
+		/// <param name="height">The height of the frame in pixels</param>
+		/// <param name="channels">The number of channels per pixel (1, 3 or 4)</param>
+		/// <param name="stride">The number of bytes between rows, 0 for tightly packed rows</param>
+		/// <returns>True if the frame was queued, false if it was dropped or the pipeline does not accept frames</returns>
+		bool PushFrame(const uint8_t* pixels,
+					   uint32_t width,
+					   uint32_t height,
+					   uint32_t channels,
+					   size_t stride = 0);
+
+		/// <summary>
+		/// Waits for the source to end, e.g., the end of the video, and for every queued frame to complete.
+		/// Pushed frames end with this call.
+		/// </summary>
+		void Finish();
+
+		/// <summary>
+		/// Stops the pipeline, discarding the frames still queued.
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Checks whether the pipeline is running.
+		/// </summary>
+		/// <returns>True if running</returns>
+		inline bool IsRunning() const { return mIsRunning.load(); }
+
+		/// <summary>
+		/// Retrieves the throughput and latency of every stage.
+		/// </summary>
+		/// <returns>The statistics</returns>
+		VideoPipelineStats GetStats() const;
+	private:
+		struct RawFrame;
+		struct PreparedFrame;
+		struct InferredBatch;
+
+		/// <summary>
+		/// Struct representing the lock-free counters of a stage.
+		/// </summary>
+		struct StageCounters
+		{
+		public:
+			/// <summary>
+			/// Records a completed frame.
+			/// </summary>
+			/// <param name="latency_s">The latency of the frame in seconds</param>
+			void Add(double latency_s);
+
+			/// <summary>
+			/// Converts the counters to stage statistics.
+			/// </summary>
+			/// <param name="elapsed_s">The seconds since the pipeline started</param>
+			/// <returns>The statistics</returns>
+			VideoStageStats ToStats(double elapsed_s) const;
+		public:
+			std::atomic<uint64_t> mFrames = 0;
+			std::atomic<uint64_t> mTotalLatency_us = 0;
+			std::atomic<uint64_t> mMaxLatency_us = 0;
+		};
+	private:
+		/// <summary>
+		/// Creates the queues and starts the processing threads.
+		/// </summary>
+		void StartStages();
+
+		/// <summary>
+		/// Retrieves the seconds since the pipeline started.
+		/// </summary>
+		/// <returns>The elapsed seconds</returns>
+		double GetElapsed() const;
+
+		/// <summary>
+		/// Queues a captured frame, applying the drop policy while the queue is full.
+		/// </summary>
+		/// <param name="frame">The frame</param>
+		/// <returns>True if the frame was queued</returns>
+		bool Enqueue(std::unique_ptr<RawFrame>& frame);
+
+		/// <summary>
+		/// Closes the stages one after another, each draining its queue, and joins their threads.
+		/// </summary>
+		void JoinStages();
+
+		void SourceLoop(std::unique_ptr<cv::VideoCapture> capture);
+		void PreprocessLoop();
+		void InferenceLoop();
+		void PostprocessLoop();
+	private:
+		MLModel& mModel;
+		ImageTensorLoader mLoader;
+		VideoPipelineConfig mConfig;
+		ResultCallback mOnResult;
+
+		std::unique_ptr<BoundedQueue<std::unique_ptr<RawFrame>>> mpRawFrames;
+		std::unique_ptr<BoundedQueue<std::unique_ptr<PreparedFrame>>> mpPreparedFrames;
+		std::unique_ptr<BoundedQueue<std::unique_ptr<InferredBatch>>> mpResults;
+
+		std::thread mSourceThread;
+		std::vector<std::thread> mPreprocessThreads;
+		std::thread mInferenceThread;
+		std::thread mPostprocessThread;
+
+		std::atomic<bool> mIsRunning = false;
+		std::atomic<bool> mAcceptsFrames = false;
+		std::atomic<bool> mIsStopping = false;
+		std::atomic<uint64_t> mNextFrameIndex = 0;
+
+		std::chrono::steady_clock::time_point mStartTime;
+		std::atomic<double> mFinishedElapsed_s = 0.0;
+
+		StageCounters mSourceCounters;
+		StageCounters mPreprocessCounters;
+		StageCounters mInferenceCounters;
+		StageCounters mPostprocessCounters;
+		StageCounters mEndToEndCounters;
+
+		std::atomic<uint64_t> mDroppedFrames = 0;
+		std::atomic<uint64_t> mFailedFrames = 0;
+	};
+}
@@ -9,5 +9,8 @@
 
 #include "Data/TFImageLoader.h"
 #include "Data/FlatFloatDataBuilder.h"
+#include "Data/ImageFolderDataset.h"
 
-#include "Models/MLModel.h"
\ No newline at end of file
+#include "Models/MLModel.h"
+#include "Models/VideoPipeline.h"
+#include "Models/TiledInference.h"
\ No newline at end of file
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a bounded multi-producer, multi-consumer queue.
+	///
+	/// TryPush and TryPop are lock-free (a ring of sequenced cells, after Dmitry Vyukov's bounded MPMC queue),
+	/// the blocking Push and Pop back off until space or an item is available, or the queue is closed.
+	/// </summary>
+	template<typename T>
+	class BoundedQueue
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a BoundedQueue.
+		/// </summary>
+		/// <param name="capacity">The maximum number of queued items, rounded up to a power of two</param>
+		BoundedQueue(size_t capacity)
+		{
+			size_t rounded = 2;
+			while (rounded < capacity)
+				rounded <<= 1;
+
+			mMask = rounded - 1;
+			mCells = std::vector<Cell>(rounded);
+			for (size_t i = 0; i < rounded; ++i)
+				mCells[i].mSequence.store(i, std::memory_order_relaxed);
+		}
+
+		BoundedQueue(const BoundedQueue&) = delete;
+		BoundedQueue& operator=(const BoundedQueue&) = delete;
+	public:
+		/// <summary>
+		/// Retrieves the maximum number of queued items.
+		/// </summary>
+		/// <returns>The capacity</returns>
+		inline size_t GetCapacity() const { return mMask + 1; }
+
+		/// <summary>
+		/// Retrieves the number of queued items, only exact while no other thread uses the queue.
+		/// </summary>
+		/// <returns>The approximate number of queued items</returns>
+		inline size_t GetSizeApprox() const
+		{
+			const size_t tail = mTail.load(std::memory_order_relaxed);
+			const size_t head = mHead.load(std::memory_order_relaxed);
+			return tail >= head ? tail - head : 0;
+		}
+
+		/// <summary>
+		/// Checks whether the queue was closed.
+		/// </summary>
+		/// <returns>True if closed</returns>
+		inline bool IsClosed() const { return mClosed.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Closes the queue, waking blocked producers and letting consumers drain the remaining items.
+		/// </summary>
+		inline void Close() { mClosed.store(true, std::memory_order_release); }
+	public:
+		/// <summary>
+		/// Queues an item if there is space, the item is only moved from on success.
+		/// </summary>
+		/// <param name="item">The item</param>
+		/// <returns>True if the item was queued</returns>
+		bool TryPush(T& item)
+		{
+			size_t position = mTail.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Cell& cell = mCells[position & mMask];
+				const size_t sequence = cell.mSequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if (difference == 0)
+				{
+					if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						cell.mData = std::move(item);
+						cell.mSequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					// The cell still holds an item of the previous lap
+					return false;
+				}
+				else
+				{
+					position = mTail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Dequeues an item if one is available.
+		/// </summary>
+		/// <param name="item">The output item</param>
+		/// <returns>True if an item was dequeued</returns>
+		bool TryPop(T& item)
+		{
+			size_t position = mHead.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Cell& cell = mCells[position & mMask];
+				const size_t sequence = cell.mSequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+				if (difference == 0)
+				{
+					if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						item = std::move(cell.mData);
+						cell.mSequence.store(position + mMask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					// The cell was not written yet
+					return false;
+				}
+				else
+				{
+					position = mHead.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Queues an item, waiting while the queue is full (backpressure).
+		/// </summary>
+		/// <param name="item">The item</param>
+		/// <returns>True if the item was queued, false if the queue was closed</returns>
+		bool Push(T& item)
+		{
+			for (uint32_t attempt = 0; !IsClosed(); ++attempt)
+			{
+				if (TryPush(item))
+					return true;
+
+				Backoff(attempt);
+			}
+			return false;
+		}
+
+		/// <summary>
+		/// Dequeues an item, waiting while the queue is empty.
+		/// </summary>
+		/// <param name="item">The output item</param>
+		/// <returns>True if an item was dequeued, false once the queue is closed and drained</returns>
+		bool Pop(T& item)
+		{
+			return PopFor(item, std::chrono::microseconds::max());
+		}
+
+		/// <summary>
+		/// Dequeues an item, waiting up to the timeout while the queue is empty.
+		/// </summary>
+		/// <param name="item">The output item</param>
+		/// <param name="timeout">The maximum time to wait</param>
+		/// <returns>True if an item was dequeued, false on timeout or once the queue is closed and drained</returns>
+		bool PopFor(T& item,
+					std::chrono::microseconds timeout)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (uint32_t attempt = 0; ; ++attempt)
+			{
+				if (TryPop(item))
+					return true;
+
+				// Items pushed before the close are still handed out
+				if (IsClosed())
+					return TryPop(item);
+
+				if (timeout != std::chrono::microseconds::max() && std::chrono::steady_clock::now() - start >= timeout)
+					return false;
+
+				Backoff(attempt);
+			}
+		}
+	private:
+		/// <summary>
+		/// Waits between attempts, spinning briefly before yielding and finally sleeping.
+		/// </summary>
+		/// <param name="attempt">The number of failed attempts so far</param>
+		static void Backoff(uint32_t attempt)
+		{
+			if (attempt < 16)
+				return;
+
+			if (attempt < 64)
+				std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> mSequence = 0;
+			T mData = {};
+		};
+
+		std::vector<Cell> mCells;
+		size_t mMask = 0;
+
+		// Separate cache lines, producers and consumers do not contend on the same line
+		alignas(64) std::atomic<size_t> mTail = 0;
+		alignas(64) std::atomic<size_t> mHead = 0;
+		alignas(64) std::atomic<bool> mClosed = false;
+	};
+}
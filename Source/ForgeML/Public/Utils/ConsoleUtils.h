@@ -1,9 +1,74 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
 
 struct FORGEML_API ConsoleUtils
 {
+public:
+	/// <summary>
+	/// Callback receiving each line of a process output as it arrives.
+	/// The flag is true for lines written to stderr.
+	/// </summary>
+	using LineCallback = std::function<void(const std::string& line, bool is_error)>;
+
+	/// <summary>
+	/// Struct representing the final state of a process.
+	/// </summary>
+	struct ProcessResult
+	{
+		// The exit code of the process, -1 if it did not exit normally
+		int mExitCode = -1;
+
+		// Whether the process was terminated for exceeding its timeout
+		bool mTimedOut = false;
+
+		// Whether the process was terminated by a cancellation request
+		bool mCancelled = false;
+	};
+
+	/// <summary>
+	/// Class representing a handle to an asynchronously running process.
+	/// </summary>
+	class FORGEML_API ProcessHandle
+	{
+	public:
+		/// <summary>
+		/// Requests the termination of the process.
+		/// </summary>
+		void Cancel();
+
+		/// <summary>
+		/// Checks whether the process is still running.
+		/// </summary>
+		/// <returns>True if the process is running</returns>
+		bool IsRunning() const;
+
+		/// <summary>
+		/// Retrieves the future resolved once the process exits.
+		/// </summary>
+		/// <returns>The result future</returns>
+		inline std::shared_future<ProcessResult> GetFuture() const { return mFuture; }
+
+		/// <summary>
+		/// Blocks until the process exits.
+		/// </summary>
+		/// <returns>The process result</returns>
+		ProcessResult Wait() const;
+	private:
+		friend struct ConsoleUtils;
+
+		std::atomic<bool> mCancelRequested = false;
+		std::atomic<bool> mRunning = true;
+
+		std::promise<ProcessResult> mPromise;
+		std::shared_future<ProcessResult> mFuture = mPromise.get_future().share();
+	};
 public:
 	/// <summary>
 	/// Executes a console command and optionally captures the output.
@@ -13,4 +78,39 @@ public:
 	/// <returns>The exit code</returns>
 	static int Execute(const char* cmd,
 					   std::string* output = nullptr);
-};
\ No newline at end of file
+
+	/// <summary>
+	/// Executes a program without a shell, blocks until it exits and optionally captures the output.
+	/// </summary>
+	/// <param name="args">The program followed by its arguments</param>
+	/// <param name="output">The captured output or nullptr if no output is to be captured</param>
+	/// <returns>The exit code</returns>
+	static int Execute(const std::vector<std::string>& args,
+					   std::string* output = nullptr);
+
+	/// <summary>
+	/// Starts a program without a shell and returns immediately.
+	///
+	/// Stdout and stderr are streamed line by line to the callback from a background thread.
+	/// </summary>
+	/// <param name="args">The program followed by its arguments</param>
+	/// <param name="on_line">The output line callback or nullptr to discard the output</param>
+	/// <param name="timeout">The time after which the process is terminated, zero for no timeout</param>
+	/// <returns>The process handle</returns>
+	static std::shared_ptr<ProcessHandle> ExecuteAsync(const std::vector<std::string>& args,
+													   LineCallback on_line = nullptr,
+													   std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+private:
+	/// <summary>
+	/// Spawns a process and the thread monitoring it.
+	/// </summary>
+	/// <param name="args">The program followed by its arguments, or a single raw command line</param>
+	/// <param name="is_command_line">Whether args holds a single raw command line</param>
+	/// <param name="on_line">The output line callback</param>
+	/// <param name="timeout">The time after which the process is terminated, zero for no timeout</param>
+	/// <returns>The process handle</returns>
+	static std::shared_ptr<ProcessHandle> Spawn(const std::vector<std::string>& args,
+												bool is_command_line,
+												LineCallback on_line,
+												std::chrono::milliseconds timeout);
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a size bounded, content keyed cache of files or directories on disk.
+	///
+	/// Entries are evicted in least recently used order once the total size exceeds the limit.
+	/// </summary>
+	class FORGEML_API DiskCache
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a DiskCache.
+		/// </summary>
+		/// <param name="root">The root directory of the cache</param>
+		/// <param name="max_bytes">The maximum size of the cache in bytes</param>
+		DiskCache(const std::filesystem::path& root,
+				  uint64_t max_bytes);
+	public:
+		/// <summary>
+		/// Retrieves the root directory of the cache.
+		/// </summary>
+		/// <returns>The root directory</returns>
+		inline const std::filesystem::path& GetRoot() const { return mRoot; }
+
+		/// <summary>
+		/// Retrieves the maximum size of the cache.
+		/// </summary>
+		/// <returns>The maximum size in bytes</returns>
+		inline uint64_t GetSizeLimit() const { return mMaxBytes; }
+
+		/// <summary>
+		/// Sets the maximum size of the cache, evicting entries if necessary.
+		/// </summary>
+		/// <param name="max_bytes">The maximum size in bytes</param>
+		void SetSizeLimit(uint64_t max_bytes);
+
+		/// <summary>
+		/// Looks up an entry and marks it as recently used.
+		/// </summary>
+		/// <param name="key">The entry key</param>
+		/// <param name="entry">The path of the found entry</param>
+		/// <returns>True if the entry exists</returns>
+		bool Lookup(const std::string& key,
+					std::filesystem::path& entry);
+
+		/// <summary>
+		/// Copies a file or directory into the cache under the given key, replacing any previous entry.
+		/// </summary>
+		/// <param name="key">The entry key</param>
+		/// <param name="source">The file or directory to copy</param>
+		/// <returns>True if the entry was inserted</returns>
+		bool Insert(const std::string& key,
+					const std::filesystem::path& source);
+
+		/// <summary>
+		/// Writes a block of memory as a file entry under the given key, replacing any previous entry.
+		/// </summary>
+		/// <param name="key">The entry key</param>
+		/// <param name="data">The data to write</param>
+		/// <param name="size">The size of the data in bytes</param>
+		/// <returns>True if the entry was written</returns>
+		bool Write(const std::string& key,
+				   const void* data,
+				   size_t size);
+
+		/// <summary>
+		/// Removes an entry from the cache.
+		/// </summary>
+		/// <param name="key">The entry key</param>
+		void Remove(const std::string& key);
+
+		/// <summary>
+		/// Evicts the least recently used entries until the cache fits within its size limit.
+		/// 
+		/// The cache directory is only scanned while the size tracked since the last scan exceeds the limit.
+		/// </summary>
+		/// <param name="keep">An entry key that must not be evicted</param>
+		void Trim(const std::string& keep = "");
+	private:
+		/// <summary>
+		/// Retrieves the path of an entry within the cache.
+		/// </summary>
+		/// <param name="key">The entry key</param>
+		/// <returns>The entry path</returns>
+		std::filesystem::path GetEntryPath(const std::string& key) const;
+
+		/// <summary>
+		/// Moves a fully written partial entry into place and accounts for its size.
+		/// Expects the mutex to be held.
+		/// </summary>
+		/// <param name="partial">The partial entry path</param>
+		/// <param name="path">The final entry path</param>
+		/// <returns>True if the entry was committed</returns>
+		bool CommitEntry(const std::filesystem::path& partial,
+						 const std::filesystem::path& path);
+
+		/// <summary>
+		/// Marks an entry as recently used, directories through a marker file next to them.
+		/// </summary>
+		/// <param name="entry">The entry path</param>
+		static void Touch(const std::filesystem::path& entry);
+
+		/// <summary>
+		/// Retrieves the last time an entry was used.
+		/// </summary>
+		/// <param name="entry">The entry path</param>
+		/// <returns>The last use time</returns>
+		static std::filesystem::file_time_type GetLastUse(const std::filesystem::path& entry);
+
+		/// <summary>
+		/// Computes the size of an entry on disk.
+		/// </summary>
+		/// <param name="entry">The entry path</param>
+		/// <returns>The size in bytes</returns>
+		static uint64_t GetEntrySize(const std::filesystem::path& entry);
+	private:
+		std::filesystem::path mRoot;
+		uint64_t mMaxBytes = 0;
+
+		// Total size as of the last scan plus later changes, only valid once scanned
+		uint64_t mTrackedBytes = 0;
+		bool mIsTracked = false;
+
+		std::mutex mMutex = {};
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+struct FORGEML_API HashUtils
+{
+public:
+	// FNV-1a 64-bit offset basis, used as the default seed
+	static constexpr uint64_t DefaultSeed = 14695981039346656037ull;
+public:
+	/// <summary>
+	/// Hashes a block of memory. Hashes can be chained by passing a previous hash as the seed.
+	/// </summary>
+	/// <param name="data">The data to hash</param>
+	/// <param name="size">The size of the data in bytes</param>
+	/// <param name="seed">The seed or previous hash to continue from</param>
+	/// <returns>The 64-bit hash</returns>
+	static uint64_t Hash(const void* data,
+						 size_t size,
+						 uint64_t seed = DefaultSeed);
+
+	/// <summary>
+	/// Hashes a string.
+	/// </summary>
+	/// <param name="str">The string to hash</param>
+	/// <param name="seed">The seed or previous hash to continue from</param>
+	/// <returns>The 64-bit hash</returns>
+	static uint64_t HashString(const std::string& str,
+							   uint64_t seed = DefaultSeed);
+
+	/// <summary>
+	/// Hashes the content of a file.
+	/// </summary>
+	/// <param name="filepath">The file path</param>
+	/// <param name="seed">The seed or previous hash to continue from</param>
+	/// <returns>The 64-bit hash</returns>
+	static uint64_t HashFile(const std::filesystem::path& filepath,
+							 uint64_t seed = DefaultSeed);
+
+	/// <summary>
+	/// Converts a hash to a fixed width hexadecimal string.
+	/// </summary>
+	/// <param name="hash">The hash</param>
+	/// <returns>The hexadecimal string</returns>
+	static std::string ToHex(uint64_t hash);
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a named shared memory segment owned by this process.
+	///
+	/// Other processes attach by name (e.g., Python's multiprocessing.shared_memory.SharedMemory),
+	/// the segment is unmapped and removed once the owner is destroyed.
+	/// </summary>
+	class FORGEML_API SharedMemory
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing an empty SharedMemory.
+		/// </summary>
+		SharedMemory() = default;
+
+		/// <summary>
+		/// Destructor releasing the segment.
+		/// </summary>
+		~SharedMemory();
+
+		SharedMemory(const SharedMemory&) = delete;
+		SharedMemory& operator=(const SharedMemory&) = delete;
+	public:
+		/// <summary>
+		/// Checks whether a segment is mapped.
+		/// </summary>
+		/// <returns>True if a segment is mapped</returns>
+		inline bool IsValid() const { return mpData != nullptr; }
+
+		/// <summary>
+		/// Retrieves the segment name, without the leading slash of POSIX names.
+		/// </summary>
+		/// <returns>The segment name</returns>
+		inline const std::string& GetName() const { return mName; }
+
+		/// <summary>
+		/// Retrieves the mapped segment.
+		/// </summary>
+		/// <returns>The pointer to the segment data</returns>
+		inline uint8_t* GetData() const { return static_cast<uint8_t*>(mpData); }
+
+		/// <summary>
+		/// Retrieves the size of the segment.
+		/// </summary>
+		/// <returns>The size in bytes</returns>
+		inline size_t GetSize() const { return mBytes; }
+	public:
+		/// <summary>
+		/// Creates and maps a new segment with a unique name, releasing any previous one.
+		/// </summary>
+		/// <param name="bytes">The size of the segment in bytes</param>
+		/// <returns>True if the segment was created and its memory reserved</returns>
+		bool Create(size_t bytes);
+
+		/// <summary>
+		/// Unmaps and removes the segment.
+		/// </summary>
+		void Release();
+	private:
+		std::string mName;
+
+		void* mpData = nullptr;
+		size_t mBytes = 0;
+
+		// File mapping handle (Windows only)
+		void* mpHandle = nullptr;
+	};
+}
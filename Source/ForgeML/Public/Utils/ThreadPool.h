@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace TF
+{
+	/// <summary>
+	/// Class representing a fixed set of worker threads executing queued tasks.
+	/// </summary>
+	class FORGEML_API ThreadPool
+	{
+	public:
+		/// <summary>
+		/// Constructor initializing a ThreadPool.
+		/// </summary>
+		/// <param name="thread_count">The number of worker threads, 0 for one per hardware thread</param>
+		ThreadPool(uint32_t thread_count = 0);
+
+		/// <summary>
+		/// Destructor finishing the queued tasks and joining the worker threads.
+		/// </summary>
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+	public:
+		/// <summary>
+		/// Retrieves the pool shared by the library, sized to the hardware threads.
+		/// </summary>
+		/// <returns>The shared pool</returns>
+		static ThreadPool& GetShared();
+	public:
+		/// <summary>
+		/// Retrieves the number of worker threads.
+		/// </summary>
+		/// <returns>The number of worker threads</returns>
+		inline uint32_t GetThreadCount() const { return static_cast<uint32_t>(mWorkers.size()); }
+
+		/// <summary>
+		/// Queues a task to run on a worker thread.
+		/// </summary>
+		/// <param name="task">The task</param>
+		void Submit(std::function<void()> task);
+
+		/// <summary>
+		/// Runs a function for every index in [0, count) across the workers and the calling thread,
+		/// returning once all indices are done. Safe to call from within a task of the same pool.
+		///
+		/// The first exception thrown by the function is rethrown on the calling thread.
+		/// </summary>
+		/// <param name="count">The number of indices</param>
+		/// <param name="func">The function receiving the index</param>
+		void ParallelFor(size_t count,
+						 const std::function<void(size_t)>& func);
+	private:
+		/// <summary>
+		/// Runs queued tasks until the pool is destroyed.
+		/// </summary>
+		void WorkerLoop();
+	private:
+		std::vector<std::thread> mWorkers;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::deque<std::function<void()>> mTasks;
+		bool mStopping = false;
+	};
+}